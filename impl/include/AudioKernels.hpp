@@ -0,0 +1,251 @@
+#ifndef AUDIO_KERNELS_HPP
+#define AUDIO_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#define ONNX_STT_AUDIO_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ONNX_STT_AUDIO_NEON 1
+#endif
+
+namespace onnx_stt {
+
+/**
+ * Sample conversion kernels for the ingest path
+ *
+ * SSE2 on x86-64 and NEON on ARM, selected at compile time; other targets
+ * use the scalar loops, which also handle the tails. Input and output
+ * pointers need no particular alignment and must not overlap.
+ */
+namespace audio_kernels {
+
+/** out[i] = in[i] * scale (use 1/32768 to normalize to [-1, 1)) */
+inline void int16ToFloat(const int16_t* in, float* out, size_t count, float scale) {
+    size_t i = 0;
+#if defined(ONNX_STT_AUDIO_SSE2)
+    const __m128 vscale = _mm_set1_ps(scale);
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend by placing each int16 in the high half, then shifting down
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vscale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vscale));
+    }
+#elif defined(ONNX_STT_AUDIO_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t x = vld1q_s16(in + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+        vst1q_f32(out + i, vmulq_n_f32(lo, scale));
+        vst1q_f32(out + i + 4, vmulq_n_f32(hi, scale));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * scale;
+    }
+}
+
+/**
+ * Split interleaved stereo int16 (L,R,L,R,...) into two float channels
+ * @param frames Number of L/R pairs; each output receives @p frames samples
+ */
+inline void deinterleaveStereoInt16(const int16_t* in, float* left, float* right,
+                                    size_t frames, float scale) {
+    size_t i = 0;
+#if defined(ONNX_STT_AUDIO_SSE2)
+    const __m128 vscale = _mm_set1_ps(scale);
+    for (; i + 4 <= frames; i += 4) {
+        // Four frames as four int32: left is the low half, right the high half
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        __m128i l = _mm_srai_epi32(_mm_slli_epi32(x, 16), 16);
+        __m128i r = _mm_srai_epi32(x, 16);
+        _mm_storeu_ps(left + i, _mm_mul_ps(_mm_cvtepi32_ps(l), vscale));
+        _mm_storeu_ps(right + i, _mm_mul_ps(_mm_cvtepi32_ps(r), vscale));
+    }
+#elif defined(ONNX_STT_AUDIO_NEON)
+    for (; i + 8 <= frames; i += 8) {
+        int16x8x2_t x = vld2q_s16(in + 2 * i);
+        vst1q_f32(left + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x.val[0]))), scale));
+        vst1q_f32(left + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x.val[0]))), scale));
+        vst1q_f32(right + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x.val[1]))), scale));
+        vst1q_f32(right + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x.val[1]))), scale));
+    }
+#endif
+    for (; i < frames; ++i) {
+        left[i] = static_cast<float>(in[2 * i]) * scale;
+        right[i] = static_cast<float>(in[2 * i + 1]) * scale;
+    }
+}
+
+/**
+ * Split interleaved int16 with @p channels channels into planar floats
+ * @param out One pointer per channel, each with room for @p frames samples
+ *
+ * Two, four and eight channels are transposed in registers; other counts
+ * take the scalar loop.
+ */
+inline void deinterleaveInt16(const int16_t* in, size_t channels, float* const* out,
+                              size_t frames, float scale) {
+    if (channels == 2) {
+        deinterleaveStereoInt16(in, out[0], out[1], frames, scale);
+        return;
+    }
+    size_t i = 0;
+#if defined(ONNX_STT_AUDIO_SSE2)
+    const __m128 vscale = _mm_set1_ps(scale);
+    if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            // Rows are frames, columns channels; transpose to channel rows
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * i + 8));
+            __m128 r0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16));
+            __m128 r1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16));
+            __m128 r2 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(b, b), 16));
+            __m128 r3 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(b, b), 16));
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(out[0] + i, _mm_mul_ps(r0, vscale));
+            _mm_storeu_ps(out[1] + i, _mm_mul_ps(r1, vscale));
+            _mm_storeu_ps(out[2] + i, _mm_mul_ps(r2, vscale));
+            _mm_storeu_ps(out[3] + i, _mm_mul_ps(r3, vscale));
+        }
+    } else if (channels == 8) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 lo[4];
+            __m128 hi[4];
+            for (int f = 0; f < 4; ++f) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8 * (i + f)));
+                lo[f] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+                hi[f] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+            }
+            _MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+            _MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+            for (int c = 0; c < 4; ++c) {
+                _mm_storeu_ps(out[c] + i, _mm_mul_ps(lo[c], vscale));
+                _mm_storeu_ps(out[c + 4] + i, _mm_mul_ps(hi[c], vscale));
+            }
+        }
+    }
+#elif defined(ONNX_STT_AUDIO_NEON)
+    if (channels == 4) {
+        for (; i + 8 <= frames; i += 8) {
+            int16x8x4_t x = vld4q_s16(in + 4 * i);
+            for (int c = 0; c < 4; ++c) {
+                vst1q_f32(out[c] + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x.val[c]))), scale));
+                vst1q_f32(out[c] + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x.val[c]))), scale));
+            }
+        }
+    }
+#endif
+    for (; i < frames; ++i) {
+        const int16_t* frame = in + i * channels;
+        for (size_t c = 0; c < channels; ++c) {
+            out[c][i] = static_cast<float>(frame[c]) * scale;
+        }
+    }
+}
+
+/** Split interleaved bytes with @p channels channels through a 256-entry decode table */
+inline void deinterleaveTable(const uint8_t* in, size_t channels, const float* table,
+                              float* const* out, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        const uint8_t* frame = in + i * channels;
+        for (size_t c = 0; c < channels; ++c) {
+            out[c][i] = table[frame[c]];
+        }
+    }
+}
+
+/** Dot product of two float arrays (FIR inner loop) */
+inline float dot(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(ONNX_STT_AUDIO_SSE2)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(ONNX_STT_AUDIO_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/** Number of sign changes between consecutive samples (zero counts as positive) */
+inline size_t zeroCrossings(const float* x, size_t count) {
+    if (count < 2) {
+        return 0;
+    }
+    const size_t pairs = count - 1;
+    size_t i = 0;
+    size_t crossings = 0;
+#if defined(ONNX_STT_AUDIO_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 4 <= pairs; i += 4) {
+        __m128 a = _mm_cmpge_ps(_mm_loadu_ps(x + i), zero);
+        __m128 b = _mm_cmpge_ps(_mm_loadu_ps(x + i + 1), zero);
+        // Differing signs give an all-ones lane (-1); subtracting counts it
+        acc = _mm_sub_epi32(acc, _mm_castps_si128(_mm_xor_ps(a, b)));
+    }
+    int32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    crossings = static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#elif defined(ONNX_STT_AUDIO_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 4 <= pairs; i += 4) {
+        uint32x4_t a = vcgeq_f32(vld1q_f32(x + i), zero);
+        uint32x4_t b = vcgeq_f32(vld1q_f32(x + i + 1), zero);
+        acc = vaddq_u32(acc, vshrq_n_u32(veorq_u32(a, b), 31));
+    }
+    uint32x2_t half = vadd_u32(vget_low_u32(acc), vget_high_u32(acc));
+    crossings = vget_lane_u32(vpadd_u32(half, half), 0);
+#endif
+    for (; i < pairs; ++i) {
+        crossings += (x[i] >= 0.0f) != (x[i + 1] >= 0.0f);
+    }
+    return crossings;
+}
+
+/** Split interleaved stereo bytes through a 256-entry decode table */
+inline void deinterleaveStereoTable(const uint8_t* in, const float* table,
+                                    float* left, float* right, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        left[i] = table[in[2 * i]];
+        right[i] = table[in[2 * i + 1]];
+    }
+}
+
+/** Decode bytes through a 256-entry table */
+inline void decodeTable(const uint8_t* in, const float* table, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = table[in[i]];
+    }
+}
+
+} // namespace audio_kernels
+} // namespace onnx_stt
+
+#endif // AUDIO_KERNELS_HPP
@@ -0,0 +1,148 @@
+#ifndef BATCHED_SILERO_VAD_HPP
+#define BATCHED_SILERO_VAD_HPP
+
+#include "VADInterface.hpp"
+#include "onnx_wrapper.hpp"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * Silero VAD scheduler for many concurrent streams sharing one model
+ *
+ * SileroVAD runs one batch-1 inference per window and stream, which at
+ * hundreds of calls turns into tens of thousands of tiny Run() calls per
+ * second. Here streams only queue audio; runPending() gathers the next
+ * window of every stream that has one into a [batch, window] tensor,
+ * stacks the per-stream LSTM h/c rows into [2, batch, 64], runs a single
+ * inference and scatters probabilities and updated states back.
+ *
+ * A stream contributes at most one window per batch because its next
+ * window depends on the state produced by the current one; runPending()
+ * repeats batches until no stream has a complete window left.
+ *
+ * Thread-safe: producers may push audio and read results while another
+ * thread runs batches. Windowing (window_size_ms, frame_shift_ms) matches
+ * SileroVAD so both produce the same results per stream.
+ */
+class BatchedSileroVAD {
+public:
+    using StreamId = uint64_t;
+    using VADResult = VADInterface::VADResult;
+
+    struct Config {
+        VADInterface::Config vad;
+        std::string model_path = "../models/silero_vad.onnx";
+        size_t max_batch_size = 256;   // streams per Run() call
+        int num_threads = 1;           // ORT intra-op threads
+    };
+
+    struct Stats {
+        uint64_t batches = 0;          // Run() calls
+        uint64_t windows = 0;          // windows classified
+        size_t max_batch = 0;          // largest batch seen
+        size_t active_streams = 0;
+
+        double averageBatch() const {
+            return batches > 0 ? static_cast<double>(windows) / batches : 0.0;
+        }
+    };
+
+    BatchedSileroVAD();
+    explicit BatchedSileroVAD(const Config& config);
+    ~BatchedSileroVAD();
+
+    /** Load the model; without it every window is reported as speech */
+    bool initialize();
+    bool isInitialized() const { return session_ != nullptr; }
+
+    StreamId addStream();
+    void removeStream(StreamId id);
+
+    /** Clear the stream's buffered audio, LSTM state and pending results */
+    void resetStream(StreamId id);
+
+    /** Queue audio for a stream; timestamp_ms is the time of samples[0] */
+    void pushAudio(StreamId id, const float* samples, size_t num_samples, uint64_t timestamp_ms);
+    void pushAudio(StreamId id, const int16_t* samples, size_t num_samples, uint64_t timestamp_ms);
+
+    /**
+     * Classify every complete window of every stream in batches
+     * @return Number of windows classified
+     */
+    size_t runPending();
+
+    /** Move the stream's results (one per window, in order) into out */
+    size_t popResults(StreamId id, std::vector<VADResult>& out);
+
+    /** Latest result for the stream, or a non-speech result if none yet */
+    VADResult latestResult(StreamId id) const;
+
+    Stats getStats() const;
+    const Config& getConfig() const { return config_; }
+
+private:
+    static constexpr int kLayers = 2;
+    static constexpr int kHidden = 64;
+    static constexpr size_t kStateSize = kLayers * kHidden;
+
+    struct Stream {
+        std::vector<float> audio;
+        size_t read_pos = 0;           // start of the next window in audio
+        uint64_t base_ms = 0;          // timestamp of the first sample since reset
+        uint64_t consumed = 0;         // samples shifted out since reset
+        bool has_timestamp = false;
+        float h[kStateSize] = {};
+        float c[kStateSize] = {};
+        std::deque<VADResult> results;
+        VADResult latest = {false, 0.0f, 0};
+        uint64_t generation = 0;       // bumped on reset to drop in-flight results
+    };
+
+    Config config_;
+    size_t window_size_samples_;
+    size_t frame_shift_samples_;
+
+    std::unique_ptr<Ort::Env> env_;
+    std::unique_ptr<Ort::SessionOptions> session_options_;
+    std::unique_ptr<Ort::Session> session_;
+    Ort::MemoryInfo memory_info_;
+
+    // Input binding, resolved once by name ("input", "sr", "h", "c")
+    std::vector<std::string> input_names_;
+    std::vector<std::string> output_names_;
+    int audio_input_ = -1;
+    int sr_input_ = -1;
+    int h_input_ = -1;
+    int c_input_ = -1;
+
+    mutable std::mutex mutex_;         // guards streams_, next_id_, stats_
+    std::mutex run_mutex_;             // serializes runPending()
+    std::map<StreamId, Stream> streams_;
+    StreamId next_id_ = 1;
+    StreamId cursor_ = 0;              // round-robin start when batches are capped
+    Stats stats_;
+
+    // Batch buffers, reused across runs (touched only under run_mutex_)
+    std::vector<float> batch_audio_;
+    std::vector<float> batch_h_;
+    std::vector<float> batch_c_;
+    std::vector<StreamId> batch_ids_;
+    std::vector<uint64_t> batch_generations_;
+    std::vector<uint64_t> batch_timestamps_;
+
+    size_t gatherBatch();
+    void runBatch(size_t batch, std::vector<float>& probs);
+    void scatterBatch(size_t batch, const std::vector<float>& probs);
+    float* appendAudio(Stream& stream, size_t num_samples, uint64_t timestamp_ms);
+};
+
+} // namespace onnx_stt
+
+#endif // BATCHED_SILERO_VAD_HPP
@@ -0,0 +1,105 @@
+#ifndef CTC_BEAM_SEARCH_HPP
+#define CTC_BEAM_SEARCH_HPP
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "NgramLM.hpp"
+
+namespace onnx_stt {
+
+/**
+ * CTC prefix beam search with optional n-gram shallow fusion
+ *
+ * Hypotheses are nodes of a prefix tree, so extending a beam never copies
+ * token sequences; each node carries its LM state and accumulated LM score,
+ * plus the frame where its token's posterior peaked (for timestamps).
+ * decode() may be called repeatedly with consecutive blocks of frames for
+ * streaming use; reset() starts a new utterance.
+ *
+ * Hypothesis score = log P_ctc(prefix) + lm_weight * log P_lm(prefix)
+ *                    + token_bonus * length
+ */
+class CTCPrefixBeamSearch {
+public:
+    struct Config {
+        int beam_size = 8;
+        int blank_id = 0;
+        int max_candidates = 16;         // non-blank tokens expanded per frame
+        float candidate_beam = 10.0f;    // skip tokens this far below the frame max
+        float lm_weight = 0.5f;
+        float token_bonus = 0.0f;
+    };
+
+    explicit CTCPrefixBeamSearch(const Config& config,
+                                 std::shared_ptr<const NgramLM> lm = nullptr);
+
+    /** Start a new utterance */
+    void reset();
+
+    /** Consume @p num_frames rows of log-probabilities [num_frames, vocab_size] */
+    void decode(const float* log_probs, int num_frames, int vocab_size);
+
+    /** Add the LM end-of-sentence score before reading the final result */
+    void finalize();
+
+    /** Best token sequence so far */
+    std::vector<int> bestTokens() const;
+
+    /**
+     * Alignment of bestTokens(): for each token the frame (counted from
+     * reset()) where its posterior peaked and that log-probability
+     */
+    void bestAlignment(std::vector<int>& frames, std::vector<float>& log_probs) const;
+    
+    /** Score of the best hypothesis (see class comment) */
+    float bestScore() const;
+
+    int framesDecoded() const { return frame_offset_; }
+
+    const NgramLMStateCache* lmCache() const { return lm_cache_.get(); }
+
+private:
+    struct PrefixNode {
+        int token;
+        int parent;
+        int length;
+        NgramLM::State lm_state;
+        float lm_score;
+        int frame;        // peak frame of this token
+        float peak_logp;  // acoustic log-prob at that frame
+    };
+
+    struct Beam {
+        int node;
+        float log_blank;
+        float log_nonblank;
+        float score;
+    };
+
+    Config config_;
+    std::unique_ptr<NgramLMStateCache> lm_cache_;
+
+    std::vector<PrefixNode> nodes_;
+    std::unordered_map<uint64_t, int> children_;
+    std::vector<Beam> beams_;
+
+    // Scratch reused across frames
+    std::vector<Beam> next_beams_;
+    std::unordered_map<int, size_t> next_index_;
+    std::vector<int> candidates_;
+
+    int frame_offset_ = 0;
+    bool finalized_ = false;
+
+    int childOf(int parent, int token);
+    void notePeak(int node, float logp, int t);
+    Beam& nextBeam(int node);
+    void prune();
+    void compactNodes();
+};
+
+} // namespace onnx_stt
+
+#endif // CTC_BEAM_SEARCH_HPP
@@ -0,0 +1,102 @@
+#ifndef CASCADE_VAD_HPP
+#define CASCADE_VAD_HPP
+
+#include "VADInterface.hpp"
+#include "SileroVAD.hpp"
+#include <memory>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * Two-tier VAD: a cheap energy/zero-crossing gate in front of Silero
+ *
+ * Each gate frame is classified from its mean energy (the EnergyVAD
+ * measure, in dBFS) and zero-crossing rate:
+ *
+ *   - energy below silence_energy_db: silence, resolved by the gate
+ *   - with gate_speech enabled, energy above speech_energy_db with a
+ *     voiced-looking ZCR: speech, resolved by the gate. Off by default
+ *     because loud tonal hold music passes the same test
+ *   - anything else is ambiguous and goes to the Silero model
+ *
+ * On traffic dominated by line silence the model sees only a small
+ * fraction of the frames. The resulting per-frame probability drives a
+ * hysteresis state machine: speech starts at speech_threshold and ends after
+ * the probability stays below speech_threshold - hysteresis for hangover_ms.
+ *
+ * Without a Silero model, ambiguous frames count as speech.
+ */
+class CascadeVAD : public VADInterface {
+public:
+    struct CascadeConfig {
+        int gate_frame_ms = 32;            // gate decision granularity
+        float silence_energy_db = -55.0f;  // below: silence without the model
+        bool gate_speech = false;          // let the gate accept loud voiced frames
+        float speech_energy_db = -20.0f;   // above (with voiced ZCR): speech without the model
+        float min_speech_zcr = 0.02f;      // zero crossings per sample for the
+        float max_speech_zcr = 0.25f;      //   gate to accept loud audio as speech
+        float hysteresis = 0.15f;          // offset threshold below speech_threshold
+        int hangover_ms = 300;             // keep speech this long after the offset
+    };
+
+    explicit CascadeVAD(const Config& config);
+    CascadeVAD(const Config& config, const CascadeConfig& cascade_config);
+    ~CascadeVAD() override = default;
+
+    bool initialize(const Config& config) override;
+
+    VADResult processChunk(const int16_t* samples,
+                          size_t num_samples,
+                          uint64_t timestamp_ms) override;
+
+    VADResult processChunk(const std::vector<float>& audio,
+                          uint64_t timestamp_ms) override;
+
+    void reset() override;
+
+    const Config& getConfig() const override { return config_; }
+
+    /**
+     * Frame counts per tier and the fraction each resolved
+     * (gate_silence, gate_speech, model, *_fraction)
+     */
+    std::map<std::string, double> getStats() const override;
+
+private:
+    enum Tier { GATE_SILENCE, GATE_SPEECH, AMBIGUOUS };
+
+    Config config_;
+    CascadeConfig cascade_config_;
+    std::unique_ptr<SileroVAD> silero_;
+
+    size_t frame_samples_;
+    std::vector<float> pending_;      // partial gate frame carried to the next call
+    std::vector<float> scratch_;      // int16 conversion
+
+    // Decision state
+    bool in_speech_ = false;
+    float probability_ = 0.0f;        // latest per-frame speech probability
+    float model_probability_ = 0.0f;  // latest Silero output
+    uint64_t below_offset_ms_ = 0;    // time spent under the offset threshold
+
+    // Stats
+    uint64_t frames_total_ = 0;
+    uint64_t frames_gate_silence_ = 0;
+    uint64_t frames_gate_speech_ = 0;
+    uint64_t frames_model_ = 0;
+
+    Tier classifyFrame(const float* frame) const;
+    void processFrame(const float* frame, uint64_t timestamp_ms);
+    VADResult processSamples(const float* samples, size_t num_samples, uint64_t timestamp_ms);
+};
+
+/**
+ * Cascade VAD with explicit gate settings; returns nullptr on bad settings
+ */
+std::unique_ptr<VADInterface> createCascadeVAD(const VADInterface::Config& config,
+                                               const CascadeVAD::CascadeConfig& cascade_config);
+
+} // namespace onnx_stt
+
+#endif // CASCADE_VAD_HPP
@@ -0,0 +1,59 @@
+#ifndef ENDPOINTER_HPP
+#define ENDPOINTER_HPP
+
+#include <cstdint>
+
+namespace onnx_stt {
+
+/**
+ * Rule-based end-of-utterance detection driven by decoder output
+ *
+ * The decoder reports how much audio it has decoded in the current
+ * utterance, how much of that is trailing blank (no token emitted) and
+ * whether it has emitted any token. An endpoint fires when any enabled rule
+ * matches:
+ *
+ *   rule1: long trailing silence, even if nothing was recognized
+ *   rule2: shorter trailing silence after at least one token
+ *   rule3: utterance reached the maximum length
+ *
+ * A rule with a non-positive threshold is disabled. The defaults follow
+ * the sherpa/k2 endpointing rules.
+ */
+class Endpointer {
+public:
+    struct Rule {
+        bool must_contain_nonsilence;   // require at least one token
+        float min_trailing_silence_ms;  // trailing blanks needed (<= 0: not checked)
+        float min_utterance_length_ms;  // utterance length needed (<= 0: not checked)
+    };
+
+    struct Config {
+        Rule rule1 = {false, 2400.0f, 0.0f};
+        Rule rule2 = {true, 1200.0f, 0.0f};
+        Rule rule3 = {false, 0.0f, 20000.0f};
+    };
+
+    Endpointer();
+    explicit Endpointer(const Config& config);
+
+    /**
+     * @param utterance_ms      audio decoded since the last reset of the decoder
+     * @param trailing_blank_ms decoded audio since the last emitted token
+     * @param has_tokens        whether any token was emitted in this utterance
+     * @return index of the rule that fired (1-3), or 0 for no endpoint
+     */
+    int detect(uint64_t utterance_ms, uint64_t trailing_blank_ms, bool has_tokens) const;
+
+    const Config& config() const { return config_; }
+
+private:
+    Config config_;
+
+    static bool matches(const Rule& rule, uint64_t utterance_ms,
+                        uint64_t trailing_blank_ms, bool has_tokens);
+};
+
+} // namespace onnx_stt
+
+#endif // ENDPOINTER_HPP
@@ -7,6 +7,8 @@
 #include <complex>
 #include <memory>
 
+struct KernelBenchAccess;  // test/bench: times the private kernels
+
 namespace improved_fbank {
 
 /**
@@ -34,12 +36,17 @@ public:
     // Main feature computation method
     std::vector<std::vector<float>> computeFeatures(const std::vector<float>& audio);
     
+    // Same, reading samples in place (e.g. a StreamingBuffer chunk view)
+    std::vector<std::vector<float>> computeFeatures(const float* audio, size_t num_samples);
+    
     // Apply CMVN normalization if stats are available
     void setCMVNStats(const std::vector<float>& mean_stats, const std::vector<float>& var_stats, int frame_count);
     
     int getFeatureDim() const { return opts_.num_mel_bins; }
     
 private:
+    friend struct ::KernelBenchAccess;
+    
     Options opts_;
     int frame_length_samples_;
     int frame_shift_samples_;
@@ -45,7 +45,8 @@ private:
     // Helper methods
     bool loadCmvnStats(const std::string& stats_path);
     void applyCmvn(std::vector<std::vector<float>>& features);
-    std::vector<float> convertInt16ToFloat(const int16_t* samples, size_t num_samples);
+    
+    std::vector<float> scratch_;  // int16 input as float, reused across calls
     
     // Kaldifeat-specific members (conditionally compiled)
 #ifdef HAVE_KALDIFEAT
@@ -0,0 +1,126 @@
+#ifndef KEYED_WORKER_POOL_HPP
+#define KEYED_WORKER_POOL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Tracer.hpp"
+
+namespace onnx_stt {
+
+/**
+ * Worker threads that run tasks in parallel across keys and in order per key
+ *
+ * Every key has its own FIFO; a key is handed to at most one worker at a
+ * time, so tasks submitted under one key never overlap and run in
+ * submission order, while different keys proceed in parallel. A worker runs
+ * one task of a key and then puts the key at the back of the ready list, so
+ * a busy stream cannot starve the others.
+ *
+ * The total number of queued tasks is bounded by max_queue_depth; submit()
+ * blocks while the pool is full, which back-pressures the producer.
+ *
+ * With tracing enabled the time each task waits is an async "queue" span
+ * under the TraceTag given to submit(), so it lines up with the spans the
+ * task records itself; without one, the stream ID is a hash of the key and
+ * the chunk the submission number.
+ */
+class KeyedWorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    /** Called on the worker before each task with its key and queueing delay */
+    using WaitObserver = std::function<void(const std::string& key, uint64_t wait_us)>;
+
+    struct Config {
+        size_t num_workers = 4;
+        size_t max_queue_depth = 1024;   // queued tasks over all keys, 0 = unbounded
+        WaitObserver wait_observer;      // optional; must be thread-safe
+    };
+
+    struct Stats {
+        size_t queue_depth = 0;          // tasks waiting now
+        size_t active_keys = 0;          // keys with queued or running tasks
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t submit_waits = 0;       // submit() calls that blocked on a full pool
+        uint64_t total_wait_us = 0;      // queueing delay of completed tasks
+        uint64_t max_wait_us = 0;
+        uint64_t busy_us = 0;            // time workers spent running tasks
+        uint64_t uptime_us = 0;          // since construction
+
+        double averageWaitUs() const {
+            return completed > 0 ? static_cast<double>(total_wait_us) / completed : 0.0;
+        }
+    };
+
+    KeyedWorkerPool();
+    explicit KeyedWorkerPool(const Config& config);
+    ~KeyedWorkerPool();
+
+    KeyedWorkerPool(const KeyedWorkerPool&) = delete;
+    KeyedWorkerPool& operator=(const KeyedWorkerPool&) = delete;
+
+    /**
+     * Queue a task behind earlier tasks of the same key
+     * @param trace Stream and chunk the task is traced under, if any
+     * @return false if the pool has been shut down; the task is discarded
+     */
+    bool submit(const std::string& key, Task task, TraceTag trace = TraceTag());
+
+    /** Wait until every task submitted so far has finished */
+    void drain();
+
+    /** Finish queued tasks, then stop the workers; later submits fail */
+    void shutdown();
+
+    Stats getStats() const;
+
+    /** Fraction of worker time spent running tasks since construction */
+    double utilization() const;
+
+    size_t numWorkers() const { return workers_.size(); }
+
+private:
+    struct Entry {
+        Task task;
+        std::chrono::steady_clock::time_point queued;
+        uint64_t trace_id;               // async span ID, 0 unless tracing
+        TraceTag trace;
+    };
+
+    struct KeyQueue {
+        std::deque<Entry> tasks;
+        bool scheduled = false;          // in ready_ or held by a worker
+    };
+
+    Config config_;
+    std::vector<std::thread> workers_;
+    std::chrono::steady_clock::time_point started_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable space_ready_;
+    std::condition_variable idle_;
+
+    std::unordered_map<std::string, KeyQueue> keys_;
+    std::deque<std::string> ready_;      // keys with tasks and no worker
+    size_t queued_ = 0;
+    size_t running_ = 0;
+    bool stopping_ = false;
+    Stats stats_;
+
+    void workerLoop();
+};
+
+} // namespace onnx_stt
+
+#endif // KEYED_WORKER_POOL_HPP
@@ -0,0 +1,158 @@
+#ifndef LATENCY_GOVERNOR_HPP
+#define LATENCY_GOVERNOR_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * Online real-time-factor governor: picks a latency level per stream
+ *
+ * Levels run from 0 (smallest chunks, lowest latency) to num_levels - 1
+ * (largest chunks, cheapest per second of audio). Each stream reports how
+ * far it lags behind real time; the governor smooths that and combines it
+ * with the host CPU load, sampled from /proc/stat:
+ *
+ * - a stream moves up one level when its lag stays above raise_lag_ms, or
+ *   the host stays saturated (cpu_high) while the stream lags by more than
+ *   lower_lag_ms, for raise_hold_ms
+ * - it moves back down one level once its lag stays below lower_lag_ms and
+ *   the load below cpu_low for lower_hold_ms
+ * - between the thresholds nothing changes, and no stream changes twice
+ *   within min_dwell_ms
+ *
+ * The gap between the raise and lower thresholds and the longer lower hold
+ * are the hysteresis that keeps a stream from flapping. Thread-safe; the
+ * change listener runs on the reporting thread without the lock held.
+ */
+class LatencyGovernor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        int num_levels = 4;
+        int initial_level = 0;
+
+        double raise_lag_ms = 400.0;      // lag that moves a stream to larger chunks
+        double lower_lag_ms = 100.0;      // lag below which it may move back
+        double cpu_high = 0.90;           // busy fraction counted as saturated
+        double cpu_low = 0.70;
+
+        uint64_t raise_hold_ms = 1000;    // how long a condition must persist
+        uint64_t lower_hold_ms = 10000;
+        uint64_t min_dwell_ms = 2000;     // after any change of a stream
+
+        double lag_smoothing = 0.3;       // EWMA weight of a new lag sample
+
+        bool sample_cpu = true;           // false: load comes from setCpuLoad()
+        uint64_t cpu_sample_ms = 500;
+    };
+
+    enum class Reason {
+        LAG,         // stream fell behind
+        CPU,         // host saturated while the stream lags
+        RECOVERED    // lag and load back under the low thresholds
+    };
+
+    struct Change {
+        std::string key;
+        int from;
+        int to;
+        Reason reason;
+        double lag_ms;                    // smoothed
+        double cpu_load;
+    };
+
+    using Listener = std::function<void(const Change&)>;
+
+    struct Stats {
+        uint64_t raises = 0;
+        uint64_t lowers = 0;
+        uint64_t raises_for_lag = 0;
+        uint64_t raises_for_cpu = 0;
+        size_t streams = 0;
+        std::vector<size_t> streams_per_level;
+        double cpu_load = 0.0;
+        double max_lag_ms = 0.0;          // largest smoothed lag right now
+    };
+
+    LatencyGovernor();
+    explicit LatencyGovernor(const Config& config);
+
+    LatencyGovernor(const LatencyGovernor&) = delete;
+    LatencyGovernor& operator=(const LatencyGovernor&) = delete;
+
+    /**
+     * Report a stream's lag behind real time, registering it on first use
+     * @return The level the stream should use from now on
+     */
+    int observe(const std::string& key, double lag_ms);
+    int observe(const std::string& key, double lag_ms, Clock::time_point now);
+
+    /**
+     * Register a stream at @p level (clamped); observe() registers unknown
+     * streams at initial_level instead. A known stream keeps its state.
+     */
+    void addStream(const std::string& key, int level);
+
+    /** Current level of a stream; initial_level if unknown */
+    int level(const std::string& key) const;
+
+    void removeStream(const std::string& key);
+
+    /** Host busy fraction in [0, 1]; used as is when sample_cpu is false */
+    void setCpuLoad(double load);
+    double cpuLoad() const;
+
+    /** Called for every level change */
+    void setListener(Listener listener);
+
+    Stats getStats() const;
+
+    /**
+     * Flat gauges for operator metrics: latencyModeRaises,
+     * latencyModeLowers, streamsAtLevel<N> per level, maxLagMs and
+     * cpuLoadPermille. Names and order are fixed for a given num_levels.
+     */
+    std::vector<std::pair<std::string, int64_t>> gauges() const;
+
+    const Config& getConfig() const { return config_; }
+
+    static const char* reasonName(Reason reason);
+
+private:
+    struct StreamState {
+        int level;
+        double lag_ms = 0.0;
+        bool has_lag = false;
+        Clock::time_point last_change;
+        Clock::time_point raise_since;    // epoch while no pressure
+        Clock::time_point lower_since;    // epoch while not recovered
+    };
+
+    void sampleCpu(Clock::time_point now);
+
+    Config config_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, StreamState> streams_;
+    Listener listener_;
+    Stats stats_;
+
+    double cpu_load_ = 0.0;
+    Clock::time_point last_cpu_sample_;
+    uint64_t prev_cpu_busy_ = 0;
+    uint64_t prev_cpu_total_ = 0;
+};
+
+} // namespace onnx_stt
+
+#endif // LATENCY_GOVERNOR_HPP
@@ -0,0 +1,172 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Tracer.hpp"
+
+namespace onnx_stt {
+
+/**
+ * Lock-free latency histogram with microsecond resolution
+ *
+ * HDR-style log-linear buckets: values below 16 us get one bucket each,
+ * every larger power of two is split into 16 equal buckets, so a recorded
+ * value is known to within 1/16 (6.25%) over the whole uint64 range.
+ * record() is two relaxed atomic adds plus a CAS loop only when a new
+ * maximum or minimum is seen; any number of threads may record while
+ * another takes a snapshot.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBuckets = 16;
+    static constexpr size_t kNumBuckets = kSubBuckets * 61;   // through 2^63
+
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sum_us = 0;
+        uint64_t min_us = 0;
+        uint64_t max_us = 0;
+        std::vector<uint64_t> buckets;
+
+        double meanUs() const { return count > 0 ? static_cast<double>(sum_us) / count : 0.0; }
+
+        /**
+         * Value at quantile q in [0, 1]: the upper edge of the bucket that
+         * holds it, clamped to max_us; 0 when empty
+         */
+        uint64_t percentileUs(double q) const;
+    };
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t us);
+
+    Snapshot snapshot() const;
+
+    /** Not atomic with respect to concurrent record() calls */
+    void reset();
+
+    static size_t bucketIndex(uint64_t us);
+    static uint64_t bucketUpperUs(size_t index);   // largest value in the bucket
+
+private:
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets_;
+    std::atomic<uint64_t> sum_us_;
+    std::atomic<uint64_t> min_us_;
+    std::atomic<uint64_t> max_us_;
+};
+
+/**
+ * Per-stage latency histograms plus audio accounting for one pipeline
+ *
+ * Stages are recorded where the work happens, so they do not nest and
+ * their sum is the processing time. The real-time factor is processing
+ * time over the duration of the audio actually ingested, counted in
+ * samples at the input rate. Thread-safe; shared by all streams of an
+ * operator.
+ */
+class PipelineMetrics {
+public:
+    enum class Stage {
+        INGEST,        // int16 conversion, resampling, buffering
+        VAD,
+        FBANK,
+        ENCODER,       // acoustic model inference
+        DECODER,       // CTC/beam search and result tracking
+        DETOKENIZE,
+        SUBMIT,        // building and submitting output tuples
+        COUNT
+    };
+    static constexpr size_t kNumStages = static_cast<size_t>(Stage::COUNT);
+
+    PipelineMetrics();
+
+    void record(Stage stage, uint64_t us) { stages_[static_cast<size_t>(stage)].record(us); }
+
+    /** Count @p num_samples of audio at @p sample_rate towards the RTF */
+    void addAudio(uint64_t num_samples, int sample_rate);
+
+    const LatencyHistogram& stage(Stage stage) const { return stages_[static_cast<size_t>(stage)]; }
+
+    /** Audio ingested, in microseconds */
+    uint64_t audioUs() const;
+
+    /** Sum of all stage latencies, in microseconds */
+    uint64_t processingUs() const;
+
+    double realTimeFactor() const;
+
+    void reset();
+
+    /** Lower-case stage name, e.g. "fbank" */
+    static const char* stageName(Stage stage);
+
+    /**
+     * Flat gauges for operator metrics: <stage>P50Us, <stage>P99Us and
+     * <stage>MaxUs per stage, then realTimeFactorPermille. The names and
+     * their order never change, so callers may create metrics once and
+     * update them by position.
+     */
+    std::vector<std::pair<std::string, int64_t>> gauges() const;
+
+    /**
+     * JSON object with audio_ms, processing_ms, rtf and per stage count,
+     * mean, p50, p90, p99, p999 and max in microseconds
+     */
+    std::string toJson() const;
+
+private:
+    std::array<LatencyHistogram, kNumStages> stages_;
+    std::atomic<uint64_t> audio_ns_;   // nanoseconds keep per-chunk rounding negligible
+};
+
+/**
+ * Records the lifetime of the scope into one stage; a null metrics
+ * pointer skips the histogram. When tracing is enabled the scope is also
+ * a trace span named after the stage.
+ */
+class StageTimer {
+public:
+    StageTimer(PipelineMetrics* metrics, PipelineMetrics::Stage stage)
+        : metrics_(metrics), stage_(stage), span_(PipelineMetrics::stageName(stage)) {
+        if (metrics_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~StageTimer() { stop(); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    /** Record now instead of at scope exit */
+    void stop() {
+        span_.stop();
+        if (metrics_) {
+            metrics_->record(stage_, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start_).count()));
+            metrics_ = nullptr;
+        }
+    }
+
+private:
+    PipelineMetrics* metrics_;
+    PipelineMetrics::Stage stage_;
+    std::chrono::steady_clock::time_point start_;
+    TraceSpan span_;
+};
+
+} // namespace onnx_stt
+
+#endif // LATENCY_HISTOGRAM_HPP
@@ -5,10 +5,13 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <cstdint>
 #include "CacheManager.hpp"
 
 namespace onnx_stt {
 
+class PipelineMetrics;
+
 /**
  * Abstract interface for different ASR model architectures
  * Supports Zipformer, Conformer, WeNet, SpeechBrain, etc.
@@ -58,7 +61,20 @@ public:
         double confidence;
         uint64_t timestamp_ms;
         uint64_t latency_ms;
-        std::vector<float> token_probs;  // Optional: token-level probabilities
+        std::vector<float> token_probs;  // Optional: token-level probabilities (tokens of this update)
+        
+        // Incremental output (see PartialResultTracker)
+        std::string stable_text;             // Newly committed text, never revised
+        std::string unstable_text;           // Uncommitted tail, may still change
+        uint64_t stable_offset = 0;          // Byte offset of stable_text in the utterance
+        std::vector<uint32_t> word_offsets;  // Utterance byte offsets of words in this update
+        std::vector<uint32_t> word_start_ms; // Parallel to word_offsets (empty if untimed)
+        std::vector<uint32_t> word_end_ms;
+        
+        // Decoder activity in the current utterance, for endpointing
+        uint64_t utterance_ms = 0;           // Audio decoded since reset()
+        uint64_t trailing_blank_ms = 0;      // Decoded audio since the last emitted token
+        uint32_t utterance_tokens = 0;       // Tokens emitted since reset()
     };
     
     virtual ~ModelInterface() = default;
@@ -73,6 +89,16 @@ public:
     // Reset model state (caches, beam search, etc.)
     virtual void reset() = 0;
     
+    // End the utterance: commit the remaining hypothesis as final. Callers
+    // reset() afterwards. Models without a pending hypothesis return an
+    // empty final result.
+    virtual TranscriptionResult finalize(uint64_t timestamp_ms) {
+        TranscriptionResult result{};
+        result.is_final = true;
+        result.timestamp_ms = timestamp_ms;
+        return result;
+    }
+    
     // Get model configuration
     virtual const ModelConfig& getConfig() const = 0;
     
@@ -87,6 +113,11 @@ public:
     
     // Get expected chunk size in frames
     virtual int getChunkFrames() const = 0;
+    
+    // Record encoder/decoder/detokenize latencies into metrics (null stops
+    // recording). Returns false if the model cannot split its stages; the
+    // caller then times processChunk() as a whole
+    virtual bool setMetrics(PipelineMetrics* /* metrics */) { return false; }
 };
 
 /**
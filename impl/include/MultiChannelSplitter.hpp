@@ -0,0 +1,89 @@
+#ifndef MULTI_CHANNEL_SPLITTER_HPP
+#define MULTI_CHANNEL_SPLITTER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace com {
+namespace teracloud {
+namespace streamsx {
+namespace stt {
+
+/**
+ * Splits N-channel audio (conference bridges, multi-leg calls) into
+ * per-channel float buffers and tracks which channels carry signal.
+ *
+ * Each split deinterleaves all channels in one pass into buffers owned by
+ * the splitter, valid until the next split. The RMS level of every channel
+ * is measured per block. With suppressSilentChannels, a channel whose
+ * level stays below silenceThresholdDb for longer than silenceHangoverMs is
+ * reported inactive so callers can skip it before it reaches VAD or a
+ * model; channels then start inactive until their first loud block.
+ */
+class MultiChannelSplitter {
+public:
+    struct Config {
+        int numChannels = 2;
+        int sampleRate = 8000;
+        bool interleaved = true;          // false: one contiguous block per channel
+        bool normalizeFloat = true;       // [-1.0, 1.0) instead of PCM values
+        bool suppressSilentChannels = false;  // opt-in: drops leading and trailing silence
+        float silenceThresholdDb = -50.0f;  // block RMS in dBFS below which it is silent
+        int silenceHangoverMs = 1000;       // stay active this long after the last loud block
+    };
+
+    struct ChannelStats {
+        float levelDb = -120.0f;          // RMS of the last block, dBFS
+        bool active = false;
+        uint64_t samplesEmitted = 0;
+        uint64_t samplesSuppressed = 0;
+    };
+
+    MultiChannelSplitter();
+    explicit MultiChannelSplitter(const Config& config);
+
+    /**
+     * Split a block; numSamples counts samples over all channels and must
+     * be a multiple of numChannels
+     * @return Samples per channel
+     */
+    size_t splitPCM16(const int16_t* data, size_t numSamples);
+    size_t splitPCM8(const uint8_t* data, size_t numSamples);
+    size_t splitG711uLaw(const uint8_t* data, size_t numBytes);
+    size_t splitG711aLaw(const uint8_t* data, size_t numBytes);
+
+    /** Dispatch on "pcm16", "pcm8", "ulaw" or "alaw" */
+    size_t split(const std::string& encoding, const uint8_t* data, size_t numBytes);
+
+    int numChannels() const { return config_.numChannels; }
+    size_t samplesPerChannel() const { return samplesPerChannel_; }
+    const float* channel(int index) const { return channels_[index].data(); }
+
+    /** False when the channel is suppressed as silent */
+    bool isActive(int index) const { return stats_[index].active; }
+
+    const std::vector<ChannelStats>& getStats() const { return stats_; }
+
+    void reset();
+
+private:
+    Config config_;
+    std::vector<std::vector<float>> channels_;
+    std::vector<float*> outputs_;
+    std::vector<ChannelStats> stats_;
+    std::vector<uint64_t> silentSamples_;   // trailing silent samples per channel
+    size_t samplesPerChannel_ = 0;
+
+    size_t prepare(size_t numSamples);
+    size_t splitTable(const uint8_t* data, size_t numBytes, const float* table, float fullScale);
+    void updateActivity(float fullScale);
+};
+
+} // namespace stt
+} // namespace streamsx
+} // namespace teracloud
+} // namespace com
+
+#endif // MULTI_CHANNEL_SPLITTER_HPP
@@ -89,7 +89,7 @@ bool NeMoCTCImpl::initialize(const std::string& model_path, const std::string& t
             }
             std::cout << "]" << std::endl;
         }
-        std::cout << "Vocabulary size: " << vocab_.size() << ", blank_id: " << blank_id_ << std::endl;
+        std::cout << "Vocabulary size: " << vocab_->size() << ", blank_id: " << blank_id_ << std::endl;
         
         return true;
         
@@ -102,39 +102,22 @@ bool NeMoCTCImpl::initialize(const std::string& model_path, const std::string& t
 bool NeMoCTCImpl::loadVocabulary(const std::string& tokens_path) {
     std::cout << "Attempting to load vocabulary from: " << tokens_path << std::endl;
     
-    std::ifstream file(tokens_path);
-    if (!file.is_open()) {
-        std::cerr << "Cannot open tokens file: " << tokens_path << std::endl;
-        std::cerr << "Error: " << strerror(errno) << std::endl;
+    vocab_ = onnx_stt::TokenVocabulary::load(tokens_path);
+    if (!vocab_) {
+        std::cerr << "Cannot load tokens file: " << tokens_path << std::endl;
         return false;
     }
     
-    std::string line;
-    int id = 0;
-    
-    // Read tokens - each line is a token, ID is line number
-    while (std::getline(file, line)) {
-        if (!line.empty()) {
-            vocab_[id] = line;
-            id++;
-        }
-    }
-    
     // NeMo uses blank token ID 1024
     blank_id_ = 1024;
     
-    std::cout << "Loaded " << vocab_.size() << " tokens from vocabulary" << std::endl;
-    
-    if (vocab_.empty()) {
-        std::cerr << "Vocabulary is empty after loading!" << std::endl;
-        return false;
-    }
-    
+    std::cout << "Loaded " << vocab_->size() << " tokens from vocabulary" << std::endl;
     return true;
 }
 
 std::vector<float> NeMoCTCImpl::extractMelFeatures(const std::vector<float>& audio_samples) {
     // Use ImprovedFbank for feature extraction
+    onnx_stt::StageTimer timer(metrics_, onnx_stt::PipelineMetrics::Stage::FBANK);
     auto features_2d = fbank_computer_->computeFeatures(audio_samples);
     
     std::cout << "ImprovedFbank extracted " << features_2d.size() << " frames with " 
@@ -168,7 +151,7 @@ std::string NeMoCTCImpl::transcribe(const std::vector<float>& audio_samples) {
                   << n_mels << " features per frame" << std::endl;
         
         // Model expects exactly 125 frames - process in chunks
-        const int EXPECTED_FRAMES = 125;
+        const int EXPECTED_FRAMES = kWindowFrames;
         
         if (n_frames < EXPECTED_FRAMES) {
             std::cout << "WARNING: Only " << n_frames << " frames, model expects " 
@@ -202,86 +185,137 @@ std::string NeMoCTCImpl::transcribe(const std::vector<float>& audio_samples) {
             std::cout << "Saved " << mel_features.size() << " features to cpp_features_debug.bin" << std::endl;
         }
         
-        // Prepare input tensors
-        // Model expects [batch, features, time] not [batch, time, features]
-        // mel_features is currently in [time, features] format, need to transpose
-        std::vector<float> transposed_features(mel_features.size());
-        
-        // Transpose from [time, features] to [features, time]
-        for (int t = 0; t < n_frames; t++) {
-            for (int f = 0; f < n_mels; f++) {
-                transposed_features[f * n_frames + t] = mel_features[t * n_mels + f];
-            }
-        }
-        
-        std::vector<int64_t> audio_shape = {1, n_mels, n_frames};  // [batch, features, time]
-        
-        std::cout << "Tensor shape for model: [" << audio_shape[0] << ", " 
-                  << audio_shape[1] << ", " << audio_shape[2] << "]" << std::endl;
+        std::vector<float> logits_vec;
+        std::vector<int64_t> logits_shape;
+        runModel(mel_features, n_frames, logits_vec, logits_shape);
         
-        auto audio_tensor = Ort::Value::CreateTensor<float>(
-            *memory_info_, 
-            transposed_features.data(),
-            transposed_features.size(),
-            audio_shape.data(), 
-            audio_shape.size()
-        );
-        
-        // Prepare input/output arrays
-        std::vector<Ort::Value> input_tensors;
-        input_tensors.push_back(std::move(audio_tensor));
-        
-        // Only pass length tensor if model expects it (num_inputs > 1)
-        if (input_names_.size() > 1) {
-            std::vector<int64_t> length_shape = {1};
-            std::vector<int64_t> length_data = {n_frames};
-            auto length_tensor = Ort::Value::CreateTensor<int64_t>(
-                *memory_info_,
-                length_data.data(),
-                length_data.size(),
-                length_shape.data(),
-                length_shape.size()
-            );
-            input_tensors.push_back(std::move(length_tensor));
-        }
-        
-        std::vector<const char*> input_names_cstr;
-        for (const auto& name : input_names_) {
-            input_names_cstr.push_back(name.c_str());
-        }
+        // Decode CTC output
+        onnx_stt::StageTimer decoder_timer(metrics_, onnx_stt::PipelineMetrics::Stage::DECODER);
+        return ctcDecode(logits_vec, logits_shape);
         
-        std::vector<const char*> output_names_cstr;
-        for (const auto& name : output_names_) {
-            output_names_cstr.push_back(name.c_str());
+    } catch (const std::exception& e) {
+        return "ERROR: " + std::string(e.what());
+    }
+}
+
+bool NeMoCTCImpl::runModel(const std::vector<float>& mel_features, int n_frames,
+                           std::vector<float>& logits, std::vector<int64_t>& shape) {
+    onnx_stt::StageTimer timer(metrics_, onnx_stt::PipelineMetrics::Stage::ENCODER);
+    const int n_mels = 80;
+    
+    // Model expects [batch, features, time] not [batch, time, features]
+    // mel_features is currently in [time, features] format, need to transpose
+    std::vector<float> transposed_features(mel_features.size());
+    
+    // Transpose from [time, features] to [features, time]
+    for (int t = 0; t < n_frames; t++) {
+        for (int f = 0; f < n_mels; f++) {
+            transposed_features[f * n_frames + t] = mel_features[t * n_mels + f];
         }
-        
-        // Run inference
-        auto output_tensors = session_->Run(
-            Ort::RunOptions{nullptr},
-            input_names_cstr.data(),
-            input_tensors.data(),
-            input_tensors.size(),
-            output_names_cstr.data(),
-            output_names_cstr.size()
+    }
+    
+    std::vector<int64_t> audio_shape = {1, n_mels, n_frames};  // [batch, features, time]
+    
+    auto audio_tensor = Ort::Value::CreateTensor<float>(
+        *memory_info_, 
+        transposed_features.data(),
+        transposed_features.size(),
+        audio_shape.data(), 
+        audio_shape.size()
+    );
+    
+    // Prepare input/output arrays
+    std::vector<Ort::Value> input_tensors;
+    input_tensors.push_back(std::move(audio_tensor));
+    
+    // Only pass length tensor if model expects it (num_inputs > 1)
+    std::vector<int64_t> length_shape = {1};
+    std::vector<int64_t> length_data = {n_frames};
+    if (input_names_.size() > 1) {
+        auto length_tensor = Ort::Value::CreateTensor<int64_t>(
+            *memory_info_,
+            length_data.data(),
+            length_data.size(),
+            length_shape.data(),
+            length_shape.size()
         );
-        
-        // Get output logits
-        float* logits_data = output_tensors[0].GetTensorMutableData<float>();
-        auto logits_shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
-        
-        // Convert to vector for decoding
-        size_t logits_size = 1;
-        for (auto dim : logits_shape) {
-            logits_size *= dim;
+        input_tensors.push_back(std::move(length_tensor));
+    }
+    
+    std::vector<const char*> input_names_cstr;
+    for (const auto& name : input_names_) {
+        input_names_cstr.push_back(name.c_str());
+    }
+    
+    std::vector<const char*> output_names_cstr;
+    for (const auto& name : output_names_) {
+        output_names_cstr.push_back(name.c_str());
+    }
+    
+    // Run inference
+    auto output_tensors = session_->Run(
+        Ort::RunOptions{nullptr},
+        input_names_cstr.data(),
+        input_tensors.data(),
+        input_tensors.size(),
+        output_names_cstr.data(),
+        output_names_cstr.size()
+    );
+    
+    // Get output logits
+    const float* logits_data = output_tensors[0].GetTensorData<float>();
+    shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    
+    size_t logits_size = 1;
+    for (auto dim : shape) {
+        logits_size *= dim;
+    }
+    logits.assign(logits_data, logits_data + logits_size);
+    return true;
+}
+
+size_t NeMoCTCImpl::windowSamples() const {
+    // 25 ms frames every 10 ms at 16 kHz (see the fbank options in initialize)
+    return 400 + static_cast<size_t>(kWindowFrames - 1) * 160;
+}
+
+bool NeMoCTCImpl::computeFrameTokens(const std::vector<float>& audio_samples,
+                                     std::vector<int>& frame_tokens) {
+    frame_tokens.clear();
+    if (!initialized_) {
+        return false;
+    }
+    
+    try {
+        onnx_stt::StageTimer fbank_timer(metrics_, onnx_stt::PipelineMetrics::Stage::FBANK);
+        auto features_2d = fbank_computer_->computeFeatures(audio_samples);
+        fbank_timer.stop();
+        
+        const int n_mels = 80;
+        std::vector<float> mel_features(static_cast<size_t>(kWindowFrames) * n_mels, 0.0f);
+        size_t frames = std::min(features_2d.size(), static_cast<size_t>(kWindowFrames));
+        for (size_t t = 0; t < frames; t++) {
+            std::copy(features_2d[t].begin(), features_2d[t].begin() + n_mels,
+                      mel_features.begin() + t * n_mels);
         }
         
-        std::vector<float> logits_vec(logits_data, logits_data + logits_size);
-        
-        // Decode CTC output
-        return ctcDecode(logits_vec, logits_shape);
+        std::vector<float> logits;
+        std::vector<int64_t> shape;
+        runModel(mel_features, kWindowFrames, logits, shape);
+        
+        onnx_stt::StageTimer decoder_timer(metrics_, onnx_stt::PipelineMetrics::Stage::DECODER);
+        const int time_steps = static_cast<int>(shape[1]);
+        const int vocab_size = static_cast<int>(shape[2]);
+        frame_tokens.resize(time_steps);
+        for (int t = 0; t < time_steps; t++) {
+            const float* row = logits.data() + static_cast<size_t>(t) * vocab_size;
+            frame_tokens[t] = static_cast<int>(std::max_element(row, row + vocab_size) - row);
+        }
+        return true;
         
     } catch (const std::exception& e) {
-        return "ERROR: " + std::string(e.what());
+        std::cerr << "NeMo CTC window inference failed: " << e.what() << std::endl;
+        return false;
     }
 }
 
@@ -320,8 +354,8 @@ std::string NeMoCTCImpl::ctcDecode(const std::vector<float>& logits, const std::
         if (t < 5) {
             std::cout << "  Frame " << t << ": max_idx=" << max_idx 
                       << " (blank=" << blank_id_ << "), max_val=" << max_val;
-            if (vocab_.find(max_idx) != vocab_.end()) {
-                std::cout << ", token='" << vocab_[max_idx] << "'";
+            if (max_idx < vocab_->size()) {
+                std::cout << ", token='" << vocab_->piece(max_idx) << "'";
             }
             std::cout << std::endl;
         }
@@ -337,29 +371,12 @@ std::string NeMoCTCImpl::ctcDecode(const std::vector<float>& logits, const std::
             continue;
         }
         
-        // Add token to result
-        if (vocab_.find(max_idx) != vocab_.end()) {
-            std::string token = vocab_[max_idx];
-            
-            // Handle SentencePiece tokens (▁ character is 0xE2 0x96 0x81 in UTF-8)
-            if (token.length() >= 3 && 
-                (unsigned char)token[0] == 0xE2 && 
-                (unsigned char)token[1] == 0x96 && 
-                (unsigned char)token[2] == 0x81) {
-                result += " " + token.substr(3);  // Remove ▁ and add space
-            } else {
-                result += token;
-            }
-        }
+        // Add token to result (word-initial pieces get a separating space)
+        vocab_->appendToken(max_idx, result);
         
         prev_token = max_idx;
     }
     
-    // Trim leading/trailing spaces
-    if (!result.empty() && result[0] == ' ') {
-        result = result.substr(1);
-    }
-    
     return result;
 }
 
@@ -390,7 +407,7 @@ std::string NeMoCTCImpl::getModelInfo() const {
         info << "]\n";
     }
     
-    info << "Vocabulary size: " << vocab_.size() << "\n";
+    info << "Vocabulary size: " << (vocab_ ? vocab_->size() : 0) << "\n";
     info << "Blank token ID: " << blank_id_;
     
     return info.str();
@@ -399,3 +416,117 @@ std::string NeMoCTCImpl::getModelInfo() const {
 std::unique_ptr<NeMoCTCImpl> createNeMoCTCImpl() {
     return std::make_unique<NeMoCTCImpl>();
 }
+
+NeMoCTCStream::NeMoCTCStream(NeMoCTCImpl& model, const Config& config)
+    : model_(model), config_(config), endpointer_(config.endpoint_config) {
+    window_.assign(model_.windowSamples(), 0.0f);
+    chunk_samples_ = static_cast<size_t>(std::max(config_.chunk_ms, 10)) * config_.sample_rate / 1000;
+    chunk_samples_ = std::min(chunk_samples_, window_.size());
+    chunk_.assign(chunk_samples_, 0.0f);
+    resetUtterance();
+}
+
+void NeMoCTCStream::acceptAudio(const float* samples, size_t num_samples,
+                                std::vector<Update>& updates) {
+    while (num_samples > 0) {
+        size_t take = std::min(num_samples, chunk_samples_ - pending_);
+        std::copy(samples, samples + take, chunk_.begin() + pending_);
+        pending_ += take;
+        samples += take;
+        num_samples -= take;
+        if (pending_ < chunk_samples_) {
+            break;
+        }
+        
+        decodeChunk(chunk_samples_);
+        pending_ = 0;
+        
+        if (endpointer_.detect(static_cast<uint64_t>(utterance_ms_),
+                               static_cast<uint64_t>(trailing_blank_ms_), has_tokens_)) {
+            if (!text_.empty()) {
+                updates.push_back({text_, true});
+            }
+            resetUtterance();
+            continue;
+        }
+        
+        // First text right away, then at most one partial per interval
+        since_partial_ms_ += config_.chunk_ms;
+        if (config_.partial_interval_ms > 0 && text_ != last_partial_ &&
+            (last_partial_.empty() || since_partial_ms_ >= static_cast<uint64_t>(config_.partial_interval_ms))) {
+            updates.push_back({text_, false});
+            last_partial_ = text_;
+            since_partial_ms_ = 0;
+        }
+    }
+}
+
+bool NeMoCTCStream::finalize(Update& update) {
+    if (pending_ > 0) {
+        // Zero-pad the last partial chunk and decode only its real audio
+        std::fill(chunk_.begin() + pending_, chunk_.end(), 0.0f);
+        decodeChunk(pending_);
+        pending_ = 0;
+    }
+    
+    bool has_text = !text_.empty();
+    if (has_text) {
+        update = {text_, true};
+    }
+    resetUtterance();
+    return has_text;
+}
+
+void NeMoCTCStream::reset() {
+    std::fill(window_.begin(), window_.end(), 0.0f);
+    pending_ = 0;
+    resetUtterance();
+}
+
+void NeMoCTCStream::decodeChunk(size_t valid_samples) {
+    // Slide the window by one chunk and put the new chunk at its end
+    std::copy(window_.begin() + chunk_samples_, window_.end(), window_.begin());
+    std::copy(chunk_.begin(), chunk_.end(), window_.end() - chunk_samples_);
+    
+    if (!model_.computeFrameTokens(window_, frame_tokens_) || frame_tokens_.empty()) {
+        return;
+    }
+    
+    // Output frames covering the chunk, and of those the ones with real audio
+    const size_t total_frames = frame_tokens_.size();
+    const double frame_ms = 1000.0 * window_.size() / config_.sample_rate / total_frames;
+    size_t chunk_frames = static_cast<size_t>(
+        std::lround(static_cast<double>(total_frames) * chunk_samples_ / window_.size()));
+    chunk_frames = std::min(std::max<size_t>(chunk_frames, 1), total_frames);
+    size_t valid_frames = static_cast<size_t>(
+        std::lround(static_cast<double>(chunk_frames) * valid_samples / chunk_samples_));
+    
+    // Merging the chunk's tokens into the text counts as detokenization
+    onnx_stt::StageTimer timer(model_.metrics(), onnx_stt::PipelineMetrics::Stage::DETOKENIZE);
+    const int blank = model_.blankId();
+    const onnx_stt::TokenVocabulary& vocab = model_.vocabulary();
+    for (size_t t = total_frames - chunk_frames; t < total_frames - chunk_frames + valid_frames; t++) {
+        int token = frame_tokens_[t];
+        if (token == blank) {
+            trailing_blank_ms_ += frame_ms;
+        } else {
+            trailing_blank_ms_ = 0.0;
+            if (token != prev_token_) {
+                vocab.appendToken(token, text_);
+                has_tokens_ = true;
+            }
+        }
+        prev_token_ = token;
+        utterance_ms_ += frame_ms;
+    }
+}
+
+void NeMoCTCStream::resetUtterance() {
+    text_.clear();
+    prev_token_ = model_.blankId();
+    has_tokens_ = false;
+    utterance_ms_ = 0.0;
+    trailing_blank_ms_ = 0.0;
+    since_partial_ms_ = 0;
+    last_partial_.clear();
+}
@@ -2,10 +2,12 @@
 
 #include "onnx_wrapper.hpp"
 #include "ImprovedFbank.hpp"
+#include "TokenVocabulary.hpp"
+#include "Endpointer.hpp"
+#include "LatencyHistogram.hpp"
 #include <vector>
 #include <string>
 #include <memory>
-#include <unordered_map>
 
 class NeMoCTCImpl {
 public:
@@ -18,10 +20,26 @@ public:
     // Process audio and return transcription
     std::string transcribe(const std::vector<float>& audio_samples);
     
+    // Feature frames per model call; longer audio is truncated, shorter padded
+    static constexpr int kWindowFrames = 125;
+    
+    // Audio samples that make exactly kWindowFrames feature frames
+    size_t windowSamples() const;
+    
+    // Greedy (argmax) token per output frame for one window of audio, quietly
+    bool computeFrameTokens(const std::vector<float>& audio_samples, std::vector<int>& frame_tokens);
+    
+    int blankId() const { return blank_id_; }
+    const onnx_stt::TokenVocabulary& vocabulary() const { return *vocab_; }
+    
     // Get model info
     std::string getModelInfo() const;
     bool isInitialized() const { return initialized_; }
     
+    // Record fbank/encoder/decoder latencies into metrics (null stops)
+    void setMetrics(onnx_stt::PipelineMetrics* metrics) { metrics_ = metrics; }
+    onnx_stt::PipelineMetrics* metrics() const { return metrics_; }
+    
 private:
     // ONNX Runtime components
     std::unique_ptr<Ort::Env> env_;
@@ -39,14 +57,80 @@ private:
     bool initialized_;
     
     // Vocabulary
-    std::unordered_map<int, std::string> vocab_;
+    std::shared_ptr<const onnx_stt::TokenVocabulary> vocab_;
     int blank_id_;
     
     // Feature extractor using ImprovedFbank
     std::unique_ptr<improved_fbank::FbankComputer> fbank_computer_;
     
+    onnx_stt::PipelineMetrics* metrics_ = nullptr;
+    
     // Helper methods
     bool loadVocabulary(const std::string& tokens_path);
     std::vector<float> extractMelFeatures(const std::vector<float>& audio_samples);
+    bool runModel(const std::vector<float>& mel_features, int n_frames,
+                  std::vector<float>& logits, std::vector<int64_t>& shape);
     std::string ctcDecode(const std::vector<float>& logits, const std::vector<int64_t>& shape);
+};
+
+/**
+ * Incremental transcription over NeMoCTCImpl with bounded memory
+ *
+ * Audio is decoded every chunk_ms over a rolling window of one model call
+ * (kWindowFrames feature frames, about 1.27 s at 16 kHz): the new chunk at
+ * the end and the preceding audio as left context. Only the output frames
+ * of the new chunk are merged into the running CTC hypothesis, so memory
+ * stays at one window per stream regardless of call length.
+ *
+ * Partial results are reported every partial_interval_ms while the text
+ * changes; the first text is reported as soon as it appears. A final result
+ * is reported when the endpointer fires on trailing blanks or on finalize().
+ */
+class NeMoCTCStream {
+public:
+    struct Config {
+        int sample_rate = 16000;
+        int chunk_ms = 400;
+        int partial_interval_ms = 500;    // 0 disables partial results
+        onnx_stt::Endpointer::Config endpoint_config;
+    };
+    
+    struct Update {
+        std::string text;                 // full utterance text so far
+        bool is_final;
+    };
+    
+    NeMoCTCStream(NeMoCTCImpl& model, const Config& config);
+    
+    /** Add audio; decoded partial and final results are appended to updates */
+    void acceptAudio(const float* samples, size_t num_samples, std::vector<Update>& updates);
+    
+    /** Decode buffered audio and close the utterance; false if there is no text */
+    bool finalize(Update& update);
+    
+    /** Forget all audio and the current utterance */
+    void reset();
+    
+private:
+    NeMoCTCImpl& model_;
+    Config config_;
+    onnx_stt::Endpointer endpointer_;
+    
+    size_t chunk_samples_;
+    std::vector<float> window_;           // left context followed by the newest chunk
+    std::vector<float> chunk_;            // next chunk being filled
+    size_t pending_ = 0;                  // samples in chunk_
+    std::vector<int> frame_tokens_;
+    
+    // Current utterance
+    std::string text_;
+    int prev_token_;
+    bool has_tokens_ = false;
+    double utterance_ms_ = 0.0;           // frame durations are fractional: summed
+    double trailing_blank_ms_ = 0.0;      // unrounded, truncated for the endpointer
+    uint64_t since_partial_ms_ = 0;
+    std::string last_partial_;
+    
+    void decodeChunk(size_t valid_samples);
+    void resetUtterance();
 };
\ No newline at end of file
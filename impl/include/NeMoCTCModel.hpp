@@ -7,6 +7,12 @@
 #include <vector>
 #include <random>
 #include "ImprovedFbank.hpp"
+#include "CTCBeamSearch.hpp"
+#include "LatencyHistogram.hpp"
+#include "PartialResultTracker.hpp"
+#include "TokenVocabulary.hpp"
+
+struct KernelBenchAccess;  // test/bench: times the private kernels
 
 namespace onnx_stt {
 
@@ -33,14 +39,26 @@ public:
         float dither = 1e-5f;
         int blank_id = 1024;  // Default for NeMo models
         int num_threads = 4;
+        
+        // Decoding: greedy unless beam_size > 1 or an LM is given
+        int beam_size = 1;
+        std::string lm_path;          // binary n-gram LM (see NgramLM), optional
+        float lm_weight = 0.5f;
+        float lm_token_bonus = 0.0f;
     };
     
     struct TranscriptionResult {
         std::string text;
         std::vector<int> token_ids;
-        std::vector<float> confidences;
+        std::vector<float> confidences;   // per token: posterior at its peak frame
+        std::vector<uint32_t> token_ms;   // per token: time of its peak frame
         float avg_confidence;
         int num_frames;
+        
+        // Per word, parallel arrays: byte offset in text, start/end time
+        std::vector<uint32_t> word_offsets;
+        std::vector<uint32_t> word_start_ms;
+        std::vector<uint32_t> word_end_ms;
     };
     
     explicit NeMoCTCModel(const Config& config);
@@ -58,10 +76,21 @@ public:
     // Process raw audio
     TranscriptionResult processAudio(const std::vector<float>& audio);
     
+    // Process several utterances in one inference call, padded to the longest;
+    // sort them by length first to keep padding small (see SegmentQueue)
+    std::vector<TranscriptionResult> processAudioBatch(const std::vector<std::vector<float>>& audios);
+    std::vector<TranscriptionResult> processFeaturesBatch(
+        const std::vector<std::vector<std::vector<float>>>& batch);
+    
     // Get vocabulary
-    const std::vector<std::string>& getVocabulary() const { return vocabulary_; }
+    const TokenVocabulary& getVocabulary() const { return *vocabulary_; }
+    
+    // Record fbank/encoder/decoder latencies into metrics (null stops)
+    void setMetrics(PipelineMetrics* metrics) { metrics_ = metrics; }
     
 private:
+    friend struct ::KernelBenchAccess;
+    
     Config config_;
     
     // ONNX Runtime components
@@ -74,21 +103,29 @@ private:
     std::vector<std::string> output_name_strings_;
     std::vector<const char*> input_names_;
     std::vector<const char*> output_names_;
-    std::vector<std::string> vocabulary_;
+    std::shared_ptr<const TokenVocabulary> vocabulary_;
     
     // Feature extractor
     std::unique_ptr<improved_fbank::FbankComputer> fbank_computer_;
     
+    // Beam search decoder (only when beam search or LM fusion is enabled)
+    std::unique_ptr<CTCPrefixBeamSearch> beam_search_;
+    
     // Random generator for dither
     std::default_random_engine generator_;
     std::normal_distribution<float> dither_dist_;
     
+    PipelineMetrics* metrics_ = nullptr;
+    
     // Private methods
     bool loadModel();
     bool loadVocabulary();
     void addDither(std::vector<float>& audio);
-    std::string greedyCTCDecode(const std::vector<std::vector<float>>& log_probs);
-    std::string handleBPETokens(const std::vector<int>& tokens);
+    TranscriptionResult decodeLogProbs(const float* log_probs_data, int64_t output_length,
+                                       int64_t vocab_size, size_t num_frames);
+    void greedyCTCDecode(const std::vector<std::vector<float>>& log_probs,
+                         std::vector<int>& tokens, std::vector<int>& frames,
+                         std::vector<float>& peak_log_probs);
 };
 
 } // namespace onnx_stt
@@ -3,7 +3,11 @@
 
 #include "ModelInterface.hpp"
 #include "CacheManager.hpp"
+#include "LatencyHistogram.hpp"
 #include "onnx_wrapper.hpp"
+#include "PartialResultTracker.hpp"
+#include "TokenVocabulary.hpp"
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +29,10 @@ namespace onnx_stt {
  * Supported Models:
  * - stt_en_fastconformer_hybrid_large_streaming_multi (114M params)
  * - Custom NeMo cache-aware models exported with cache_support=True
+ *
+ * Everything that belongs to one audio stream lives in a DecodeState, so a
+ * single loaded model can decode many streams. The ModelInterface methods
+ * operate on a built-in default state.
  */
 class NeMoCacheAwareConformer : public ModelInterface {
 public:
@@ -38,6 +46,7 @@ public:
         int last_time_cache_size = 64;
         int num_cache_layers = 12;      // Number of layers with caching
         int hidden_size = 512;          // Model hidden dimension
+        int subsampling_factor = 4;     // Feature frames per encoder frame (for timestamps)
         
         // Attention context configuration (affects latency)
         // [70,0]: 0ms, [70,1]: 80ms, [70,16]: 480ms, [70,33]: 1040ms
@@ -48,6 +57,24 @@ public:
         std::string vocab_path = "";
     };
 
+    /**
+     * Per-stream decoding state: caches and the utterance decoded so far
+     */
+    struct DecodeState {
+        std::vector<float> cache_last_channel;  // empty unless the model takes cache inputs
+        std::vector<float> cache_last_time;
+        bool initialized = false;
+        
+        std::vector<int> utterance_tokens;
+        std::vector<uint32_t> utterance_token_ms;
+        uint64_t utterance_ms = 0;       // audio consumed since reset
+        uint64_t trailing_blank_ms = 0;  // audio since the last emitted token
+        PartialResultTracker tracker;
+        
+        explicit DecodeState(const PartialResultTracker::Config& tracker_config)
+            : tracker(nullptr, tracker_config) {}
+    };
+
     explicit NeMoCacheAwareConformer(const NeMoConfig& config);
     virtual ~NeMoCacheAwareConformer();
 
@@ -56,11 +83,22 @@ public:
     ModelInterface::TranscriptionResult processChunk(const std::vector<std::vector<float>>& features,
                                                     uint64_t timestamp_ms) override;
     void reset() override;
+    ModelInterface::TranscriptionResult finalize(uint64_t timestamp_ms) override;
     std::map<std::string, double> getStats() const override;
     bool supportsStreaming() const override { return true; }
     int getFeatureDim() const override { return config_.feature_dim; }
     int getChunkFrames() const override { return config_.chunk_frames; }
     const ModelConfig& getConfig() const override { return model_config_; }
+    bool setMetrics(PipelineMetrics* metrics) override { metrics_ = metrics; return true; }
+    
+    /** New stream state for an initialized model */
+    std::unique_ptr<DecodeState> createDecodeState() const;
+    
+    ModelInterface::TranscriptionResult processChunk(DecodeState& state,
+                                                    const std::vector<std::vector<float>>& features,
+                                                    uint64_t timestamp_ms);
+    ModelInterface::TranscriptionResult finalize(DecodeState& state, uint64_t timestamp_ms) const;
+    void resetState(DecodeState& state) const;
 
 private:
     NeMoConfig config_;
@@ -78,28 +116,32 @@ private:
     std::vector<const char*> input_names_;
     std::vector<const char*> output_names_;
     
-    // Cache tensors for streaming
-    std::vector<float> cache_last_channel_;
-    std::vector<float> cache_last_time_;
-    bool cache_initialized_;
+    // Whether the session takes cache tensors besides the features
+    bool uses_cache_inputs_ = false;
+    
+    // Statistics (atomic: streams may be decoded concurrently)
+    mutable std::atomic<uint64_t> total_chunks_processed_;
+    mutable std::atomic<uint64_t> total_processing_time_ms_;
+    mutable std::atomic<uint64_t> cache_updates_;
+    PipelineMetrics* metrics_ = nullptr;
     
-    // Statistics
-    mutable uint64_t total_chunks_processed_;
-    mutable uint64_t total_processing_time_ms_;
-    mutable uint64_t cache_updates_;
+    // Vocabulary for token decoding (null if not loaded)
+    std::shared_ptr<const TokenVocabulary> vocab_;
     
-    // Vocabulary for token decoding
-    std::vector<std::string> vocabulary_;
-    bool vocab_loaded_;
+    // State used through the ModelInterface methods
+    DecodeState default_state_;
     
     // Private methods
     bool initializeONNXSession();
-    bool initializeCacheTensors();
+    bool initializeCacheTensors(DecodeState& state) const;
     bool loadVocabulary(const std::string& vocab_path);
     std::vector<Ort::Value> prepareCacheInputs();
-    void updateCacheFromOutputs(std::vector<Ort::Value>& outputs);
+    void updateCacheFromOutputs(DecodeState& state, std::vector<Ort::Value>& outputs);
     std::string decodeTokens(const float* logits, size_t logits_size);
-    std::string decodeCTCTokens(const float* log_probs, int64_t seq_len, int64_t num_classes);
+    std::vector<int> decodeCTCTokens(const float* log_probs, int64_t seq_len, int64_t num_classes,
+                                     std::vector<int>& frames, std::vector<float>& peak_log_probs);
+    std::string tokensToText(const std::vector<int>& tokens) const;
+    PartialResultTracker::Config trackerConfig() const;
     void updateStats(uint64_t processing_time_ms) const;
 };
 
@@ -6,6 +6,7 @@
 #include "onnx_wrapper.hpp"
 #include "ModelInterface.hpp"
 #include "FeatureExtractor.hpp"
+#include "LatencyGovernor.hpp"
 
 namespace onnx_stt {
 
@@ -32,6 +33,11 @@ public:
         MEDIUM = 33       // 1040ms latency
     };
     
+    /**
+     * @brief LatencyGovernor levels: ULTRA_LOW..MEDIUM in order of chunk size
+     */
+    static constexpr int NUM_LATENCY_LEVELS = 4;
+    
     /**
      * @brief Decoder type selection
      */
@@ -83,6 +89,12 @@ private:
     int context_frames_;       // Look-ahead frames for attention
     float confidence_threshold_ = 0.3f;
     
+    // Adaptive latency: lag behind real time drives the governor
+    std::shared_ptr<LatencyGovernor> governor_;
+    std::string governor_key_;
+    double lag_ms_ = 0.0;              // processing time beyond audio time, floored at 0
+    uint64_t latency_mode_changes_ = 0;
+    
     // Model configuration
     ModelConfig config_;
     
@@ -100,7 +112,7 @@ public:
     /**
      * @brief Destructor
      */
-    ~NeMoCacheAwareStreaming() override = default;
+    ~NeMoCacheAwareStreaming() override;
     
     /**
      * @brief Initialize the model with configuration
@@ -156,6 +168,26 @@ public:
      */
     void setLatencyMode(LatencyMode mode);
     
+    LatencyMode getLatencyMode() const { return latency_mode_; }
+    
+    /**
+     * @brief Let a governor switch the latency mode as the stream lags
+     *
+     * After each chunk the stream reports its lag behind real time and
+     * takes the mode for the level the governor returns, so callers must
+     * size the next chunk from getChunkFrames().
+     * @param governor Shared by the streams it balances; null detaches
+     * @param stream_key This stream's key in the governor
+     */
+    void setLatencyGovernor(std::shared_ptr<LatencyGovernor> governor,
+                            const std::string& stream_key);
+    
+    /**
+     * @brief Map a governor level to a mode (clamped to MEDIUM) and back
+     */
+    static LatencyMode latencyModeForLevel(int level);
+    static int levelForLatencyMode(LatencyMode mode);
+    
     /**
      * @brief Set decoder type
      * @param type Decoder type to use
@@ -190,6 +222,11 @@ private:
      */
     void configureLatencyMode();
     
+    /**
+     * @brief Account a processed chunk in the lag and apply the governor's level
+     */
+    void updateLatencyGovernor(double processing_ms, int num_samples);
+    
     /**
      * @brief Extract mel-spectrogram features from audio
      */
@@ -1,4 +1,6 @@
 #include "NeMoSTTImpl.hpp"
+#include "NeMoCTCModel.hpp"
+#include "PolyphaseResampler.hpp"
 #include <iostream>
 #include <sstream>
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
@@ -6,12 +8,39 @@
 
 namespace com::teracloud::streams::stt {
 
+namespace {
+
+// Holds the GIL for the current scope, from whichever thread calls in
+class GilLock {
+public:
+    GilLock() : state_(PyGILState_Ensure()) {}
+    ~GilLock() { PyGILState_Release(state_); }
+    GilLock(const GilLock&) = delete;
+    GilLock& operator=(const GilLock&) = delete;
+private:
+    PyGILState_STATE state_;
+};
+
+// The exported CTC model, like NeMo's preprocessor, works on 16 kHz audio
+const int kModelSampleRate = 16000;
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // anonymous namespace
+
 bool NeMoSTTImpl::pythonInitialized_ = false;
 int NeMoSTTImpl::instanceCount_ = 0;
+PyThreadState* NeMoSTTImpl::mainThreadState_ = nullptr;
 
 NeMoSTTImpl::NeMoSTTImpl() 
-    : pModule_(nullptr), pModel_(nullptr), pTranscribeFunc_(nullptr), initialized_(false) {
-    
+    : pModule_(nullptr), pModel_(nullptr), pTranscribeFunc_(nullptr), initialized_(false),
+      backend_(Backend::AUTO), usesPython_(false) {
+}
+
+void NeMoSTTImpl::acquirePython() {
     // Initialize Python if not already done
     if (!pythonInitialized_) {
         Py_Initialize();
@@ -25,6 +54,8 @@ NeMoSTTImpl::NeMoSTTImpl()
         PyList_Append(sysPath, currentDir);
         Py_DECREF(currentDir);
         
+        // Release the GIL so transcribe() can run on a worker thread
+        mainThreadState_ = PyEval_SaveThread();
         pythonInitialized_ = true;
     }
     
@@ -32,22 +63,75 @@ NeMoSTTImpl::NeMoSTTImpl()
 }
 
 NeMoSTTImpl::~NeMoSTTImpl() {
+    if (!usesPython_) {
+        return;
+    }
+    
     // Clean up Python objects
-    Py_XDECREF(pTranscribeFunc_);
-    Py_XDECREF(pModel_);
-    Py_XDECREF(pModule_);
+    {
+        GilLock gil;
+        Py_XDECREF(pTranscribeFunc_);
+        Py_XDECREF(pModel_);
+        Py_XDECREF(pModule_);
+    }
     
     instanceCount_--;
     
     // Finalize Python if this was the last instance
     if (instanceCount_ == 0 && pythonInitialized_) {
+        PyEval_RestoreThread(mainThreadState_);
+        mainThreadState_ = nullptr;
         Py_Finalize();
         pythonInitialized_ = false;
     }
 }
 
-bool NeMoSTTImpl::initialize(const std::string& modelPath) {
+bool NeMoSTTImpl::initialize(const std::string& modelPath, Backend backend) {
     modelPath_ = modelPath;
+    if (backend == Backend::AUTO) {
+        backend = endsWith(modelPath, ".onnx") ? Backend::NATIVE : Backend::PYTHON;
+    }
+    backend_ = backend;
+    
+    return backend_ == Backend::NATIVE ? initializeNative(modelPath) : initializePython(modelPath);
+}
+
+bool NeMoSTTImpl::initializeNative(const std::string& modelPath) {
+    onnx_stt::NeMoCTCModel::Config config;
+    config.model_path = modelPath;
+    config.vocab_path = vocabPath_;
+    if (config.vocab_path.empty()) {
+        size_t slash = modelPath.find_last_of('/');
+        config.vocab_path = (slash == std::string::npos ? std::string() : modelPath.substr(0, slash + 1)) +
+                            "tokens.txt";
+    }
+    config.sample_rate = kModelSampleRate;
+    // NeMo only dithers while training; keep inference deterministic
+    config.dither = 0.0f;
+    
+    try {
+        ctcModel_.reset(new onnx_stt::NeMoCTCModel(config));
+        if (!ctcModel_->initialize()) {
+            ctcModel_.reset();
+            setError("Failed to load ONNX CTC model " + modelPath);
+            return false;
+        }
+    } catch (const std::exception& e) {
+        ctcModel_.reset();
+        setError(std::string("Failed to load ONNX CTC model: ") + e.what());
+        return false;
+    }
+    
+    initialized_ = true;
+    return true;
+}
+
+bool NeMoSTTImpl::initializePython(const std::string& modelPath) {
+    if (!usesPython_) {
+        acquirePython();
+        usesPython_ = true;
+    }
+    GilLock gil;
     
     // Create Python code to load NeMo model
     std::string pythonCode = R"(
@@ -164,6 +248,32 @@ std::string NeMoSTTImpl::transcribe(const std::vector<float>& audioData, int sam
     if (!initialized_) {
         return "Error: Model not initialized";
     }
+    return backend_ == Backend::NATIVE ? transcribeNative(audioData, sampleRate)
+                                       : transcribePython(audioData, sampleRate);
+}
+
+std::string NeMoSTTImpl::transcribeNative(const std::vector<float>& audioData, int sampleRate) {
+    // Same input handling as transcribe_audio(): resample to 16 kHz first
+    std::vector<float> resampled;
+    const std::vector<float>* audio = &audioData;
+    if (sampleRate != kModelSampleRate) {
+        resampled = onnx_stt::PolyphaseResampler::resample(audioData.data(), audioData.size(),
+                                                           sampleRate, kModelSampleRate,
+                                                           onnx_stt::PolyphaseResampler::HIGH);
+        audio = &resampled;
+    }
+    
+    try {
+        std::lock_guard<std::mutex> lock(nativeMutex_);
+        return ctcModel_->processAudio(*audio).text;
+    } catch (const std::exception& e) {
+        setError(e.what());
+        return std::string("Error: ") + e.what();
+    }
+}
+
+std::string NeMoSTTImpl::transcribePython(const std::vector<float>& audioData, int sampleRate) {
+    GilLock gil;
     
     // Convert audio data to NumPy array
     npy_intp dims[1] = {static_cast<npy_intp>(audioData.size())};
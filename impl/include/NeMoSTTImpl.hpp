@@ -3,22 +3,50 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <Python.h>
 
+// Native backend, kept out of this header so ONNX Runtime headers stay private
+namespace onnx_stt {
+    class NeMoCTCModel;
+}
+
 namespace com::teracloud::streams::stt {
 
 class NeMoSTTImpl {
 public:
+    /**
+     * How transcribe() runs the model
+     *
+     * PYTHON loads a .nemo checkpoint into an embedded interpreter and
+     * calls model.transcribe() through a temporary WAV file. NATIVE runs the
+     * exported ONNX CTC model in process through onnx_stt::NeMoCTCModel,
+     * with no Python, GIL or file round trip. AUTO picks NATIVE for a model
+     * path ending in .onnx, so the model path alone selects the backend.
+     */
+    enum class Backend {
+        AUTO,
+        PYTHON,
+        NATIVE
+    };
+    
     NeMoSTTImpl();
     ~NeMoSTTImpl();
     
     // Initialize the NeMo model
-    bool initialize(const std::string& modelPath);
+    bool initialize(const std::string& modelPath, Backend backend = Backend::AUTO);
     
-    // Process audio data and return transcription
+    // Process audio data and return transcription; callable from any thread
     std::string transcribe(const std::vector<float>& audioData, int sampleRate);
     
+    // Native backend: tokens file, default tokens.txt next to the model.
+    // Takes effect in initialize()
+    void setVocabPath(const std::string& path) { vocabPath_ = path; }
+    
+    // Backend in use after initialize()
+    Backend getBackend() const { return backend_; }
+    
     // Get the last error message
     std::string getLastError() const { return lastError_; }
     
@@ -27,12 +55,26 @@ private:
     PyObject* pModel_;
     PyObject* pTranscribeFunc_;
     std::string modelPath_;
+    std::string vocabPath_;
     std::string lastError_;
     bool initialized_;
+    Backend backend_;
+    bool usesPython_;                 // this instance holds Python objects
+    
+    // Native backend; NeMoCTCModel is not thread-safe
+    std::unique_ptr<onnx_stt::NeMoCTCModel> ctcModel_;
+    std::mutex nativeMutex_;
     
     // Python environment management
     static bool pythonInitialized_;
     static int instanceCount_;
+    static PyThreadState* mainThreadState_;  // saved while other threads hold the GIL
+    
+    bool initializePython(const std::string& modelPath);
+    bool initializeNative(const std::string& modelPath);
+    std::string transcribePython(const std::vector<float>& audioData, int sampleRate);
+    std::string transcribeNative(const std::vector<float>& audioData, int sampleRate);
+    static void acquirePython();
     
     // Helper to set error message
     void setError(const std::string& error);
@@ -1,6 +1,8 @@
 #include "NeMoSTTWrapper.hpp"
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <vector>
 
 namespace com::teracloud::streams::stt {
 
@@ -8,20 +10,40 @@ NeMoSTTWrapper::NeMoSTTWrapper()
     : sampleRate_(16000),
       chunkDurationMs_(5000),  // 5 seconds default
       minSpeechDurationMs_(500), // 0.5 seconds minimum
+      queueCapacityMs_(10000),  // 10 seconds of audio between tuple thread and worker
+      overflowPolicy_(OverflowPolicy::DROP_OLDEST),
+      backend_(NeMoSTTImpl::Backend::AUTO),
+      stop_(false),
+      resetGeneration_(0),
+      transcriptions_(0),
       initialized_(false) {
     impl_ = std::make_unique<NeMoSTTImpl>();
 }
 
-NeMoSTTWrapper::~NeMoSTTWrapper() = default;
+NeMoSTTWrapper::~NeMoSTTWrapper() {
+    if (worker_.joinable()) {
+        stop_ = true;
+        audioRing_->close();  // release a producer blocked on a full ring
+        wake_.notify_one();
+        worker_.join();
+    }
+}
 
 bool NeMoSTTWrapper::initialize(const std::string& modelPath) {
-    if (!impl_->initialize(modelPath)) {
+    if (initialized_) {
+        return true;
+    }
+
+    if (!impl_->initialize(modelPath, backend_)) {
         std::cerr << "Failed to initialize NeMo model: " << impl_->getLastError() << std::endl;
         return false;
     }
-    
+
+    size_t capacity = static_cast<size_t>(sampleRate_) * std::max(queueCapacityMs_, 1) / 1000;
+    audioRing_ = std::make_unique<AudioRing>(capacity, overflowPolicy_);
+    worker_ = std::thread(&NeMoSTTWrapper::workerLoop, this);
+
     initialized_ = true;
-    samplesPerChunk_ = (sampleRate_ * chunkDurationMs_) / 1000;
     return true;
 }
 
@@ -29,57 +51,110 @@ void NeMoSTTWrapper::processAudioChunk(const float* data, size_t samples, int sa
     if (!initialized_) {
         return;
     }
-    
-    std::lock_guard<std::mutex> lock(bufferMutex_);
-    
+
     // If sample rate differs, we'll need to resample
     // For now, we'll just store and let NeMo handle resampling
     sampleRate_ = sampleRate;
-    samplesPerChunk_ = (sampleRate_ * chunkDurationMs_) / 1000;
-    
-    // Add samples to buffer
-    audioBuffer_.insert(audioBuffer_.end(), data, data + samples);
+
+    audioRing_->push(data, samples);
+    wake_.notify_one();
 }
 
 bool NeMoSTTWrapper::getTranscription(std::string& transcription) {
     if (!initialized_) {
         return false;
     }
-    
-    std::lock_guard<std::mutex> lock(bufferMutex_);
-    
-    // Check if we have enough samples
-    size_t minSamples = (sampleRate_ * minSpeechDurationMs_) / 1000;
-    if (audioBuffer_.size() < minSamples) {
-        return false;
-    }
-    
-    // Process up to chunk size
-    size_t samplesToProcess = std::min(audioBuffer_.size(), samplesPerChunk_);
-    
-    // Copy samples to vector
-    std::vector<float> audioData(audioBuffer_.begin(), 
-                                  audioBuffer_.begin() + samplesToProcess);
-    
-    // Remove processed samples from buffer
-    audioBuffer_.erase(audioBuffer_.begin(), 
-                       audioBuffer_.begin() + samplesToProcess);
-    
-    // Transcribe
-    transcription = impl_->transcribe(audioData, sampleRate_);
-    
-    // Check if it's an error
-    if (transcription.find("Error:") == 0) {
-        std::cerr << "Transcription error: " << transcription << std::endl;
+
+    std::lock_guard<std::mutex> lock(resultsMutex_);
+    if (results_.empty()) {
         return false;
     }
-    
-    return !transcription.empty();
+    transcription = std::move(results_.front());
+    results_.pop_front();
+    return true;
 }
 
 void NeMoSTTWrapper::reset() {
-    std::lock_guard<std::mutex> lock(bufferMutex_);
-    audioBuffer_.clear();
+    // The worker owns the consumer side of the ring; it clears the ring and
+    // its pending audio when it sees the new generation
+    ++resetGeneration_;
+    wake_.notify_one();
+
+    std::lock_guard<std::mutex> lock(resultsMutex_);
+    results_.clear();
+}
+
+NeMoSTTWrapper::Stats NeMoSTTWrapper::getStats() const {
+    Stats stats;
+    if (audioRing_) {
+        AudioRing::Stats ring = audioRing_->getStats();
+        stats.samples_enqueued = ring.pushed;
+        stats.samples_dropped = ring.dropped;
+        stats.producer_waits = ring.waits;
+        stats.queue_high_water = ring.high_water;
+    }
+    stats.transcriptions = transcriptions_;
+    return stats;
+}
+
+void NeMoSTTWrapper::workerLoop() {
+    std::vector<float> pending;   // drained from the ring, not yet transcribed
+    std::vector<float> scratch(4096);
+    uint64_t generation = resetGeneration_;
+
+    while (!stop_) {
+        if (resetGeneration_ != generation) {
+            generation = resetGeneration_;
+            audioRing_->clear();
+            pending.clear();
+        }
+
+        const int sampleRate = sampleRate_;
+        const size_t samplesPerChunk = static_cast<size_t>(sampleRate) * chunkDurationMs_ / 1000;
+        const size_t minSamples = static_cast<size_t>(sampleRate) * minSpeechDurationMs_ / 1000;
+
+        // Drain what is queued, up to one chunk
+        while (pending.size() < samplesPerChunk) {
+            size_t n = audioRing_->pop(scratch.data(),
+                                       std::min(scratch.size(), samplesPerChunk - pending.size()));
+            if (n == 0) {
+                break;
+            }
+            pending.insert(pending.end(), scratch.begin(), scratch.begin() + n);
+        }
+
+        // Check if we have enough samples
+        if (pending.empty() || pending.size() < minSamples) {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            // Producers notify without the lock, so also wake periodically
+            wake_.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        // Process up to chunk size
+        size_t samplesToProcess = std::min(pending.size(), samplesPerChunk);
+        std::vector<float> audioData(pending.begin(), pending.begin() + samplesToProcess);
+        pending.erase(pending.begin(), pending.begin() + samplesToProcess);
+
+        // Transcribe
+        std::string transcription = impl_->transcribe(audioData, sampleRate);
+        ++transcriptions_;
+
+        if (resetGeneration_ != generation) {
+            continue;  // audio from before reset()
+        }
+
+        // Check if it's an error
+        if (transcription.find("Error:") == 0) {
+            std::cerr << "Transcription error: " << transcription << std::endl;
+            continue;
+        }
+
+        if (!transcription.empty()) {
+            std::lock_guard<std::mutex> lock(resultsMutex_);
+            results_.push_back(std::move(transcription));
+        }
+    }
 }
 
-} // namespace com::teracloud::streams::stt
\ No newline at end of file
+} // namespace com::teracloud::streams::stt
@@ -2,46 +2,95 @@
 #define NEMO_STT_WRAPPER_HPP
 
 #include "NeMoSTTImpl.hpp"
-#include <memory>
+#include "SpscRingBuffer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 namespace com::teracloud::streams::stt {
 
+/**
+ * Feeds audio from the SPL tuple thread to NeMo on a worker thread
+ *
+ * processAudioChunk() only copies samples into a lock-free SPSC ring and
+ * returns; a dedicated worker drains the ring, runs inference and queues
+ * transcriptions for getTranscription(). Tuple ingest latency is therefore
+ * independent of model latency. When the worker falls behind the ring
+ * either drops the oldest audio or blocks the caller, see
+ * setOverflowPolicy().
+ */
 class NeMoSTTWrapper {
 public:
+    using AudioRing = onnx_stt::SpscRingBuffer<float>;
+    using OverflowPolicy = AudioRing::OverflowPolicy;
+
+    struct Stats {
+        uint64_t samples_enqueued = 0;   // accepted into the ring
+        uint64_t samples_dropped = 0;    // discarded on overflow
+        uint64_t producer_waits = 0;     // enqueues that blocked (BLOCK policy)
+        size_t queue_high_water = 0;     // most samples waiting in the ring
+        uint64_t transcriptions = 0;     // inference calls made by the worker
+    };
+
     NeMoSTTWrapper();
     ~NeMoSTTWrapper();
     
-    // Initialize with model path
+    // Initialize with model path and start the worker
     bool initialize(const std::string& modelPath);
     
-    // Process audio chunk
+    // Enqueue an audio chunk (producer thread; never waits on inference)
     void processAudioChunk(const float* data, size_t samples, int sampleRate);
     
     // Get transcription if available
     bool getTranscription(std::string& transcription);
     
-    // Reset the buffer
+    // Drop queued audio and pending transcriptions
     void reset();
     
     // Set parameters
     void setChunkDurationMs(int ms) { chunkDurationMs_ = ms; }
     void setMinSpeechDurationMs(int ms) { minSpeechDurationMs_ = ms; }
+    // Ring size and overflow behaviour; take effect in initialize()
+    void setQueueCapacityMs(int ms) { queueCapacityMs_ = ms; }
+    void setOverflowPolicy(OverflowPolicy policy) { overflowPolicy_ = policy; }
+    // Inference backend and CTC vocabulary; take effect in initialize()
+    void setBackend(NeMoSTTImpl::Backend backend) { backend_ = backend; }
+    void setVocabPath(const std::string& path) { impl_->setVocabPath(path); }
+    
+    Stats getStats() const;
     
 private:
     std::unique_ptr<NeMoSTTImpl> impl_;
-    std::deque<float> audioBuffer_;
-    std::mutex bufferMutex_;
+    std::unique_ptr<AudioRing> audioRing_;
+    
+    std::atomic<int> sampleRate_;
+    std::atomic<int> chunkDurationMs_;
+    std::atomic<int> minSpeechDurationMs_;
+    int queueCapacityMs_;
+    OverflowPolicy overflowPolicy_;
+    NeMoSTTImpl::Backend backend_;
     
-    int sampleRate_;
-    int chunkDurationMs_;
-    int minSpeechDurationMs_;
-    size_t samplesPerChunk_;
+    // Worker state
+    std::thread worker_;
+    std::atomic<bool> stop_;
+    std::atomic<uint64_t> resetGeneration_;
+    std::atomic<uint64_t> transcriptions_;
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    
+    // Finished transcriptions, produced by the worker
+    std::deque<std::string> results_;
+    mutable std::mutex resultsMutex_;
     
     bool initialized_;
+    
+    void workerLoop();
 };
 
 } // namespace com::teracloud::streams::stt
 
-#endif // NEMO_STT_WRAPPER_HPP
\ No newline at end of file
+#endif // NEMO_STT_WRAPPER_HPP
@@ -0,0 +1,149 @@
+#ifndef NGRAM_LM_HPP
+#define NGRAM_LM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * Token-level back-off n-gram language model for shallow fusion
+ *
+ * The model lives in a read-only memory-mapped binary file, so every stream
+ * (and every process) decoding with the same LM shares one physical copy.
+ * The file is a sorted-array trie:
+ *
+ *   level 1        dense array indexed by token id
+ *   level 2..N-1   nodes sorted by (parent, token); the children of a node
+ *                  are the range [child_begin[i], child_begin[i+1])
+ *   level N        leaves sorted the same way
+ *
+ * Probabilities and back-off weights are quantized to 8 bits with a
+ * per-level 256-entry codebook and are stored as natural logs so they can
+ * be added directly to acoustic log-probabilities.
+ *
+ * A decoding state is a 32-bit integer (level in the top 4 bits, node index
+ * in the rest), so hypotheses carry it by value.
+ *
+ * Use convertArpa() (or the arpa2lm tool) to build the binary file from an
+ * ARPA model whose words are the acoustic model's BPE tokens.
+ */
+class NgramLM {
+public:
+    using State = uint32_t;
+
+    static constexpr int kMaxOrder = 8;
+
+    ~NgramLM();
+
+    NgramLM(const NgramLM&) = delete;
+    NgramLM& operator=(const NgramLM&) = delete;
+
+    /**
+     * Map a binary LM file. Returns a shared instance when the same path is
+     * already mapped in this process, nullptr on failure.
+     */
+    static std::shared_ptr<const NgramLM> load(const std::string& path);
+
+    /**
+     * Convert an ARPA file to the binary format. Words are mapped to ids
+     * with the tokens file ("token" or "token id" per line); n-grams that
+     * contain unknown words are dropped. Returns false on failure.
+     */
+    static bool convertArpa(const std::string& arpa_path,
+                            const std::string& tokens_path,
+                            const std::string& output_path);
+
+    /** State after <s> (empty history if the LM has no <s>) */
+    State beginState() const { return begin_state_; }
+
+    /** Empty-history state */
+    static State nullState() { return 0; }
+
+    /**
+     * Log-probability of @p token after @p state; the successor state is
+     * written to @p next. Tokens outside the vocabulary score unk.
+     */
+    float score(State state, int token, State* next) const;
+
+    /** Log-probability of </s> after @p state (0 if the LM has no </s>) */
+    float scoreEnd(State state) const;
+
+    int order() const { return order_; }
+    int vocabSize() const { return vocab_size_; }
+    size_t sizeBytes() const { return map_size_; }
+
+private:
+    struct Header;
+    struct Node;
+    struct Leaf;
+
+    NgramLM() = default;
+    bool map(const std::string& path);
+
+    static int levelOf(State s) { return static_cast<int>(s >> 28); }
+    static uint32_t indexOf(State s) { return s & 0x0FFFFFFFu; }
+    static State makeState(int level, uint32_t index) {
+        return (static_cast<uint32_t>(level) << 28) | index;
+    }
+
+    // Returns the index of @p token among the children of node @p parent
+    // at @p level (1..order-1), or -1.
+    int64_t findChild(int level, uint32_t parent, uint32_t token) const;
+
+    void* map_base_ = nullptr;
+    size_t map_size_ = 0;
+
+    const Header* header_ = nullptr;
+    const Node* nodes_[kMaxOrder + 1] = {};
+    const Leaf* leaves_ = nullptr;
+    const float* prob_codebook_ = nullptr;     // [order][256]
+    const float* backoff_codebook_ = nullptr;  // [order][256]
+
+    int order_ = 0;
+    int vocab_size_ = 0;
+    int eos_id_ = -1;
+    float unk_logprob_ = -10.0f;
+    State begin_state_ = 0;
+};
+
+/**
+ * Direct-mapped memo of (state, token) -> (score, next state)
+ *
+ * Beam hypotheses share most of their histories, so the same LM queries
+ * repeat across hypotheses and frames. One cache per decoder; not
+ * thread-safe.
+ */
+class NgramLMStateCache {
+public:
+    explicit NgramLMStateCache(std::shared_ptr<const NgramLM> lm,
+                               size_t num_entries = 1 << 14);
+
+    float score(NgramLM::State state, int token, NgramLM::State* next);
+
+    void clear();
+
+    const NgramLM& lm() const { return *lm_; }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    struct Entry {
+        uint64_t key = ~0ull;
+        float score = 0.0f;
+        NgramLM::State next = 0;
+    };
+
+    std::shared_ptr<const NgramLM> lm_;
+    std::vector<Entry> entries_;
+    size_t mask_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+} // namespace onnx_stt
+
+#endif // NGRAM_LM_HPP
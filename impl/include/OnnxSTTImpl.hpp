@@ -8,8 +8,13 @@
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <unordered_map>
+#include <utility>
 #include "NeMoCacheAwareConformer.hpp"
 #include "ImprovedFbank.hpp"
+#include "Endpointer.hpp"
+#include "StreamingBuffer.hpp"
+#include "LatencyHistogram.hpp"
 // REMOVED: #include "simple_fbank.hpp" - generates FAKE data, NEVER use!
 
 // Forward declaration to avoid circular dependency
@@ -22,6 +27,15 @@ namespace onnx_stt {
 /**
  * ONNX-based Speech-to-Text implementation
  * Uses ZipformerRNNT for three-model pipeline with streaming support
+ *
+ * The loaded model, feature extractor and endpointer are shared; audio
+ * buffers and decoder state are kept per stream. The single-stream methods
+ * use a built-in stream, the keyed methods a map of streams that is bounded
+ * by max_streams and pruned by closeStream()/evictIdleStreams().
+ *
+ * The keyed methods may run concurrently for different keys, as long as
+ * calls for one key do not overlap (e.g. one serial queue per key);
+ * evictIdleStreams() must not overlap any of them.
  */
 class OnnxSTTImpl {
 public:
@@ -54,14 +68,33 @@ public:
         // Performance tuning
         int num_threads = 4;
         bool use_gpu = false;
+        
+        // Endpointing: finalize and reset the streaming model when the
+        // decoder output matches an endpoint rule
+        bool enable_endpointing = true;
+        Endpointer::Config endpoint_config;
+        
+        // Keyed streams: limit on concurrently open streams (0 = unlimited)
+        size_t max_streams = 1000;
     };
     
+    using StreamKey = std::string;
+    
     struct TranscriptionResult {
         std::string text;
         bool is_final;
         double confidence;
         uint64_t timestamp_ms;
         uint64_t latency_ms;
+        
+        // Incremental output: text committed since the previous result and
+        // the uncommitted tail; offsets are bytes into the utterance text
+        std::string stable_text;
+        std::string unstable_text;
+        uint64_t stable_offset = 0;
+        std::vector<uint32_t> word_offsets;
+        std::vector<uint32_t> word_start_ms;  // parallel to word_offsets
+        std::vector<uint32_t> word_end_ms;
     };
     
     explicit OnnxSTTImpl(const Config& config);
@@ -70,7 +103,8 @@ public:
     // Initialize ONNX runtime and load models
     bool initialize();
     
-    // Process audio chunk
+    // Process audio chunk; samples are converted straight into the stream
+    // buffer and not referenced after return
     TranscriptionResult processAudioChunk(const int16_t* samples, 
                                          size_t num_samples, 
                                          uint64_t timestamp_ms);
@@ -78,32 +112,113 @@ public:
     // Reset decoder state
     void reset();
     
+    /**
+     * Process audio for a keyed stream, opening it on first use
+     * @param trace Stream and chunk to trace this chunk under, e.g. the tag
+     *        its queue span used; by default the stream numbers its own
+     * @return false if the stream is new and max_streams are already open;
+     *         the audio is dropped
+     */
+    bool processStreamChunk(const StreamKey& key,
+                            const int16_t* samples,
+                            size_t num_samples,
+                            uint64_t timestamp_ms,
+                            TranscriptionResult& result,
+                            TraceTag trace = TraceTag());
+    
+    /**
+     * Close a keyed stream, decoding what it still buffers
+     * @param idle_ms Only close it if it received no audio for this long
+     * @return false if no such stream is open (or it is not idle)
+     */
+    bool closeStream(const StreamKey& key, TranscriptionResult& final_result,
+                     uint64_t idle_ms = 0);
+    
+    /** Keys of the streams that received no audio for idle_ms */
+    size_t idleStreams(uint64_t idle_ms, std::vector<StreamKey>& keys) const;
+    
+    /**
+     * Close every keyed stream that received no audio for idle_ms
+     * (0 closes all) and collect their final results
+     * @return Number of streams closed
+     */
+    size_t evictIdleStreams(uint64_t idle_ms,
+                            std::vector<std::pair<StreamKey, TranscriptionResult>>& finals);
+    
+    size_t activeStreams() const;
+    
     // Get performance stats
     struct Stats {
-        uint64_t total_audio_ms = 0;
-        uint64_t total_processing_ms = 0;
+        uint64_t total_audio_ms = 0;      // from sample counts
+        uint64_t total_processing_ms = 0; // sum of the stage latencies
         double real_time_factor = 0.0;
+        
+        // Keyed streams
+        uint64_t active_streams = 0;
+        uint64_t streams_opened = 0;
+        uint64_t streams_evicted = 0;     // closed by evictIdleStreams()
+        uint64_t streams_rejected = 0;    // chunks dropped at max_streams
+        uint64_t buffer_grows = 0;        // chunk rings enlarged for a large tuple
     };
-    Stats getStats() const { return stats_; }
+    Stats getStats() const;
+    
+    /**
+     * Per-stage latency histograms shared by all streams; callers may
+     * record their own stages (e.g. SUBMIT) into it
+     */
+    PipelineMetrics& getMetrics() { return metrics_; }
     
 private:
+    /**
+     * Everything that belongs to one audio stream
+     */
+    struct StreamState {
+        std::vector<float> audio_buffer;                // CTC: whole utterance
+        std::unique_ptr<StreamingBuffer> chunk_buffer;  // cache-aware: fixed-size chunks, from first audio
+        std::unique_ptr<NeMoCacheAwareConformer::DecodeState> decode;
+        uint64_t last_timestamp_ms = 0;
+        std::chrono::steady_clock::time_point last_active;
+        uint64_t trace_id = Tracer::instance().newStreamId();
+        uint64_t chunks = 0;                            // processed, numbers trace spans
+    };
+    
     Config config_;
     
     // Model components (one of these will be used based on config)
     std::unique_ptr<NeMoCacheAwareConformer> nemo_cache_model_;
     std::unique_ptr<NeMoCTCModel> nemo_ctc_model_;
     std::unique_ptr<improved_fbank::FbankComputer> fbank_computer_;
+    Endpointer endpointer_;
     // REMOVED: simple_fbank::FbankComputer - generates FAKE data!
     
-    // Audio buffering for streaming
-    std::vector<float> audio_buffer_;
-    std::vector<float> feature_buffer_;
+    // Stream used by the single-stream methods
+    std::unique_ptr<StreamState> default_stream_;
+    
+    // Keyed streams
+    mutable std::mutex streams_mutex_;   // guards the map, not the streams
+    std::unordered_map<StreamKey, std::unique_ptr<StreamState>> streams_;
+    
+    // NeMoCTCModel keeps dither and beam search state: one call at a time
+    std::mutex ctc_mutex_;
     
     // Performance tracking
-    mutable Stats stats_;
+    mutable std::mutex stats_mutex_;
+    Stats stats_;
+    PipelineMetrics metrics_;
     std::chrono::steady_clock::time_point last_process_time_;
     
     // Internal methods
+    std::unique_ptr<StreamState> createStream() const;
+    TranscriptionResult processAudio(StreamState& stream,
+                                     const int16_t* samples,
+                                     size_t num_samples,
+                                     uint64_t timestamp_ms);
+    TranscriptionResult finalizeStream(StreamState& stream);
+    bool isIdle(const StreamState& stream, uint64_t idle_ms,
+                std::chrono::steady_clock::time_point now) const;
+    void resetStream(StreamState& stream) const;
+    size_t samplesPerChunk() const;
+    size_t ringSamples() const;
     std::vector<float> extractFeatures(const std::vector<float>& audio);
     bool setupNeMoModel();
 };
@@ -5,6 +5,10 @@
 #include <vector>
 #include <memory>
 #include <cstdint>
+#include <utility>
+#include "Endpointer.hpp"
+#include "LatencyHistogram.hpp"
+#include "Tracer.hpp"
 
 namespace onnx_stt {
 
@@ -33,30 +37,82 @@ public:
         int num_threads = 4;
         bool use_gpu = false;
         ModelType model_type = ModelType::CACHE_AWARE_CONFORMER;
+        
+        // Decoder-driven endpointing (streaming models)
+        bool enable_endpointing = true;
+        Endpointer::Config endpoint_config;
+        
+        // Keyed streams: limit on concurrently open streams (0 = unlimited)
+        size_t max_streams = 1000;
     };
     
+    // Application-defined stream ID, e.g. call ID plus channel number
+    using StreamKey = std::string;
+    
     struct TranscriptionResult {
         std::string text;
         bool is_final;
         double confidence;
         uint64_t timestamp_ms;
         uint64_t latency_ms;
+        
+        // Incremental output: text committed since the previous result and
+        // the uncommitted tail; offsets are bytes into the utterance text
+        std::string stable_text;
+        std::string unstable_text;
+        uint64_t stable_offset = 0;
+        std::vector<uint32_t> word_offsets;
+        std::vector<uint32_t> word_start_ms;  // parallel to word_offsets
+        std::vector<uint32_t> word_end_ms;
     };
     
     struct Stats {
         uint64_t total_audio_ms = 0;
         uint64_t total_processing_ms = 0;
         double real_time_factor = 0.0;
+        
+        // Keyed streams
+        uint64_t active_streams = 0;
+        uint64_t streams_opened = 0;
+        uint64_t streams_evicted = 0;
+        uint64_t streams_rejected = 0;
+        uint64_t buffer_grows = 0;
     };
     
     virtual ~OnnxSTTInterface() = default;
     
     virtual bool initialize() = 0;
+    // PCM is read in place (e.g. straight from a blob) and converted once,
+    // into the stream's buffer; the caller keeps ownership after return
     virtual TranscriptionResult processAudioChunk(const int16_t* samples, 
                                                  size_t num_samples, 
                                                  uint64_t timestamp_ms) = 0;
     virtual void reset() = 0;
     virtual Stats getStats() const = 0;
+    
+    // Keyed streams: many streams decoded by one shared model, each with
+    // its own buffers and decoder state. A stream opens on its first chunk;
+    // processStreamChunk() returns false when max_streams are already open.
+    // Different keys may be processed concurrently, calls for one key must
+    // not overlap, and evictIdleStreams() must not overlap any other call.
+    // closeStream() with idle_ms > 0 only closes a stream idle that long.
+    // A TraceTag makes the chunk's spans use the caller's stream ID and chunk
+    virtual bool processStreamChunk(const StreamKey& key,
+                                    const int16_t* samples,
+                                    size_t num_samples,
+                                    uint64_t timestamp_ms,
+                                    TranscriptionResult& result,
+                                    TraceTag trace = TraceTag()) = 0;
+    virtual bool closeStream(const StreamKey& key, TranscriptionResult& final_result,
+                             uint64_t idle_ms = 0) = 0;
+    virtual size_t idleStreams(uint64_t idle_ms, std::vector<StreamKey>& keys) const = 0;
+    virtual size_t evictIdleStreams(uint64_t idle_ms,
+                                    std::vector<std::pair<StreamKey, TranscriptionResult>>& finals) = 0;
+    virtual size_t activeStreams() const = 0;
+    
+    // Per-stage latency histograms (ingest through detokenize are recorded
+    // here; the caller records SUBMIT) and a JSON dump via toJson()
+    virtual PipelineMetrics& getMetrics() = 0;
 };
 
 // Factory function - implementation in .cpp file
@@ -0,0 +1,118 @@
+#ifndef PARTIAL_RESULT_TRACKER_HPP
+#define PARTIAL_RESULT_TRACKER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TokenVocabulary.hpp"
+
+namespace onnx_stt {
+
+/**
+ * Turns a streaming decoder's best hypothesis into incremental results
+ *
+ * Each update() takes the full current hypothesis and reports only what
+ * changed since the last call: the text newly committed (stable, never
+ * revised) and the uncommitted tail (unstable, may still change). A token
+ * is committed once it has survived @c stable_updates consecutive updates
+ * unchanged, and commits only ever end on a word boundary, so stable text
+ * never splits a word. Once committed, later revisions of the hypothesis
+ * inside the committed prefix are ignored.
+ *
+ * Concatenating stable_text of all updates plus the latest unstable_text
+ * gives the utterance text; offsets are byte offsets into that text.
+ *
+ * When the decoder supplies per-token times, words are timed from their
+ * first token to their last token plus @c token_duration_ms.
+ */
+class PartialResultTracker {
+public:
+    struct Config {
+        int stable_updates = 2;      // updates a token must survive before it is committed
+        int token_duration_ms = 40;  // one encoder frame; closes a word after its last token
+    };
+
+    struct Update {
+        std::string stable_text;              // committed by this update, starts on a word
+        std::string unstable_text;            // current uncommitted tail
+        uint64_t stable_offset = 0;           // utterance offset of stable_text
+        std::vector<uint32_t> word_offsets;   // utterance offsets of words in stable + unstable text
+        std::vector<uint32_t> word_start_ms;  // parallel to word_offsets, empty without token times
+        std::vector<uint32_t> word_end_ms;
+    };
+
+    explicit PartialResultTracker(std::shared_ptr<const TokenVocabulary> vocab = nullptr);
+    PartialResultTracker(std::shared_ptr<const TokenVocabulary> vocab, const Config& config);
+
+    void setVocabulary(std::shared_ptr<const TokenVocabulary> vocab);
+
+    /**
+     * Feed the decoder's current best hypothesis and, optionally, the time
+     * of each token in ms (may be null). With @p is_final all tokens are
+     * committed; call reset() before the next utterance.
+     */
+    Update update(const int* tokens, const uint32_t* token_ms, size_t count, bool is_final = false);
+    Update update(const std::vector<int>& tokens, bool is_final = false) {
+        return update(tokens.data(), nullptr, tokens.size(), is_final);
+    }
+    Update update(const std::vector<int>& tokens, const std::vector<uint32_t>& token_ms,
+                  bool is_final = false) {
+        return update(tokens.data(), token_ms.size() == tokens.size() ? token_ms.data() : nullptr,
+                      tokens.size(), is_final);
+    }
+
+    void reset();
+
+    /** Utterance text: committed prefix followed by the unstable tail */
+    const std::string& text() const { return detokenizer_.text(); }
+
+    /** Number of committed tokens / bytes of committed text */
+    size_t committedTokens() const { return committed_; }
+    size_t committedBytes() const { return detokenizer_.textBegin(committed_); }
+
+private:
+    Config config_;
+    std::shared_ptr<const TokenVocabulary> vocab_;
+    IncrementalDetokenizer detokenizer_;
+
+    size_t committed_ = 0;
+    uint32_t updates_ = 0;
+    std::vector<uint32_t> since_;  // update in which each token last changed
+    std::vector<int> merged_;      // committed prefix + the decoder's tail (scratch)
+    std::vector<uint32_t> merged_ms_;
+
+    bool startsWord(size_t index) const;
+};
+
+/**
+ * Add the words of a later update to a result that already holds earlier
+ * ones (e.g. a chunk result followed by the final update at an endpoint)
+ *
+ * Every update lists all words from its stable_offset on, including the
+ * unstable ones an earlier update already listed. Those earlier entries are
+ * replaced rather than repeated, so each word appears once. Works on any
+ * result type with stable_offset and the three word arrays.
+ */
+template <typename Result, typename Update>
+void mergeWords(Result& result, const Update& update) {
+    size_t keep = 0;
+    while (keep < result.word_offsets.size() && result.word_offsets[keep] < update.stable_offset) {
+        ++keep;
+    }
+    result.word_offsets.resize(keep);
+    result.word_start_ms.resize(std::min(result.word_start_ms.size(), keep));
+    result.word_end_ms.resize(std::min(result.word_end_ms.size(), keep));
+    result.word_offsets.insert(result.word_offsets.end(),
+                               update.word_offsets.begin(), update.word_offsets.end());
+    result.word_start_ms.insert(result.word_start_ms.end(),
+                                update.word_start_ms.begin(), update.word_start_ms.end());
+    result.word_end_ms.insert(result.word_end_ms.end(),
+                              update.word_end_ms.begin(), update.word_end_ms.end());
+}
+
+} // namespace onnx_stt
+
+#endif // PARTIAL_RESULT_TRACKER_HPP
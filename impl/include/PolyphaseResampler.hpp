@@ -0,0 +1,89 @@
+#ifndef POLYPHASE_RESAMPLER_HPP
+#define POLYPHASE_RESAMPLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * Streaming rational-ratio resampler (polyphase Kaiser-windowed sinc)
+ *
+ * The ratio out/in is reduced to L/M; the low-pass prototype is split into
+ * L phases of a fixed number of taps, and each output sample is one dot
+ * product of a phase with the most recent input. The last taps - 1 input
+ * samples are kept between calls, so chunked input resamples exactly like
+ * one long buffer, with no seams at chunk boundaries. Use one instance per
+ * channel.
+ *
+ * Output sample j is centred on input time j * M / L; the filter therefore
+ * holds back about taps / 2 input samples until flush().
+ *
+ * Filter tables are built on first use and shared by every resampler with
+ * the same ratio and quality (8k->16k, 44.1k->16k and 48k->16k typically).
+ */
+class PolyphaseResampler {
+public:
+    enum Quality {
+        FAST,     // 8 taps per phase: cheap, some aliasing near Nyquist
+        MEDIUM,   // 16 taps per phase
+        HIGH      // 32 taps per phase: sharp transition, most CPU
+    };
+
+    /** Shared, immutable filter for one ratio and quality */
+    struct Filter {
+        int up = 1;                 // L
+        int down = 1;               // M
+        int taps = 0;               // taps per phase
+        std::vector<float> coeffs;  // up x taps, each phase in input order
+    };
+
+    PolyphaseResampler(int input_rate, int output_rate, Quality quality = MEDIUM);
+
+    /**
+     * Resample @p count samples, appending the output to @p out
+     * @return Number of samples appended
+     */
+    size_t process(const float* input, size_t count, std::vector<float>& out);
+
+    /**
+     * Emit the samples still held back by the filter, so that the total
+     * output is ceil(total input * L / M), then reset()
+     */
+    size_t flush(std::vector<float>& out);
+
+    /** Forget the history, e.g. between calls */
+    void reset();
+
+    int inputRate() const { return input_rate_; }
+    int outputRate() const { return output_rate_; }
+    bool isPassthrough() const { return filter_->up == filter_->down; }
+
+    /** Resample a whole buffer in one go (aligned, flushed) */
+    static std::vector<float> resample(const float* input, size_t count,
+                                       int input_rate, int output_rate,
+                                       Quality quality = MEDIUM);
+
+    /** Parse "fast", "medium" or "high"; anything else gives MEDIUM */
+    static Quality parseQuality(const std::string& name);
+
+private:
+    int input_rate_;
+    int output_rate_;
+    std::shared_ptr<const Filter> filter_;
+
+    std::vector<float> work_;   // history (taps - 1 samples) followed by new input
+    int64_t pos_;               // next output position, in 1/L input samples from work_ history end
+    uint64_t total_in_ = 0;
+    uint64_t total_out_ = 0;
+
+    static std::shared_ptr<const Filter> getFilter(int up, int down, Quality quality);
+    static std::shared_ptr<Filter> designFilter(int up, int down, Quality quality);
+};
+
+} // namespace onnx_stt
+
+#endif // POLYPHASE_RESAMPLER_HPP
@@ -2,8 +2,12 @@
 #define STT_PIPELINE_HPP
 
 #include "VADInterface.hpp"
+#include "CascadeVAD.hpp"
 #include "FeatureExtractor.hpp"
 #include "ModelInterface.hpp"
+#include "Endpointer.hpp"
+#include "PolyphaseResampler.hpp"
+#include "LatencyHistogram.hpp"
 #include <memory>
 #include <vector>
 #include <chrono>
@@ -17,7 +21,8 @@ namespace onnx_stt {
  * 1. Audio input → VAD (Voice Activity Detection)
  * 2. If speech detected → Feature extraction (filterbank/kaldifeat)
  * 3. Features → ASR model (Zipformer/Conformer/etc.)
- * 4. Model output → Text transcription
+ * 4. Model output → Text transcription; an endpoint in the decoder output
+ *    (trailing blanks, maximum length) finalizes the utterance
  */
 class STTPipeline {
 public:
@@ -25,6 +30,21 @@ public:
         // VAD configuration
         VADInterface::Config vad_config;
         bool enable_vad = true;
+        enum VADMode {
+            SILERO_VAD,      // Silero model, energy VAD if the model is missing
+            ENERGY_VAD,      // Adaptive energy threshold only
+            CASCADE_VAD      // Energy/ZCR gate, Silero only for ambiguous frames
+        } vad_mode = SILERO_VAD;
+        CascadeVAD::CascadeConfig cascade_config;
+        
+        // Feature gating (with VAD): compute features only over speech plus
+        // feature_tail_ms of trailing silence. Audio skipped since the last
+        // feature call, up to feature_context_ms, is prepended when speech
+        // resumes so cache-aware encoders see real left context. The
+        // utterance is finalized when the VAD ends the speech segment.
+        bool gate_features = true;
+        int feature_context_ms = 300;
+        int feature_tail_ms = 300;
         
         // Feature extraction configuration
         FeatureExtractor::Config feature_config;
@@ -38,11 +58,23 @@ public:
         
         // Pipeline settings
         int sample_rate = 16000;
+        // Rate of the audio passed to processAudio(); when it differs from
+        // sample_rate the pipeline resamples it (0 = same as sample_rate)
+        int input_sample_rate = 0;
+        PolyphaseResampler::Quality resample_quality = PolyphaseResampler::MEDIUM;
         bool enable_partial_results = true;
         float silence_threshold_sec = 0.5f;  // Seconds of silence before finalizing
         
-        // Performance settings
+        // Decoder-driven endpointing: finalize and reset the model when the
+        // decoder output matches an endpoint rule
+        bool enable_endpointing = true;
+        Endpointer::Config endpoint_config;
+        
+        // Performance settings: span tracing of every chunk (see Tracer).
+        // initialize() turns the process-wide tracer on; the Chrome trace
+        // JSON is written to profile_path when the pipeline is destroyed
         bool enable_profiling = false;
+        std::string profile_path;
     };
     
     struct Result {
@@ -60,19 +92,36 @@ public:
         // VAD information
         bool speech_detected = true;
         float vad_confidence = 1.0f;
+        
+        // Incremental output: new committed text and the uncommitted tail,
+        // so consumers need not resend or diff the whole utterance
+        std::string stable_text;
+        std::string unstable_text;
+        uint64_t stable_offset = 0;
+        std::vector<uint32_t> word_offsets;
+        std::vector<uint32_t> word_start_ms;  // parallel to word_offsets
+        std::vector<uint32_t> word_end_ms;
     };
     
     struct Stats {
         uint64_t total_chunks_processed = 0;
         uint64_t speech_chunks = 0;
         uint64_t silence_chunks = 0;
+        uint64_t endpoints = 0;
+        
+        // Feature frames computed, and frames of hangover silence skipped
+        uint64_t feature_frames = 0;
+        uint64_t feature_frames_skipped = 0;
         
+        // Means of the per-stage histograms (see getMetrics())
         double avg_vad_latency_ms = 0.0;
         double avg_feature_latency_ms = 0.0;
         double avg_model_latency_ms = 0.0;
         double avg_total_latency_ms = 0.0;
         
+        // Processing time over the audio ingested
         double real_time_factor = 0.0;
+        uint64_t total_audio_ms = 0;
         
         // Component statistics
         std::map<std::string, double> vad_stats;
@@ -80,12 +129,12 @@ public:
     };
     
     explicit STTPipeline(const Config& config);
-    ~STTPipeline() = default;
+    ~STTPipeline();
     
     // Initialize all components
     bool initialize();
     
-    // Process audio chunk (int16 format)
+    // Process audio chunk (int16 format, converted into a reused buffer)
     Result processAudio(const int16_t* samples, size_t num_samples, uint64_t timestamp_ms);
     
     // Process audio chunk (float format)
@@ -100,6 +149,9 @@ public:
     // Get pipeline statistics
     Stats getStats() const;
     
+    // Per-stage latency histograms and audio accounting
+    const PipelineMetrics& getMetrics() const { return metrics_; }
+    
     // Enable/disable components
     void enableVAD(bool enable) { config_.enable_vad = enable; }
     void enablePartialResults(bool enable) { config_.enable_partial_results = enable; }
@@ -111,14 +163,29 @@ private:
     std::unique_ptr<VADInterface> vad_;
     std::unique_ptr<FeatureExtractor> feature_extractor_;
     std::unique_ptr<ModelInterface> model_;
+    Endpointer endpointer_;
+    std::unique_ptr<PolyphaseResampler> resampler_;  // input_sample_rate -> sample_rate
     
     // State management
     std::vector<float> audio_buffer_;
+    std::vector<float> converted_;     // int16 input as float
+    std::vector<float> resampled_;
     uint64_t last_speech_time_ms_;
     bool in_speech_segment_;
     
+    // Feature gating: ring of recent audio for left context
+    std::vector<float> context_ring_;
+    size_t context_pos_ = 0;           // next write position
+    size_t context_fill_ = 0;
+    size_t skipped_samples_ = 0;       // audio not fed to the model since the last feature call
+    size_t tail_remaining_ = 0;        // trailing silence still to be featurized
+    std::vector<float> feature_input_;
+    
     // Performance tracking
     mutable Stats stats_;
+    PipelineMetrics metrics_;
+    bool model_records_stages_ = false;  // model times encoder/decoder itself
+    uint64_t trace_stream_id_;           // stream ID in trace spans
     std::chrono::steady_clock::time_point last_process_time_;
     
     // Helper methods
@@ -126,10 +193,12 @@ private:
     bool initializeFeatureExtractor();
     bool initializeModel();
     
+    Result processFloat(const std::vector<float>& audio, uint64_t timestamp_ms);
     Result processAudioInternal(const std::vector<float>& audio, uint64_t timestamp_ms);
-    void updateStats(const Result& result);
-    
-    std::vector<float> convertInt16ToFloat(const int16_t* samples, size_t num_samples);
+    void finalizeUtterance(Result& result, uint64_t timestamp_ms);
+    void pushContext(const float* samples, size_t num_samples);
+    void appendContext(size_t num_samples, std::vector<float>& out) const;
+    size_t samplesToFrames(size_t num_samples) const;
 };
 
 /**
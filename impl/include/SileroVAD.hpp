@@ -3,6 +3,7 @@
 
 #include "VADInterface.hpp"
 #include "onnx_wrapper.hpp"
+#include "StreamingBuffer.hpp"
 #include <memory>
 #include <vector>
 #include <string>
@@ -16,6 +17,12 @@ namespace onnx_stt {
  * that can distinguish speech from silence, music, and noise.
  * 
  * Model: https://github.com/snakers4/silero-vad
+ *
+ * Audio is windowed through a StreamingBuffer ring. The window, the LSTM
+ * states and the probability output live in buffers that are wrapped as
+ * ORT tensors once at initialization. The states ping-pong between two
+ * buffer pairs, so each Run reads one pair and writes the other. After
+ * that, the per-window cost is a copy of the window and the model call.
  */
 class SileroVAD : public VADInterface {
 public:
@@ -35,8 +42,17 @@ public:
     
     const Config& getConfig() const override { return config_; }
     
+    std::map<std::string, double> getStats() const override;
+    
+    /** Pointer overload of processChunk */
+    VADResult processSamples(const float* samples, size_t num_samples, uint64_t timestamp_ms);
+    
+    /** Windows run through the model since construction */
+    uint64_t windowsProcessed() const { return windows_processed_; }
+    
 private:
     Config config_;
+    uint64_t windows_processed_ = 0;
     
     // ONNX Runtime components
     std::unique_ptr<Ort::Env> env_;
@@ -49,10 +65,25 @@ private:
     std::vector<std::vector<int64_t>> input_shapes_;
     std::vector<std::vector<int64_t>> output_shapes_;
     
+    // Name arrays handed to Run, cached once
+    std::vector<const char*> input_name_ptrs_;
+    std::vector<const char*> output_name_ptrs_;
+    
     // Internal state for streaming
-    std::vector<float> state_h_;
-    std::vector<float> state_c_;
-    std::vector<float> audio_buffer_;
+    static constexpr size_t kStateSize = 2 * 64;  // 2 layers, 64 hidden units
+    std::unique_ptr<StreamingBuffer> audio_buffer_;
+    std::vector<float> window_;          // bound to the audio input
+    std::vector<float> state_h_[2];      // ping-pong LSTM states
+    std::vector<float> state_c_[2];
+    int state_index_ = 0;                // pair read by the next Run
+    float speech_prob_ = 0.0f;           // bound to the probability output
+    int64_t sample_rate_value_ = 0;      // bound to the optional "sr" input
+    std::vector<float> scratch_;         // int16 conversion
+    
+    // Tensors over the buffers above, one set per ping-pong phase
+    Ort::MemoryInfo memory_info_{nullptr};
+    std::vector<Ort::Value> input_tensors_[2];
+    std::vector<Ort::Value> output_tensors_[2];
     
     // Model configuration
     int window_size_samples_;
@@ -60,10 +91,8 @@ private:
     
     // Helper methods
     bool loadModel(const std::string& model_path);
-    std::vector<float> preprocessAudio(const std::vector<float>& audio);
-    VADResult runInference(const std::vector<float>& audio_chunk, uint64_t timestamp_ms);
-    void convertInt16ToFloat(const int16_t* samples, size_t num_samples, 
-                            std::vector<float>& output);
+    bool bindTensors();
+    VADResult runInference(uint64_t timestamp_ms);
 };
 
 /**
@@ -0,0 +1,131 @@
+#ifndef SPEECH_SEGMENTER_HPP
+#define SPEECH_SEGMENTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * A padded stretch of speech cut from a recording
+ */
+struct SpeechSegment {
+    uint64_t id = 0;                 // order of emission
+    uint64_t start_ms = 0;           // of audio[0], including pre-roll
+    uint64_t end_ms = 0;             // end of audio, including post-roll
+    uint64_t speech_ms = 0;          // audio that the VAD marked as speech
+    std::vector<float> audio;
+};
+
+/**
+ * Turns per-chunk VAD decisions into speech segments for offline decoding
+ *
+ * Each speech region is padded with pre_roll_ms of audio before its first
+ * speech chunk and post_roll_ms after its last one. Regions whose padded
+ * extents are at most merge_gap_ms apart become one segment. Segments with
+ * less than min_segment_ms of speech are dropped. A segment that reaches
+ * max_segment_ms is cut at the quietest 10 ms in its last second and the
+ * remainder continues as the next segment.
+ *
+ * Completed segments are appended to the vector passed to push()/flush(),
+ * typically on their way into a SegmentQueue.
+ */
+class SpeechSegmenter {
+public:
+    struct Config {
+        int sample_rate = 16000;
+        int pre_roll_ms = 200;
+        int post_roll_ms = 300;
+        int merge_gap_ms = 300;
+        int min_segment_ms = 250;        // of speech, excluding padding
+        int max_segment_ms = 20000;      // including padding
+    };
+
+    struct Stats {
+        uint64_t segments = 0;
+        uint64_t dropped_short = 0;
+        uint64_t forced_cuts = 0;        // segments cut at max_segment_ms
+        uint64_t samples_in = 0;
+        uint64_t samples_emitted = 0;
+    };
+
+    SpeechSegmenter();
+    explicit SpeechSegmenter(const Config& config);
+
+    /**
+     * Add a chunk of audio with its VAD decision
+     * @return Number of segments appended to out
+     */
+    size_t push(const float* samples, size_t num_samples, bool is_speech,
+                std::vector<SpeechSegment>& out);
+
+    /** End of recording: close the open segment, if any */
+    size_t flush(std::vector<SpeechSegment>& out);
+
+    void reset();
+
+    const Config& getConfig() const { return config_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    Config config_;
+    Stats stats_;
+
+    size_t pre_roll_;
+    size_t post_roll_;
+    size_t close_after_;             // trailing silence that ends a segment
+    size_t min_speech_;
+    size_t max_segment_;
+
+    std::vector<float> history_;     // last pre_roll_ samples while idle
+    bool in_segment_ = false;
+    SpeechSegment current_;
+    uint64_t current_start_ = 0;     // sample index of current_.audio[0]
+    size_t trailing_silence_ = 0;    // samples since the last speech chunk
+    uint64_t speech_samples_ = 0;
+    uint64_t position_ = 0;          // samples pushed since reset
+    uint64_t next_id_ = 0;
+
+    void appendToSegment(const float* samples, size_t num_samples, bool is_speech);
+    size_t closeSegment(size_t keep_samples, std::vector<SpeechSegment>& out);
+    size_t cutSegment(std::vector<SpeechSegment>& out);
+    void keepHistory(const float* samples, size_t num_samples);
+    uint64_t toMs(uint64_t samples) const;
+};
+
+/**
+ * Pending segments handed to a batch decoder in length-sorted batches
+ *
+ * Batching segments of similar length keeps padding low; popBatch() takes
+ * the longest pending segment and adds the next-longest ones while the
+ * padded batch (count x longest) fits max_batch_samples. Thread-safe, so a
+ * segmenter can fill the queue while a decoder drains it.
+ */
+class SegmentQueue {
+public:
+    void push(SpeechSegment segment);
+    void push(std::vector<SpeechSegment>& segments);   // moves the contents
+
+    /**
+     * Remove up to max_segments segments of similar length
+     * @param max_batch_samples Padded size limit; the longest segment is
+     *                          always taken even if it alone exceeds it
+     * @return The batch, longest first; empty when the queue is empty
+     */
+    std::vector<SpeechSegment> popBatch(size_t max_segments, size_t max_batch_samples);
+
+    size_t size() const;
+    bool empty() const;
+    uint64_t pendingSamples() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<SpeechSegment> pending_;
+    uint64_t pending_samples_ = 0;
+};
+
+} // namespace onnx_stt
+
+#endif // SPEECH_SEGMENTER_HPP
@@ -0,0 +1,227 @@
+#ifndef SPSC_RING_BUFFER_HPP
+#define SPSC_RING_BUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring
+ *
+ * One thread calls push(), one other thread calls pop(); neither takes a
+ * lock. Indices grow monotonically and are masked into a power-of-two
+ * array, so a full ring and an empty one are told apart without a spare
+ * slot.
+ *
+ * When the ring is full the overflow policy decides what push() does:
+ *   DROP_OLDEST - discard the oldest queued samples to make room; the
+ *                 producer never waits. A pop() racing with the discard
+ *                 notices that its read index moved and retries.
+ *   BLOCK       - wait (yielding) until the consumer frees space or the
+ *                 ring is closed; this back-pressures the producer.
+ */
+template <typename T>
+class SpscRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscRingBuffer elements are copied with memcpy semantics");
+
+public:
+    enum class OverflowPolicy {
+        DROP_OLDEST,
+        BLOCK
+    };
+
+    struct Stats {
+        uint64_t pushed = 0;      // elements accepted by push()
+        uint64_t popped = 0;      // elements returned by pop()
+        uint64_t dropped = 0;     // elements discarded on overflow
+        uint64_t waits = 0;       // push() calls that had to wait for space
+        size_t high_water = 0;    // largest fill level seen by the producer
+    };
+
+    /**
+     * @param capacity Minimum number of elements (rounded up to a power of two)
+     * @param policy   What push() does when the ring is full
+     */
+    explicit SpscRingBuffer(size_t capacity, OverflowPolicy policy = OverflowPolicy::DROP_OLDEST)
+        : capacity_(roundUpPow2(std::max<size_t>(capacity, 1)))
+        , mask_(capacity_ - 1)
+        , policy_(policy)
+        , buffer_(capacity_) {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    /**
+     * @brief Producer: enqueue @p count elements
+     * @return Number of elements enqueued; less than @p count only for
+     *         BLOCK after close(), or when @p count exceeds the capacity
+     *         under DROP_OLDEST (its oldest elements are dropped)
+     */
+    size_t push(const T* data, size_t count) {
+        if (count > capacity_) {
+            if (policy_ == OverflowPolicy::BLOCK) {
+                // Feed it through in capacity-sized pieces
+                size_t written = 0;
+                while (written < count) {
+                    size_t n = push(data + written, std::min(capacity_, count - written));
+                    if (n == 0) {
+                        break;
+                    }
+                    written += n;
+                }
+                return written;
+            }
+            dropped_.fetch_add(count - capacity_, std::memory_order_relaxed);
+            data += count - capacity_;
+            count = capacity_;
+        }
+        if (count == 0) {
+            return 0;
+        }
+
+        const size_t head = head_.load(std::memory_order_relaxed);
+        bool waited = false;
+        for (;;) {
+            size_t tail = tail_.load(std::memory_order_acquire);
+            size_t free_space = capacity_ - (head - tail);
+            if (free_space >= count) {
+                break;
+            }
+            if (policy_ == OverflowPolicy::DROP_OLDEST) {
+                size_t excess = count - free_space;
+                if (tail_.compare_exchange_weak(tail, tail + excess, std::memory_order_acq_rel)) {
+                    dropped_.fetch_add(excess, std::memory_order_relaxed);
+                    break;
+                }
+                continue;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                return 0;
+            }
+            if (!waited) {
+                waits_.fetch_add(1, std::memory_order_relaxed);
+                waited = true;
+            }
+            std::this_thread::yield();
+        }
+
+        copyIn(head, data, count);
+        head_.store(head + count, std::memory_order_release);
+        pushed_.fetch_add(count, std::memory_order_relaxed);
+
+        size_t used = head + count - tail_.load(std::memory_order_relaxed);
+        if (used > high_water_.load(std::memory_order_relaxed)) {
+            high_water_.store(used, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Consumer: dequeue up to @p max_count elements into @p out
+     * @return Number of elements dequeued (0 if empty)
+     */
+    size_t pop(T* out, size_t max_count) {
+        for (;;) {
+            size_t tail = tail_.load(std::memory_order_acquire);
+            size_t head = head_.load(std::memory_order_acquire);
+            size_t count = std::min(head - tail, max_count);
+            if (count == 0) {
+                return 0;
+            }
+            copyOut(tail, out, count);
+            // Fails only if DROP_OLDEST discarded (and may have overwritten)
+            // what was just copied
+            if (tail_.compare_exchange_strong(tail, tail + count, std::memory_order_acq_rel)) {
+                popped_.fetch_add(count, std::memory_order_relaxed);
+                return count;
+            }
+        }
+    }
+
+    /**
+     * @brief Consumer: discard everything queued
+     */
+    void clear() {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        while (!tail_.compare_exchange_weak(tail, head_.load(std::memory_order_acquire),
+                                            std::memory_order_acq_rel)) {
+        }
+    }
+
+    /**
+     * @brief Release a producer blocked in push(); later BLOCK pushes that
+     *        find the ring full return 0
+     */
+    void close() { closed_.store(true, std::memory_order_release); }
+    void reopen() { closed_.store(false, std::memory_order_release); }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    size_t size() const {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return capacity_; }
+    OverflowPolicy policy() const { return policy_; }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.pushed = pushed_.load(std::memory_order_relaxed);
+        stats.popped = popped_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.waits = waits_.load(std::memory_order_relaxed);
+        stats.high_water = high_water_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    const size_t capacity_;
+    const size_t mask_;
+    const OverflowPolicy policy_;
+    std::vector<T> buffer_;
+
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<bool> closed_{false};
+
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> popped_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> waits_{0};
+    std::atomic<size_t> high_water_{0};
+
+    void copyIn(size_t index, const T* data, size_t count) {
+        size_t pos = index & mask_;
+        size_t first = std::min(count, capacity_ - pos);
+        std::copy(data, data + first, buffer_.begin() + pos);
+        std::copy(data + first, data + count, buffer_.begin());
+    }
+
+    void copyOut(size_t index, T* out, size_t count) const {
+        size_t pos = index & mask_;
+        size_t first = std::min(count, capacity_ - pos);
+        std::copy(buffer_.begin() + pos, buffer_.begin() + pos + first, out);
+        std::copy(buffer_.begin(), buffer_.begin() + (count - first), out + first);
+    }
+
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+};
+
+} // namespace onnx_stt
+
+#endif // SPSC_RING_BUFFER_HPP
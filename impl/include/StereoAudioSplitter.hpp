@@ -14,6 +14,11 @@ namespace stt {
 /**
  * Utility class for splitting stereo audio into separate channels.
  * Supports various stereo formats and telephony codecs.
+ *
+ * Each split has two forms: one returning ChannelBuffers, and one writing
+ * into caller-provided left/right arrays (no allocation, SIMD deinterleave
+ * and table-driven G.711 decode). The latter is meant for per-tuple use
+ * with buffers the caller reuses.
  */
 class StereoAudioSplitter {
 public:
@@ -66,6 +71,32 @@ public:
         size_t numSamples,
         const SplitOptions& options = SplitOptions());
     
+    /**
+     * Split interleaved stereo PCM16 into caller-provided buffers
+     * @param interleavedData Pointer to interleaved audio data (L,R,L,R,...)
+     * @param numSamples Total number of samples (must be even)
+     * @param left, right Outputs, each with room for numSamples / 2 floats
+     * @param normalizeFloat Scale to [-1.0, 1.0) instead of PCM values
+     * @return Number of samples written to each channel
+     */
+    static size_t splitInterleavedPCM16(
+        const int16_t* interleavedData,
+        size_t numSamples,
+        float* left,
+        float* right,
+        bool normalizeFloat = true);
+    
+    /**
+     * Split interleaved stereo PCM8 into caller-provided buffers
+     * @return Number of samples written to each channel
+     */
+    static size_t splitInterleavedPCM8(
+        const uint8_t* interleavedData,
+        size_t numSamples,
+        float* left,
+        float* right,
+        bool normalizeFloat = true);
+    
     /**
      * Split non-interleaved stereo data into separate channels
      * @param leftData Pointer to left channel data
@@ -92,6 +123,20 @@ public:
         size_t numBytes,
         bool isInterleaved = true);
     
+    /**
+     * Decode G.711 µ-law stereo audio into caller-provided buffers
+     * @param left, right Outputs, each with room for numBytes / 2 floats
+     * @param normalizeFloat Scale to [-1.0, 1.0) instead of PCM values
+     * @return Number of samples written to each channel
+     */
+    static size_t splitG711uLaw(
+        const uint8_t* g711Data,
+        size_t numBytes,
+        float* left,
+        float* right,
+        bool isInterleaved = true,
+        bool normalizeFloat = true);
+    
     /**
      * Split G.711 A-law stereo audio into PCM channels
      * @param g711Data Pointer to G.711 A-law encoded data
@@ -105,7 +150,21 @@ public:
         bool isInterleaved = true);
         
     /**
-     * Resample audio data to a different sample rate
+     * Decode G.711 A-law stereo audio into caller-provided buffers
+     * @return Number of samples written to each channel
+     */
+    static size_t splitG711aLaw(
+        const uint8_t* g711Data,
+        size_t numBytes,
+        float* left,
+        float* right,
+        bool isInterleaved = true,
+        bool normalizeFloat = true);
+    
+    /**
+     * Resample audio data to a different sample rate (windowed-sinc, up or
+     * down). One-shot: for chunked audio keep a PolyphaseResampler per
+     * channel instead, so chunk boundaries stay seamless.
      * @param input Input audio samples
      * @param inputRate Input sample rate in Hz
      * @param outputRate Output sample rate in Hz
@@ -125,6 +184,14 @@ public:
     static std::vector<float> upsampleLinear(
         const std::vector<float>& input,
         float factor);
+    
+    /**
+     * 256-entry float decode tables for 8-bit encodings, normalized to
+     * [-1.0, 1.0) or in PCM16 units (PCM8: in units of its own scale)
+     */
+    static const float* ulawFloatTable(bool normalize);
+    static const float* alawFloatTable(bool normalize);
+    static const float* pcm8FloatTable(bool normalize);
         
 private:
     // G.711 µ-law to PCM conversion
@@ -133,6 +200,10 @@ private:
     // G.711 A-law to PCM conversion
     static int16_t alawToPcm(uint8_t alaw);
     
+    static size_t splitG711(const uint8_t* g711Data, size_t numBytes,
+                            const float* table, float* left, float* right,
+                            bool isInterleaved);
+    
     // Normalize int16 to float [-1.0, 1.0]
     static inline float normalizeInt16(int16_t sample) {
         return sample / 32768.0f;
@@ -6,36 +6,47 @@
 #include <algorithm>
 #include <cstring>
 #include <stdexcept>
+#include <cstdint>
+#include "AudioKernels.hpp"
 
 namespace onnx_stt {
 
 /**
  * @brief Circular buffer for streaming audio processing
- * 
+ *
  * This class manages audio buffering for streaming speech recognition,
  * handling chunk extraction with configurable overlap.
+ *
+ * The ring has a power-of-two capacity and is followed by a mirror of its
+ * first chunk_size samples, so any chunk starting anywhere in the ring is
+ * one contiguous span. nextChunk() hands out that span without copying; it
+ * can be fed to FbankComputer::computeFeatures(const float*, size_t) or
+ * wrapped as an ORT tensor. Appends are at most two memcpy calls plus
+ * the mirror refresh when the write touches the ring head; appendInt16()
+ * converts PCM straight into the ring instead of copying floats.
  */
 class StreamingBuffer {
 public:
     /**
      * @brief Constructor
-     * @param capacity Maximum buffer size in samples
+     * @param capacity Maximum buffer size in samples (rounded up to a power of two)
      * @param chunk_size Size of each chunk to extract
      * @param overlap_size Number of samples to overlap between chunks
      */
     StreamingBuffer(size_t capacity, size_t chunk_size, size_t overlap_size)
-        : capacity_(capacity)
+        : capacity_(roundUpPow2(std::max(capacity, chunk_size)))
+        , mask_(capacity_ - 1)
         , chunk_size_(chunk_size)
         , overlap_size_(overlap_size)
-        , buffer_(capacity)
-        , write_pos_(0)
+        , buffer_(capacity_ + chunk_size)
+        , read_pos_(0)
         , available_samples_(0) {
-        
+
         if (overlap_size >= chunk_size) {
             throw std::invalid_argument("Overlap size must be less than chunk size");
         }
     }
-    
+
     /**
      * @brief Append audio samples to the buffer
      * @param data Pointer to audio samples
@@ -44,96 +55,207 @@ public:
      */
     size_t append(const float* data, size_t size) {
         size_t samples_to_write = std::min(size, capacity_ - available_samples_);
-        
-        for (size_t i = 0; i < samples_to_write; ++i) {
-            buffer_[write_pos_] = data[i];
-            write_pos_ = (write_pos_ + 1) % capacity_;
+        if (samples_to_write == 0) {
+            return 0;
+        }
+
+        size_t write_pos = (read_pos_ + available_samples_) & mask_;
+        size_t first = std::min(samples_to_write, capacity_ - write_pos);
+        std::memcpy(&buffer_[write_pos], data, first * sizeof(float));
+        mirrorHead(write_pos, first);
+        if (first < samples_to_write) {
+            std::memcpy(&buffer_[0], data + first, (samples_to_write - first) * sizeof(float));
+            mirrorHead(0, samples_to_write - first);
         }
-        
+
         available_samples_ += samples_to_write;
         return samples_to_write;
     }
-    
+
+    /**
+     * @brief Append int16 PCM, converting it in place in the ring
+     * @param data Pointer to samples, e.g. straight from an SPL blob
+     * @param size Number of samples to append
+     * @param scale Multiplier applied during conversion
+     * @return Number of samples actually written (may be less if buffer is full)
+     */
+    size_t appendInt16(const int16_t* data, size_t size, float scale = 1.0f / 32768.0f) {
+        size_t samples_to_write = std::min(size, capacity_ - available_samples_);
+        if (samples_to_write == 0) {
+            return 0;
+        }
+
+        size_t write_pos = (read_pos_ + available_samples_) & mask_;
+        size_t first = std::min(samples_to_write, capacity_ - write_pos);
+        audio_kernels::int16ToFloat(data, &buffer_[write_pos], first, scale);
+        mirrorHead(write_pos, first);
+        if (first < samples_to_write) {
+            audio_kernels::int16ToFloat(data + first, &buffer_[0], samples_to_write - first, scale);
+            mirrorHead(0, samples_to_write - first);
+        }
+
+        available_samples_ += samples_to_write;
+        return samples_to_write;
+    }
+
+    /**
+     * @brief Contiguous view of the next chunk, consuming it
+     *
+     * Advances past chunk_size - overlap_size samples. The returned pointer
+     * stays valid until the next append() or clear().
+     *
+     * @return Pointer to chunk_size samples, or nullptr if not enough data
+     */
+    const float* nextChunk() {
+        if (available_samples_ < chunk_size_) {
+            return nullptr;
+        }
+        const float* chunk = &buffer_[read_pos_];
+        consume(chunk_size_ - overlap_size_);
+        return chunk;
+    }
+
+    /**
+     * @brief Contiguous view of the oldest @p count samples without consuming them
+     * @return Pointer, or nullptr if fewer samples are buffered or count > chunk_size
+     */
+    const float* peek(size_t count) const {
+        if (count > available_samples_ || count > chunk_size_) {
+            return nullptr;
+        }
+        return &buffer_[read_pos_];
+    }
+
+    /**
+     * @brief Drop the oldest @p count samples
+     */
+    void consume(size_t count) {
+        count = std::min(count, available_samples_);
+        read_pos_ = (read_pos_ + count) & mask_;
+        available_samples_ -= count;
+    }
+
     /**
      * @brief Get the next chunk of audio data
      * @param chunk Output vector to fill with chunk data
      * @return true if a full chunk was extracted, false if not enough data
      */
     bool getNextChunk(std::vector<float>& chunk) {
-        if (available_samples_ < chunk_size_) {
+        const float* view = nextChunk();
+        if (!view) {
             return false;
         }
-        
-        chunk.resize(chunk_size_);
-        
-        // Calculate read position
-        size_t read_pos = (write_pos_ + capacity_ - available_samples_) % capacity_;
-        
-        // Copy chunk data
-        for (size_t i = 0; i < chunk_size_; ++i) {
-            chunk[i] = buffer_[(read_pos + i) % capacity_];
-        }
-        
-        // Advance position, keeping overlap
-        size_t advance = chunk_size_ - overlap_size_;
-        available_samples_ -= advance;
-        
+        chunk.assign(view, view + chunk_size_);
         return true;
     }
-    
+
     /**
      * @brief Get remaining audio data (less than chunk_size)
      * @param remainder Output vector for remaining samples
      * @return Number of samples in remainder
      */
     size_t getRemainder(std::vector<float>& remainder) {
+        remainder.resize(available_samples_);
         if (available_samples_ == 0) {
-            remainder.clear();
             return 0;
         }
-        
-        remainder.resize(available_samples_);
-        size_t read_pos = (write_pos_ + capacity_ - available_samples_) % capacity_;
-        
-        for (size_t i = 0; i < available_samples_; ++i) {
-            remainder[i] = buffer_[(read_pos + i) % capacity_];
+
+        size_t first = std::min(available_samples_, capacity_ - read_pos_);
+        std::memcpy(remainder.data(), &buffer_[read_pos_], first * sizeof(float));
+        if (first < available_samples_) {
+            std::memcpy(remainder.data() + first, &buffer_[0],
+                        (available_samples_ - first) * sizeof(float));
         }
-        
-        available_samples_ = 0;
+
+        clear();
         return remainder.size();
     }
-    
+
+    /**
+     * @brief Change the ring capacity, keeping the buffered samples
+     *
+     * Used to grow the ring for a tuple larger than the free space, and to
+     * shrink it back afterwards; chunk views handed out before are invalid.
+     * @param capacity New capacity in samples (rounded up to a power of two,
+     *        and to at least chunk_size and the samples buffered now)
+     */
+    void resize(size_t capacity) {
+        size_t new_capacity = roundUpPow2(std::max(capacity, std::max(chunk_size_, available_samples_)));
+        if (new_capacity == capacity_) {
+            return;
+        }
+
+        std::vector<float> buffer(new_capacity + chunk_size_);
+        size_t first = std::min(available_samples_, capacity_ - read_pos_);
+        std::memcpy(buffer.data(), &buffer_[read_pos_], first * sizeof(float));
+        if (first < available_samples_) {
+            std::memcpy(buffer.data() + first, &buffer_[0],
+                        (available_samples_ - first) * sizeof(float));
+        }
+
+        buffer_.swap(buffer);
+        capacity_ = new_capacity;
+        mask_ = capacity_ - 1;
+        read_pos_ = 0;
+        mirrorHead(0, available_samples_);
+    }
+
     /**
      * @brief Clear the buffer
      */
     void clear() {
         available_samples_ = 0;
-        write_pos_ = 0;
+        read_pos_ = 0;
     }
-    
+
     /**
      * @brief Get number of available samples
      */
     size_t available() const {
         return available_samples_;
     }
-    
+
+    /**
+     * @brief Ring capacity in samples (a power of two)
+     */
+    size_t capacity() const {
+        return capacity_;
+    }
+
     /**
      * @brief Check if enough samples for a chunk
      */
     bool hasChunk() const {
         return available_samples_ >= chunk_size_;
     }
-    
+
 private:
     size_t capacity_;
+    size_t mask_;
     size_t chunk_size_;
     size_t overlap_size_;
-    std::vector<float> buffer_;
-    size_t write_pos_;
+    std::vector<float> buffer_;  // capacity_ ring + chunk_size_ mirror of its head
+    size_t read_pos_;
     size_t available_samples_;
+
+    // Copy the part of [pos, pos + count) that lies in the ring head to the mirror
+    void mirrorHead(size_t pos, size_t count) {
+        if (pos >= chunk_size_) {
+            return;
+        }
+        size_t end = std::min(pos + count, chunk_size_);
+        std::memcpy(&buffer_[capacity_ + pos], &buffer_[pos], (end - pos) * sizeof(float));
+    }
+
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
 };
 
 } // namespace onnx_stt
 
-#endif // STREAMING_BUFFER_HPP
\ No newline at end of file
+#endif // STREAMING_BUFFER_HPP
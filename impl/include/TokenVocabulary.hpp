@@ -0,0 +1,113 @@
+#ifndef TOKEN_VOCABULARY_HPP
+#define TOKEN_VOCABULARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * SentencePiece/BPE vocabulary with a precompiled detokenization table
+ *
+ * All pieces live in one contiguous blob. For each token the table keeps
+ * the offset of its display text (past the U+2581 word marker) and a
+ * "starts word" flag, so detokenizing is a flag test and one append per
+ * token with no per-token string work.
+ *
+ * Accepts tokens files with one piece per line, either "piece" (id = line
+ * number), "piece id" or "piece<TAB>score". WordPiece vocabularies ("##"
+ * continuation pieces, no word markers) are detected and rendered the same
+ * way. Instances are immutable and shared per path.
+ */
+class TokenVocabulary {
+public:
+    /** Load @p path, or return the instance already loaded from it; nullptr on failure */
+    static std::shared_ptr<const TokenVocabulary> load(const std::string& path);
+
+    int size() const { return static_cast<int>(starts_word_.size()); }
+
+    /** Id of the raw piece (e.g. "<blk>"), or -1 */
+    int findId(const std::string& piece) const;
+
+    /** Raw piece as it appears in the tokens file */
+    std::string piece(int id) const;
+
+    bool startsWord(int id) const { return starts_word_[id] != 0; }
+
+    /**
+     * Append the display text of @p id to @p out. A word-initial token gets
+     * a space unless @p out is empty. Out-of-range ids are ignored.
+     */
+    void appendToken(int id, std::string& out) const {
+        if (id < 0 || id >= size()) {
+            return;
+        }
+        if (starts_word_[id] && !out.empty()) {
+            out.push_back(' ');
+        }
+        out.append(blob_.data() + text_begin_[id], piece_end_[id] - text_begin_[id]);
+    }
+
+    /** Append the text of @p count tokens to @p out */
+    void detokenize(const int* ids, size_t count, std::string& out) const;
+
+    std::string detokenize(const std::vector<int>& ids) const;
+
+private:
+    TokenVocabulary() = default;
+    bool parse(const std::string& path);
+
+    std::string blob_;                  // raw pieces back to back
+    std::vector<uint32_t> piece_begin_;
+    std::vector<uint32_t> text_begin_;  // piece_begin_ past the word/continuation marker
+    std::vector<uint32_t> piece_end_;
+    std::vector<uint8_t> starts_word_;
+};
+
+/**
+ * Keeps the text of a growing (or revised) hypothesis up to date
+ *
+ * update() compares the new token sequence with the previous one and only
+ * re-renders the tokens after the common prefix, so streaming decoders pay
+ * per new token instead of per hypothesis length on every chunk.
+ */
+class IncrementalDetokenizer {
+public:
+    explicit IncrementalDetokenizer(std::shared_ptr<const TokenVocabulary> vocab = nullptr);
+
+    void setVocabulary(std::shared_ptr<const TokenVocabulary> vocab);
+
+    /**
+     * Bring the text in line with @p tokens. Returns the index of the first
+     * token whose text changed (== previous size when tokens were only added).
+     */
+    size_t update(const int* tokens, size_t count);
+    size_t update(const std::vector<int>& tokens) { return update(tokens.data(), tokens.size()); }
+
+    /** Append one token */
+    void push(int token);
+
+    void reset();
+
+    const std::string& text() const { return text_; }
+    const std::vector<int>& tokens() const { return tokens_; }
+
+    /** Byte offset where the text of token @p index starts (its separator included) */
+    size_t textBegin(size_t index) const { return index == 0 ? 0 : token_end_[index - 1]; }
+
+    /** Byte offset just past the text of token @p index */
+    size_t textEnd(size_t index) const { return token_end_[index]; }
+
+private:
+    std::shared_ptr<const TokenVocabulary> vocab_;
+    std::vector<int> tokens_;
+    std::vector<uint32_t> token_end_;
+    std::string text_;
+};
+
+} // namespace onnx_stt
+
+#endif // TOKEN_VOCABULARY_HPP
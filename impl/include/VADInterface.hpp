@@ -4,6 +4,8 @@
 #include <vector>
 #include <memory>
 #include <cstdint>
+#include <map>
+#include <string>
 
 namespace onnx_stt {
 
@@ -45,6 +47,9 @@ public:
     
     // Get configuration
     virtual const Config& getConfig() const = 0;
+    
+    // Implementation-specific counters (empty by default)
+    virtual std::map<std::string, double> getStats() const { return {}; }
 };
 
 /**
@@ -52,6 +57,7 @@ public:
  */
 std::unique_ptr<VADInterface> createSileroVAD(const VADInterface::Config& config);
 std::unique_ptr<VADInterface> createEnergyVAD(const VADInterface::Config& config);
+std::unique_ptr<VADInterface> createCascadeVAD(const VADInterface::Config& config);
 
 } // namespace onnx_stt
 
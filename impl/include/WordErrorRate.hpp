@@ -0,0 +1,59 @@
+#ifndef WORD_ERROR_RATE_HPP
+#define WORD_ERROR_RATE_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace onnx_stt {
+
+/**
+ * Word error rate helpers shared by the benchmark and test tools
+ *
+ * Transcripts are compared as NeMo's WER tooling does: lower-cased words
+ * without punctuation (apostrophes kept), aligned by word-level edit
+ * distance. WER is editDistance(reference, hypothesis) over the number of
+ * reference words.
+ */
+
+/** Lower-case words of @p text without punctuation */
+inline std::vector<std::string> normalizeWords(const std::string& text) {
+    std::vector<std::string> words;
+    std::istringstream in(text);
+    std::string word;
+    while (in >> word) {
+        std::string clean;
+        for (char c : word) {
+            if (std::isalnum(static_cast<unsigned char>(c)) || c == '\'') {
+                clean += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+        }
+        if (!clean.empty()) {
+            words.push_back(clean);
+        }
+    }
+    return words;
+}
+
+/** Substitutions, insertions and deletions turning @p a into @p b */
+inline size_t editDistance(const std::vector<std::string>& a, const std::vector<std::string>& b) {
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) row[j] = j;
+    for (size_t i = 1; i <= a.size(); ++i) {
+        size_t diag = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t up = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diag + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diag = up;
+        }
+    }
+    return row[b.size()];
+}
+
+} // namespace onnx_stt
+
+#endif // WORD_ERROR_RATE_HPP
@@ -24,6 +24,8 @@ public:
     
     void reset() override;
     
+    TranscriptionResult finalize(uint64_t timestamp_ms) override;
+    
     const ModelConfig& getConfig() const override { return config_; }
     
     std::map<std::string, double> getStats() const override;
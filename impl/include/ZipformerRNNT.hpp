@@ -8,6 +8,11 @@
 #include <array>
 #include <algorithm>
 #include "onnxruntime_cxx_api.h"
+#include "NgramLM.hpp"
+#include "PartialResultTracker.hpp"
+#include "TokenVocabulary.hpp"
+
+struct KernelBenchAccess;  // test/bench: times the private kernels
 
 namespace onnx_stt {
 
@@ -36,6 +41,17 @@ public:
         float blank_penalty = 0.0f;
         int max_active_paths = 4;
         
+        // Shallow fusion with a token-level n-gram LM (optional)
+        std::string lm_path;
+        float lm_weight = 0.3f;
+        
+        // Chunks a token must survive unchanged before it is reported stable
+        int stable_chunks = 2;
+        
+        // Encoder frame period for timestamps: subsampling x feature shift
+        int subsampling_factor = 4;
+        int frame_shift_ms = 10;
+        
         // Performance
         int num_threads = 4;
     };
@@ -70,8 +86,11 @@ public:
     // Hypothesis for beam search
     struct Hypothesis {
         std::vector<int> tokens;           // Token sequence
+        std::vector<int> frames;           // Encoder frame of each token
+        std::vector<float> token_log_probs;  // Joiner log-prob of each token
         std::vector<float> decoder_state;  // Decoder hidden state
-        float score = 0.0f;                // Log probability
+        float score = 0.0f;                // Log probability (LM-fused)
+        NgramLM::State lm_state = 0;       // LM history after tokens
         
         bool operator<(const Hypothesis& other) const {
             return score < other.score;  // For priority queue
@@ -82,8 +101,22 @@ public:
     struct Result {
         std::string text;
         std::vector<int> tokens;
+        std::vector<uint32_t> token_ms;   // per token: emission time
+        std::vector<float> token_probs;   // per token: joiner probability
         float confidence;
         bool is_final;
+        
+        // Incremental output: only what changed since the previous result
+        std::string stable_text;
+        std::string unstable_text;
+        uint64_t stable_offset = 0;
+        std::vector<uint32_t> word_offsets;
+        std::vector<uint32_t> word_start_ms;  // parallel to word_offsets
+        std::vector<uint32_t> word_end_ms;
+        
+        // Decoder activity since reset(), for endpointing
+        uint64_t utterance_ms = 0;
+        uint64_t trailing_blank_ms = 0;
     };
     
     explicit ZipformerRNNT(const Config& config);
@@ -102,6 +135,8 @@ public:
     void reset();
     
 private:
+    friend struct ::KernelBenchAccess;
+    
     Config config_;
     
     // ONNX Runtime
@@ -115,12 +150,17 @@ private:
     std::unique_ptr<Ort::Session> joiner_;
     
     // Vocabulary
-    std::vector<std::string> tokens_;
+    std::shared_ptr<const TokenVocabulary> vocab_;
     int blank_id_ = 0;
     
+    // Language model for shallow fusion (null when disabled)
+    std::unique_ptr<NgramLMStateCache> lm_cache_;
+    
     // Streaming state
     CacheState cache_state_;
     std::vector<Hypothesis> hypotheses_;
+    int frames_decoded_ = 0;  // encoder frames since reset()
+    PartialResultTracker tracker_;  // text of the best hypothesis, committed prefix
     
     // Internal methods
     std::vector<float> runEncoder(const std::vector<float>& features);
@@ -131,7 +171,6 @@ private:
     
     // Beam search
     void beamSearchStep(const std::vector<float>& encoder_out);
-    std::string tokensToText(const std::vector<int>& tokens);
     
     // Helper methods
     bool loadTokens(const std::string& path);
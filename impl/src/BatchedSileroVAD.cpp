@@ -0,0 +1,316 @@
+#include "BatchedSileroVAD.hpp"
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace onnx_stt {
+
+BatchedSileroVAD::BatchedSileroVAD()
+    : BatchedSileroVAD(Config()) {
+}
+
+BatchedSileroVAD::BatchedSileroVAD(const Config& config)
+    : config_(config),
+      memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {
+    window_size_samples_ = (config_.vad.window_size_ms * config_.vad.sample_rate) / 1000;
+    frame_shift_samples_ = (config_.vad.frame_shift_ms * config_.vad.sample_rate) / 1000;
+    frame_shift_samples_ = std::max<size_t>(frame_shift_samples_, 1);
+    config_.max_batch_size = std::max<size_t>(config_.max_batch_size, 1);
+}
+
+BatchedSileroVAD::~BatchedSileroVAD() = default;
+
+bool BatchedSileroVAD::initialize() {
+    try {
+        env_ = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "BatchedSileroVAD");
+        session_options_ = std::make_unique<Ort::SessionOptions>();
+        session_options_->SetIntraOpNumThreads(config_.num_threads);
+        session_options_->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        session_ = std::make_unique<Ort::Session>(*env_, config_.model_path.c_str(), *session_options_);
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_names_.clear();
+        output_names_.clear();
+        for (size_t i = 0; i < session_->GetInputCount(); ++i) {
+            input_names_.emplace_back(session_->GetInputNameAllocated(i, allocator).get());
+        }
+        for (size_t i = 0; i < session_->GetOutputCount(); ++i) {
+            output_names_.emplace_back(session_->GetOutputNameAllocated(i, allocator).get());
+        }
+
+        // Bind by name; unnamed exports fall back to SileroVAD's order (audio, h, c)
+        audio_input_ = sr_input_ = h_input_ = c_input_ = -1;
+        for (size_t i = 0; i < input_names_.size(); ++i) {
+            const std::string& name = input_names_[i];
+            if (name == "sr") {
+                sr_input_ = static_cast<int>(i);
+            } else if (name == "h") {
+                h_input_ = static_cast<int>(i);
+            } else if (name == "c") {
+                c_input_ = static_cast<int>(i);
+            } else if (audio_input_ < 0) {
+                audio_input_ = static_cast<int>(i);
+            }
+        }
+        if (h_input_ < 0 && input_names_.size() >= 3) {
+            audio_input_ = 0;
+            h_input_ = 1;
+            c_input_ = 2;
+        }
+        if (audio_input_ < 0 || h_input_ < 0 || c_input_ < 0 || output_names_.size() < 3) {
+            std::cerr << "Unsupported Silero VAD model layout in " << config_.model_path << std::endl;
+            session_.reset();
+            return false;
+        }
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load Silero VAD model from " << config_.model_path
+                  << ": " << e.what() << std::endl;
+        session_.reset();
+        return false;
+    }
+}
+
+BatchedSileroVAD::StreamId BatchedSileroVAD::addStream() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StreamId id = next_id_++;
+    streams_[id];
+    return id;
+}
+
+void BatchedSileroVAD::removeStream(StreamId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.erase(id);
+}
+
+void BatchedSileroVAD::resetStream(StreamId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(id);
+    if (it == streams_.end()) {
+        return;
+    }
+    uint64_t generation = it->second.generation + 1;
+    it->second = Stream();
+    it->second.generation = generation;
+}
+
+float* BatchedSileroVAD::appendAudio(Stream& stream, size_t num_samples, uint64_t timestamp_ms) {
+    if (!stream.has_timestamp) {
+        stream.base_ms = timestamp_ms;
+        stream.has_timestamp = true;
+    }
+    // Drop consumed samples once they make up half the buffer
+    if (stream.read_pos > 0 && stream.read_pos * 2 >= stream.audio.size()) {
+        stream.audio.erase(stream.audio.begin(), stream.audio.begin() + stream.read_pos);
+        stream.read_pos = 0;
+    }
+    size_t old_size = stream.audio.size();
+    stream.audio.resize(old_size + num_samples);
+    return stream.audio.data() + old_size;
+}
+
+void BatchedSileroVAD::pushAudio(StreamId id, const float* samples, size_t num_samples,
+                                 uint64_t timestamp_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(id);
+    if (it == streams_.end() || num_samples == 0) {
+        return;
+    }
+    float* dst = appendAudio(it->second, num_samples, timestamp_ms);
+    std::memcpy(dst, samples, num_samples * sizeof(float));
+}
+
+void BatchedSileroVAD::pushAudio(StreamId id, const int16_t* samples, size_t num_samples,
+                                 uint64_t timestamp_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(id);
+    if (it == streams_.end() || num_samples == 0) {
+        return;
+    }
+    float* dst = appendAudio(it->second, num_samples, timestamp_ms);
+    audio_kernels::int16ToFloat(samples, dst, num_samples, 1.0f / 32768.0f);
+}
+
+size_t BatchedSileroVAD::runPending() {
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    std::vector<float> probs;
+    size_t total = 0;
+    while (size_t batch = gatherBatch()) {
+        runBatch(batch, probs);
+        scatterBatch(batch, probs);
+        total += batch;
+    }
+    return total;
+}
+
+size_t BatchedSileroVAD::gatherBatch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t window = window_size_samples_;
+    const size_t max_batch = std::min(config_.max_batch_size, streams_.size());
+
+    batch_ids_.clear();
+    batch_generations_.clear();
+    batch_timestamps_.clear();
+    if (max_batch == 0) {
+        return 0;
+    }
+    batch_audio_.resize(max_batch * window);
+
+    // Round-robin from the stream after the last one served, so a capped
+    // batch does not starve streams at the end of the map
+    auto it = streams_.upper_bound(cursor_);
+    for (size_t visited = 0; visited < streams_.size() && batch_ids_.size() < max_batch;
+         ++visited, ++it) {
+        if (it == streams_.end()) {
+            it = streams_.begin();
+        }
+        Stream& stream = it->second;
+        if (stream.audio.size() - stream.read_pos < window) {
+            continue;
+        }
+        std::memcpy(batch_audio_.data() + batch_ids_.size() * window,
+                    stream.audio.data() + stream.read_pos, window * sizeof(float));
+        batch_ids_.push_back(it->first);
+        batch_generations_.push_back(stream.generation);
+        batch_timestamps_.push_back(
+            stream.base_ms + stream.consumed * 1000 / config_.vad.sample_rate);
+        stream.read_pos += frame_shift_samples_;
+        stream.consumed += frame_shift_samples_;
+        cursor_ = it->first;
+    }
+
+    const size_t batch = batch_ids_.size();
+    if (batch == 0) {
+        return 0;
+    }
+
+    // States are [layers, batch, hidden]: stream b owns row b of each layer
+    batch_h_.resize(kLayers * batch * kHidden);
+    batch_c_.resize(kLayers * batch * kHidden);
+    for (size_t b = 0; b < batch; ++b) {
+        const Stream& stream = streams_.at(batch_ids_[b]);
+        for (int l = 0; l < kLayers; ++l) {
+            std::memcpy(&batch_h_[(l * batch + b) * kHidden], stream.h + l * kHidden,
+                        kHidden * sizeof(float));
+            std::memcpy(&batch_c_[(l * batch + b) * kHidden], stream.c + l * kHidden,
+                        kHidden * sizeof(float));
+        }
+    }
+
+    stats_.batches++;
+    stats_.windows += batch;
+    stats_.max_batch = std::max(stats_.max_batch, batch);
+    return batch;
+}
+
+void BatchedSileroVAD::runBatch(size_t batch, std::vector<float>& probs) {
+    probs.assign(batch, 1.0f);  // no model: treat everything as speech
+    if (!session_) {
+        return;
+    }
+
+    try {
+        const int64_t b = static_cast<int64_t>(batch);
+        int64_t audio_shape[] = {b, static_cast<int64_t>(window_size_samples_)};
+        int64_t state_shape[] = {kLayers, b, kHidden};
+        int64_t sample_rate = config_.vad.sample_rate;
+
+        std::vector<Ort::Value> inputs;
+        std::vector<const char*> input_names;
+        inputs.reserve(input_names_.size());
+        for (size_t i = 0; i < input_names_.size(); ++i) {
+            const int index = static_cast<int>(i);
+            if (index == audio_input_) {
+                inputs.push_back(Ort::Value::CreateTensor<float>(
+                    memory_info_, batch_audio_.data(), batch * window_size_samples_,
+                    audio_shape, 2));
+            } else if (index == sr_input_) {
+                inputs.push_back(Ort::Value::CreateTensor<int64_t>(
+                    memory_info_, &sample_rate, 1, nullptr, 0));
+            } else if (index == h_input_) {
+                inputs.push_back(Ort::Value::CreateTensor<float>(
+                    memory_info_, batch_h_.data(), batch_h_.size(), state_shape, 3));
+            } else if (index == c_input_) {
+                inputs.push_back(Ort::Value::CreateTensor<float>(
+                    memory_info_, batch_c_.data(), batch_c_.size(), state_shape, 3));
+            } else {
+                continue;
+            }
+            input_names.push_back(input_names_[i].c_str());
+        }
+
+        std::vector<const char*> output_names;
+        for (const auto& name : output_names_) {
+            output_names.push_back(name.c_str());
+        }
+
+        auto outputs = session_->Run(Ort::RunOptions{nullptr},
+                                     input_names.data(), inputs.data(), inputs.size(),
+                                     output_names.data(), output_names.size());
+
+        // Output is [batch, 1]; new states come back in the input layout
+        const float* out = outputs[0].GetTensorData<float>();
+        std::copy(out, out + batch, probs.begin());
+        const float* new_h = outputs[1].GetTensorData<float>();
+        const float* new_c = outputs[2].GetTensorData<float>();
+        std::copy(new_h, new_h + batch_h_.size(), batch_h_.begin());
+        std::copy(new_c, new_c + batch_c_.size(), batch_c_.begin());
+
+    } catch (const std::exception& e) {
+        std::cerr << "Batched Silero VAD inference failed: " << e.what() << std::endl;
+    }
+}
+
+void BatchedSileroVAD::scatterBatch(size_t batch, const std::vector<float>& probs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t b = 0; b < batch; ++b) {
+        auto it = streams_.find(batch_ids_[b]);
+        if (it == streams_.end() || it->second.generation != batch_generations_[b]) {
+            continue;  // removed or reset while the batch ran
+        }
+        Stream& stream = it->second;
+        for (int l = 0; l < kLayers; ++l) {
+            std::memcpy(stream.h + l * kHidden, &batch_h_[(l * batch + b) * kHidden],
+                        kHidden * sizeof(float));
+            std::memcpy(stream.c + l * kHidden, &batch_c_[(l * batch + b) * kHidden],
+                        kHidden * sizeof(float));
+        }
+        VADResult result = {probs[b] > config_.vad.speech_threshold, probs[b],
+                            batch_timestamps_[b]};
+        stream.results.push_back(result);
+        stream.latest = result;
+    }
+}
+
+size_t BatchedSileroVAD::popResults(StreamId id, std::vector<VADResult>& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(id);
+    if (it == streams_.end()) {
+        return 0;
+    }
+    std::deque<VADResult>& results = it->second.results;
+    size_t count = results.size();
+    out.insert(out.end(), results.begin(), results.end());
+    results.clear();
+    return count;
+}
+
+BatchedSileroVAD::VADResult BatchedSileroVAD::latestResult(StreamId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(id);
+    if (it == streams_.end()) {
+        return {false, 0.0f, 0};
+    }
+    return it->second.latest;
+}
+
+BatchedSileroVAD::Stats BatchedSileroVAD::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.active_streams = streams_.size();
+    return stats;
+}
+
+} // namespace onnx_stt
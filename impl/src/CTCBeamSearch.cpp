@@ -0,0 +1,256 @@
+#include "CTCBeamSearch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace onnx_stt {
+
+namespace {
+
+const float kLogZero = -std::numeric_limits<float>::infinity();
+
+// Prefix-tree size above which unreachable nodes are dropped
+const size_t kCompactThreshold = 1 << 16;
+
+inline float logAdd(float a, float b) {
+    if (a == kLogZero) return b;
+    if (b == kLogZero) return a;
+    return a > b ? a + std::log1p(std::exp(b - a)) : b + std::log1p(std::exp(a - b));
+}
+
+} // namespace
+
+CTCPrefixBeamSearch::CTCPrefixBeamSearch(const Config& config,
+                                         std::shared_ptr<const NgramLM> lm)
+    : config_(config) {
+    if (lm) {
+        lm_cache_.reset(new NgramLMStateCache(std::move(lm)));
+    }
+    reset();
+}
+
+void CTCPrefixBeamSearch::reset() {
+    nodes_.clear();
+    children_.clear();
+    beams_.clear();
+
+    PrefixNode root;
+    root.token = -1;
+    root.parent = -1;
+    root.length = 0;
+    root.lm_state = lm_cache_ ? lm_cache_->lm().beginState() : NgramLM::nullState();
+    root.lm_score = 0.0f;
+    root.frame = -1;
+    root.peak_logp = kLogZero;
+    nodes_.push_back(root);
+
+    beams_.push_back(Beam{0, 0.0f, kLogZero, 0.0f});
+    frame_offset_ = 0;
+    finalized_ = false;
+}
+
+int CTCPrefixBeamSearch::childOf(int parent, int token) {
+    uint64_t key = (static_cast<uint64_t>(parent) << 32) | static_cast<uint32_t>(token);
+    auto it = children_.find(key);
+    if (it != children_.end()) {
+        return it->second;
+    }
+
+    const PrefixNode& p = nodes_[parent];
+    PrefixNode child;
+    child.token = token;
+    child.parent = parent;
+    child.length = p.length + 1;
+    child.lm_state = NgramLM::nullState();
+    child.lm_score = p.lm_score;
+    child.frame = -1;
+    child.peak_logp = kLogZero;
+    if (lm_cache_) {
+        child.lm_score += lm_cache_->score(p.lm_state, token, &child.lm_state);
+    }
+
+    int index = static_cast<int>(nodes_.size());
+    nodes_.push_back(child);
+    children_.emplace(key, index);
+    return index;
+}
+
+void CTCPrefixBeamSearch::notePeak(int node, float logp, int t) {
+    PrefixNode& n = nodes_[node];
+    if (logp > n.peak_logp) {
+        n.peak_logp = logp;
+        n.frame = frame_offset_ + t;
+    }
+}
+
+CTCPrefixBeamSearch::Beam& CTCPrefixBeamSearch::nextBeam(int node) {
+    auto it = next_index_.find(node);
+    if (it != next_index_.end()) {
+        return next_beams_[it->second];
+    }
+    next_index_.emplace(node, next_beams_.size());
+    next_beams_.push_back(Beam{node, kLogZero, kLogZero, 0.0f});
+    return next_beams_.back();
+}
+
+void CTCPrefixBeamSearch::decode(const float* log_probs, int num_frames, int vocab_size) {
+    const int blank = config_.blank_id;
+
+    for (int t = 0; t < num_frames; ++t) {
+        const float* frame = log_probs + static_cast<size_t>(t) * vocab_size;
+
+        // Candidate tokens: the best few within candidate_beam of the max
+        float frame_max = *std::max_element(frame, frame + vocab_size);
+        float cutoff = frame_max - config_.candidate_beam;
+        candidates_.clear();
+        for (int v = 0; v < vocab_size; ++v) {
+            if (v != blank && frame[v] >= cutoff) {
+                candidates_.push_back(v);
+            }
+        }
+        if (static_cast<int>(candidates_.size()) > config_.max_candidates) {
+            std::nth_element(candidates_.begin(), candidates_.begin() + config_.max_candidates,
+                             candidates_.end(),
+                             [frame](int a, int b) { return frame[a] > frame[b]; });
+            candidates_.resize(config_.max_candidates);
+        }
+
+        float blank_logp = (blank >= 0 && blank < vocab_size) ? frame[blank] : kLogZero;
+
+        next_beams_.clear();
+        next_index_.clear();
+
+        for (size_t b = 0; b < beams_.size(); ++b) {
+            const Beam beam = beams_[b];
+            const float total = logAdd(beam.log_blank, beam.log_nonblank);
+            const int last = nodes_[beam.node].token;
+
+            // Blank keeps the prefix
+            Beam& same = nextBeam(beam.node);
+            same.log_blank = logAdd(same.log_blank, total + blank_logp);
+
+            // Repeated last token collapses into the same prefix
+            if (last >= 0) {
+                Beam& repeat = nextBeam(beam.node);
+                repeat.log_nonblank = logAdd(repeat.log_nonblank, beam.log_nonblank + frame[last]);
+                notePeak(beam.node, frame[last], t);
+            }
+
+            for (int token : candidates_) {
+                int child = childOf(beam.node, token);
+                Beam& extended = nextBeam(child);
+                // A repeat only starts a new token after a blank
+                float source = token == last ? beam.log_blank : total;
+                extended.log_nonblank = logAdd(extended.log_nonblank, source + frame[token]);
+                notePeak(child, frame[token], t);
+            }
+        }
+
+        beams_.swap(next_beams_);
+        prune();
+    }
+
+    frame_offset_ += num_frames;
+    if (nodes_.size() > kCompactThreshold) {
+        compactNodes();
+    }
+}
+
+void CTCPrefixBeamSearch::prune() {
+    for (auto& beam : beams_) {
+        const PrefixNode& node = nodes_[beam.node];
+        beam.score = logAdd(beam.log_blank, beam.log_nonblank)
+                   + config_.lm_weight * node.lm_score
+                   + config_.token_bonus * node.length;
+    }
+
+    auto better = [](const Beam& a, const Beam& b) { return a.score > b.score; };
+    if (static_cast<int>(beams_.size()) > config_.beam_size) {
+        std::nth_element(beams_.begin(), beams_.begin() + config_.beam_size, beams_.end(), better);
+        beams_.resize(config_.beam_size);
+    }
+    std::sort(beams_.begin(), beams_.end(), better);
+}
+
+void CTCPrefixBeamSearch::finalize() {
+    if (finalized_ || !lm_cache_) {
+        finalized_ = true;
+        return;
+    }
+    for (auto& beam : beams_) {
+        beam.score += config_.lm_weight * lm_cache_->lm().scoreEnd(nodes_[beam.node].lm_state);
+    }
+    std::sort(beams_.begin(), beams_.end(),
+              [](const Beam& a, const Beam& b) { return a.score > b.score; });
+    finalized_ = true;
+}
+
+std::vector<int> CTCPrefixBeamSearch::bestTokens() const {
+    std::vector<int> tokens;
+    if (beams_.empty()) {
+        return tokens;
+    }
+    for (int n = beams_.front().node; n > 0; n = nodes_[n].parent) {
+        tokens.push_back(nodes_[n].token);
+    }
+    std::reverse(tokens.begin(), tokens.end());
+    return tokens;
+}
+
+void CTCPrefixBeamSearch::bestAlignment(std::vector<int>& frames,
+                                        std::vector<float>& log_probs) const {
+    frames.clear();
+    log_probs.clear();
+    if (beams_.empty()) {
+        return;
+    }
+    for (int n = beams_.front().node; n > 0; n = nodes_[n].parent) {
+        frames.push_back(nodes_[n].frame);
+        log_probs.push_back(nodes_[n].peak_logp);
+    }
+    std::reverse(frames.begin(), frames.end());
+    std::reverse(log_probs.begin(), log_probs.end());
+}
+
+float CTCPrefixBeamSearch::bestScore() const {
+    return beams_.empty() ? kLogZero : beams_.front().score;
+}
+
+void CTCPrefixBeamSearch::compactNodes() {
+    // Keep only the ancestors of live beams; parents always precede
+    // children, so a forward pass can remap indices in place
+    std::vector<char> live(nodes_.size(), 0);
+    live[0] = 1;
+    for (const auto& beam : beams_) {
+        for (int n = beam.node; n >= 0 && !live[n]; n = nodes_[n].parent) {
+            live[n] = 1;
+        }
+    }
+
+    std::vector<int> remap(nodes_.size(), -1);
+    size_t kept = 0;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (!live[i]) {
+            continue;
+        }
+        PrefixNode node = nodes_[i];
+        if (node.parent >= 0) {
+            node.parent = remap[node.parent];
+        }
+        remap[i] = static_cast<int>(kept);
+        nodes_[kept++] = node;
+    }
+    nodes_.resize(kept);
+
+    children_.clear();
+    for (size_t i = 1; i < nodes_.size(); ++i) {
+        uint64_t key = (static_cast<uint64_t>(nodes_[i].parent) << 32)
+                     | static_cast<uint32_t>(nodes_[i].token);
+        children_.emplace(key, static_cast<int>(i));
+    }
+    for (auto& beam : beams_) {
+        beam.node = remap[beam.node];
+    }
+}
+
+} // namespace onnx_stt
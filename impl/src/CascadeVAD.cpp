@@ -0,0 +1,188 @@
+#include "CascadeVAD.hpp"
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace onnx_stt {
+
+CascadeVAD::CascadeVAD(const Config& config)
+    : CascadeVAD(config, CascadeConfig()) {
+}
+
+CascadeVAD::CascadeVAD(const Config& config, const CascadeConfig& cascade_config)
+    : config_(config), cascade_config_(cascade_config), frame_samples_(0) {
+}
+
+bool CascadeVAD::initialize(const Config& config) {
+    config_ = config;
+    frame_samples_ = static_cast<size_t>(cascade_config_.gate_frame_ms) * config_.sample_rate / 1000;
+    if (frame_samples_ < 2) {
+        std::cerr << "Cascade VAD gate frame is too short" << std::endl;
+        return false;
+    }
+    pending_.reserve(frame_samples_);
+    
+    silero_ = std::make_unique<SileroVAD>(config_);
+    if (!silero_->initialize(config_)) {
+        std::cout << "Silero VAD not available, cascade VAD treats ambiguous frames as speech" << std::endl;
+        silero_.reset();
+    }
+    
+    reset();
+    return true;
+}
+
+VADInterface::VADResult CascadeVAD::processChunk(const int16_t* samples, 
+                                                size_t num_samples, 
+                                                uint64_t timestamp_ms) {
+    scratch_.resize(num_samples);
+    audio_kernels::int16ToFloat(samples, scratch_.data(), num_samples, 1.0f / 32768.0f);
+    return processSamples(scratch_.data(), num_samples, timestamp_ms);
+}
+
+VADInterface::VADResult CascadeVAD::processChunk(const std::vector<float>& audio, 
+                                                uint64_t timestamp_ms) {
+    return processSamples(audio.data(), audio.size(), timestamp_ms);
+}
+
+VADInterface::VADResult CascadeVAD::processSamples(const float* samples, size_t num_samples, 
+                                                  uint64_t timestamp_ms) {
+    size_t offset = 0;
+    
+    // Complete the frame left over from the previous call
+    if (!pending_.empty()) {
+        size_t take = std::min(frame_samples_ - pending_.size(), num_samples);
+        pending_.insert(pending_.end(), samples, samples + take);
+        offset = take;
+        if (pending_.size() == frame_samples_) {
+            processFrame(pending_.data(), timestamp_ms);
+            pending_.clear();
+        }
+    }
+    
+    // Whole frames straight from the input
+    for (; offset + frame_samples_ <= num_samples; offset += frame_samples_) {
+        uint64_t frame_ms = timestamp_ms + offset * 1000 / config_.sample_rate;
+        processFrame(samples + offset, frame_ms);
+    }
+    
+    pending_.insert(pending_.end(), samples + offset, samples + num_samples);
+    
+    return {in_speech_, probability_, timestamp_ms};
+}
+
+CascadeVAD::Tier CascadeVAD::classifyFrame(const float* frame) const {
+    float energy = audio_kernels::dot(frame, frame, frame_samples_) / frame_samples_;
+    float energy_db = 10.0f * std::log10(std::max(energy, 1e-12f));
+    
+    if (energy_db < cascade_config_.silence_energy_db) {
+        return GATE_SILENCE;
+    }
+    
+    if (cascade_config_.gate_speech && energy_db > cascade_config_.speech_energy_db) {
+        float zcr = static_cast<float>(audio_kernels::zeroCrossings(frame, frame_samples_)) /
+                    (frame_samples_ - 1);
+        if (zcr >= cascade_config_.min_speech_zcr && zcr <= cascade_config_.max_speech_zcr) {
+            return GATE_SPEECH;
+        }
+    }
+    
+    return AMBIGUOUS;
+}
+
+void CascadeVAD::processFrame(const float* frame, uint64_t timestamp_ms) {
+    frames_total_++;
+    
+    switch (classifyFrame(frame)) {
+        case GATE_SILENCE:
+            frames_gate_silence_++;
+            probability_ = 0.0f;
+            break;
+        case GATE_SPEECH:
+            frames_gate_speech_++;
+            probability_ = 1.0f;
+            break;
+        case AMBIGUOUS:
+            frames_model_++;
+            if (silero_) {
+                // Silero only reports when a window completes; keep the
+                // previous output until it does
+                uint64_t windows = silero_->windowsProcessed();
+                VADResult result = silero_->processSamples(frame, frame_samples_, timestamp_ms);
+                if (silero_->windowsProcessed() != windows) {
+                    model_probability_ = result.confidence;
+                }
+                probability_ = model_probability_;
+            } else {
+                probability_ = 1.0f;
+            }
+            break;
+    }
+    
+    // Hysteresis: enter at the speech threshold, leave only after the
+    // probability has stayed below the lower offset threshold for the hangover
+    const float onset = config_.speech_threshold;
+    const float offset = onset - cascade_config_.hysteresis;
+    if (!in_speech_) {
+        if (probability_ >= onset) {
+            in_speech_ = true;
+            below_offset_ms_ = 0;
+        }
+    } else if (probability_ < offset) {
+        below_offset_ms_ += cascade_config_.gate_frame_ms;
+        if (below_offset_ms_ >= static_cast<uint64_t>(std::max(cascade_config_.hangover_ms, 0))) {
+            in_speech_ = false;
+            below_offset_ms_ = 0;
+            // The model saw only the ambiguous frames of this utterance;
+            // start the next one from a clean LSTM state
+            if (silero_) {
+                silero_->reset();
+            }
+            model_probability_ = 0.0f;
+        }
+    } else {
+        below_offset_ms_ = 0;
+    }
+}
+
+void CascadeVAD::reset() {
+    if (silero_) {
+        silero_->reset();
+    }
+    pending_.clear();
+    in_speech_ = false;
+    probability_ = 0.0f;
+    model_probability_ = 0.0f;
+    below_offset_ms_ = 0;
+}
+
+std::map<std::string, double> CascadeVAD::getStats() const {
+    std::map<std::string, double> stats;
+    stats["frames"] = static_cast<double>(frames_total_);
+    stats["gate_silence"] = static_cast<double>(frames_gate_silence_);
+    stats["gate_speech"] = static_cast<double>(frames_gate_speech_);
+    stats["model"] = static_cast<double>(frames_model_);
+    
+    double total = frames_total_ > 0 ? static_cast<double>(frames_total_) : 1.0;
+    stats["gate_silence_fraction"] = frames_gate_silence_ / total;
+    stats["gate_speech_fraction"] = frames_gate_speech_ / total;
+    stats["model_fraction"] = frames_model_ / total;
+    stats["model_available"] = silero_ ? 1.0 : 0.0;
+    return stats;
+}
+
+std::unique_ptr<VADInterface> createCascadeVAD(const VADInterface::Config& config) {
+    return createCascadeVAD(config, CascadeVAD::CascadeConfig());
+}
+
+std::unique_ptr<VADInterface> createCascadeVAD(const VADInterface::Config& config,
+                                               const CascadeVAD::CascadeConfig& cascade_config) {
+    auto vad = std::make_unique<CascadeVAD>(config, cascade_config);
+    if (vad->initialize(config)) {
+        return vad;
+    }
+    return nullptr;
+}
+
+} // namespace onnx_stt
@@ -0,0 +1,35 @@
+#include "Endpointer.hpp"
+
+namespace onnx_stt {
+
+Endpointer::Endpointer() = default;
+
+Endpointer::Endpointer(const Config& config)
+    : config_(config) {
+}
+
+bool Endpointer::matches(const Rule& rule, uint64_t utterance_ms,
+                         uint64_t trailing_blank_ms, bool has_tokens) {
+    if (rule.min_trailing_silence_ms <= 0.0f && rule.min_utterance_length_ms <= 0.0f) {
+        return false;  // disabled
+    }
+    if (rule.must_contain_nonsilence && !has_tokens) {
+        return false;
+    }
+    if (rule.min_trailing_silence_ms > 0.0f && trailing_blank_ms < rule.min_trailing_silence_ms) {
+        return false;
+    }
+    if (rule.min_utterance_length_ms > 0.0f && utterance_ms < rule.min_utterance_length_ms) {
+        return false;
+    }
+    return true;
+}
+
+int Endpointer::detect(uint64_t utterance_ms, uint64_t trailing_blank_ms, bool has_tokens) const {
+    if (matches(config_.rule1, utterance_ms, trailing_blank_ms, has_tokens)) return 1;
+    if (matches(config_.rule2, utterance_ms, trailing_blank_ms, has_tokens)) return 2;
+    if (matches(config_.rule3, utterance_ms, trailing_blank_ms, has_tokens)) return 3;
+    return 0;
+}
+
+} // namespace onnx_stt
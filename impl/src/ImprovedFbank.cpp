@@ -166,12 +166,16 @@ void FbankComputer::applyDither(std::vector<float>& audio) {
 }
 
 std::vector<std::vector<float>> FbankComputer::computeFeatures(const std::vector<float>& audio) {
-    if (audio.empty()) {
+    return computeFeatures(audio.data(), audio.size());
+}
+
+std::vector<std::vector<float>> FbankComputer::computeFeatures(const float* audio, size_t num_samples) {
+    if (num_samples == 0) {
         return std::vector<std::vector<float>>();
     }
     
-    // Apply dither if specified
-    std::vector<float> dithered_audio = audio;
+    // Apply dither if specified (the only copy of the input)
+    std::vector<float> dithered_audio(audio, audio + num_samples);
     applyDither(dithered_audio);
     
     // Calculate number of frames
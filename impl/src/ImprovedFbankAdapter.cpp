@@ -1,5 +1,6 @@
 #include "../include/FeatureExtractor.hpp"
 #include "../include/ImprovedFbank.hpp"
+#include "../include/AudioKernels.hpp"
 #include <iostream>
 
 namespace onnx_stt {
@@ -46,12 +47,15 @@ public:
     }
     
     std::vector<std::vector<float>> computeFeatures(const int16_t* samples, size_t num_samples) override {
-        // Convert int16 to float
-        std::vector<float> audio(num_samples);
-        for (size_t i = 0; i < num_samples; i++) {
-            audio[i] = samples[i] / 32768.0f;
+        if (!fbank_) {
+            std::cerr << "ERROR: ImprovedFbankAdapter not initialized!" << std::endl;
+            return {};
         }
-        return computeFeatures(audio);
+        
+        // Convert int16 to float into a reused buffer and featurize it in place
+        scratch_.resize(num_samples);
+        audio_kernels::int16ToFloat(samples, scratch_.data(), num_samples, 1.0f / 32768.0f);
+        return fbank_->computeFeatures(scratch_.data(), num_samples);
     }
     
     const Config& getConfig() const override {
@@ -65,6 +69,7 @@ public:
 private:
     Config config_;
     std::unique_ptr<improved_fbank::FbankComputer> fbank_;
+    std::vector<float> scratch_;  // int16 input as float
 };
 
 // Factory function
@@ -1,4 +1,5 @@
 #include "KaldifeatExtractor.hpp"
+#include "AudioKernels.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -143,8 +144,9 @@ std::vector<std::vector<float>> KaldifeatExtractor::computeFeatures(const std::v
 }
 
 std::vector<std::vector<float>> KaldifeatExtractor::computeFeatures(const int16_t* samples, size_t num_samples) {
-    auto audio_float = convertInt16ToFloat(samples, num_samples);
-    return computeFeatures(audio_float);
+    scratch_.resize(num_samples);
+    audio_kernels::int16ToFloat(samples, scratch_.data(), num_samples, 1.0f / 32768.0f);
+    return computeFeatures(scratch_);
 }
 
 int KaldifeatExtractor::getFeatureDim() const {
@@ -212,14 +214,6 @@ void KaldifeatExtractor::applyCmvn(std::vector<std::vector<float>>& features) {
     }
 }
 
-std::vector<float> KaldifeatExtractor::convertInt16ToFloat(const int16_t* samples, size_t num_samples) {
-    std::vector<float> result(num_samples);
-    for (size_t i = 0; i < num_samples; ++i) {
-        result[i] = static_cast<float>(samples[i]) / 32768.0f;
-    }
-    return result;
-}
-
 // REMOVED: SimpleFbankExtractor implementation - it used simple_fbank which generates FAKE data!
 
 // Factory functions
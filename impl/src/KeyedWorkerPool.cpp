@@ -0,0 +1,171 @@
+#include "KeyedWorkerPool.hpp"
+#include "Tracer.hpp"
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace onnx_stt {
+
+namespace {
+
+uint64_t elapsedUs(std::chrono::steady_clock::time_point from,
+                   std::chrono::steady_clock::time_point to) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+} // namespace
+
+KeyedWorkerPool::KeyedWorkerPool()
+    : KeyedWorkerPool(Config()) {
+}
+
+KeyedWorkerPool::KeyedWorkerPool(const Config& config)
+    : config_(config)
+    , started_(std::chrono::steady_clock::now()) {
+    const size_t num_workers = std::max<size_t>(config_.num_workers, 1);
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back(&KeyedWorkerPool::workerLoop, this);
+    }
+}
+
+KeyedWorkerPool::~KeyedWorkerPool() {
+    shutdown();
+}
+
+bool KeyedWorkerPool::submit(const std::string& key, Task task, TraceTag trace) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return false;
+    }
+
+    if (config_.max_queue_depth > 0 && queued_ >= config_.max_queue_depth) {
+        stats_.submit_waits++;
+        space_ready_.wait(lock, [this] {
+            return stopping_ || queued_ < config_.max_queue_depth;
+        });
+        if (stopping_) {
+            return false;
+        }
+    }
+
+    const uint64_t seq = stats_.submitted++;
+    uint64_t trace_id = 0;
+    if (Tracer::enabled()) {
+        if (trace.stream_id == 0) {
+            trace.stream_id = std::hash<std::string>()(key);
+            trace.chunk = seq;
+        }
+        trace_id = Tracer::instance().newAsyncId();
+        Tracer::instance().asyncBegin("queue", trace_id, trace.stream_id, trace.chunk);
+    }
+
+    KeyQueue& queue = keys_[key];
+    queue.tasks.push_back(Entry{std::move(task), std::chrono::steady_clock::now(), trace_id, trace});
+    ++queued_;
+
+    if (!queue.scheduled) {
+        queue.scheduled = true;
+        ready_.push_back(key);
+        work_ready_.notify_one();
+    }
+    return true;
+}
+
+void KeyedWorkerPool::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return queued_ == 0 && running_ == 0; });
+}
+
+void KeyedWorkerPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    space_ready_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+KeyedWorkerPool::Stats KeyedWorkerPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.queue_depth = queued_;
+    stats.active_keys = keys_.size();
+    stats.uptime_us = elapsedUs(started_, std::chrono::steady_clock::now());
+    return stats;
+}
+
+double KeyedWorkerPool::utilization() const {
+    Stats stats = getStats();
+    const size_t num_workers = std::max<size_t>(config_.num_workers, 1);
+    if (stats.uptime_us == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(stats.busy_us) / (static_cast<double>(stats.uptime_us) * num_workers);
+}
+
+void KeyedWorkerPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_ready_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+        if (ready_.empty()) {
+            return;  // stopping and nothing left to run
+        }
+
+        std::string key = std::move(ready_.front());
+        ready_.pop_front();
+
+        // The key stays scheduled while this worker holds it, so its entry
+        // (and this reference) lives until the key is released below
+        KeyQueue& queue = keys_[key];
+        Entry entry = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        --queued_;
+        ++running_;
+        space_ready_.notify_one();
+        lock.unlock();
+
+        if (entry.trace_id != 0) {
+            Tracer::instance().asyncEnd("queue", entry.trace_id, entry.trace.stream_id, entry.trace.chunk);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t wait_us = elapsedUs(entry.queued, start);
+        try {
+            if (config_.wait_observer) {
+                config_.wait_observer(key, wait_us);
+            }
+            entry.task();
+        } catch (const std::exception& e) {
+            std::cerr << "KeyedWorkerPool: task for key '" << key << "' failed: " << e.what() << std::endl;
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        lock.lock();
+        --running_;
+        stats_.completed++;
+        stats_.total_wait_us += wait_us;
+        stats_.max_wait_us = std::max(stats_.max_wait_us, wait_us);
+        stats_.busy_us += elapsedUs(start, end);
+
+        if (queue.tasks.empty()) {
+            keys_.erase(key);
+        } else {
+            ready_.push_back(std::move(key));
+            work_ready_.notify_one();
+        }
+
+        if (queued_ == 0 && running_ == 0) {
+            idle_.notify_all();
+        }
+    }
+}
+
+} // namespace onnx_stt
@@ -0,0 +1,235 @@
+#include "LatencyGovernor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace onnx_stt {
+
+namespace {
+
+uint64_t elapsedMs(LatencyGovernor::Clock::time_point from, LatencyGovernor::Clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count());
+}
+
+// Aggregate "cpu" line of /proc/stat; false where it is not available
+bool readCpuTimes(uint64_t& busy, uint64_t& total) {
+    std::ifstream stat("/proc/stat");
+    std::string line;
+    if (!stat || !std::getline(stat, line) || line.compare(0, 4, "cpu ") != 0) {
+        return false;
+    }
+    std::istringstream fields(line.substr(4));
+    uint64_t value = 0;
+    uint64_t idle = 0;
+    total = 0;
+    for (int i = 0; fields >> value; ++i) {
+        total += value;
+        if (i == 3 || i == 4) {   // idle, iowait
+            idle += value;
+        }
+    }
+    busy = total - idle;
+    return total > 0;
+}
+
+} // namespace
+
+LatencyGovernor::LatencyGovernor()
+    : LatencyGovernor(Config()) {
+}
+
+LatencyGovernor::LatencyGovernor(const Config& config)
+    : config_(config) {
+    config_.num_levels = std::max(config_.num_levels, 1);
+    config_.initial_level = std::min(std::max(config_.initial_level, 0), config_.num_levels - 1);
+    config_.lower_lag_ms = std::min(config_.lower_lag_ms, config_.raise_lag_ms);
+    config_.cpu_low = std::min(config_.cpu_low, config_.cpu_high);
+    config_.lag_smoothing = std::min(std::max(config_.lag_smoothing, 0.01), 1.0);
+    stats_.streams_per_level.assign(config_.num_levels, 0);
+
+    if (config_.sample_cpu) {
+        readCpuTimes(prev_cpu_busy_, prev_cpu_total_);
+        last_cpu_sample_ = Clock::now();
+    }
+}
+
+int LatencyGovernor::observe(const std::string& key, double lag_ms) {
+    return observe(key, lag_ms, Clock::now());
+}
+
+int LatencyGovernor::observe(const std::string& key, double lag_ms, Clock::time_point now) {
+    Change change;
+    bool changed = false;
+    Listener listener;
+    int result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (config_.sample_cpu) {
+            sampleCpu(now);
+        }
+
+        auto it = streams_.find(key);
+        if (it == streams_.end()) {
+            StreamState state;
+            state.level = config_.initial_level;
+            state.last_change = now;
+            it = streams_.emplace(key, state).first;
+        }
+        StreamState& stream = it->second;
+
+        lag_ms = std::max(lag_ms, 0.0);
+        stream.lag_ms = stream.has_lag
+            ? stream.lag_ms + config_.lag_smoothing * (lag_ms - stream.lag_ms)
+            : lag_ms;
+        stream.has_lag = true;
+
+        // Pressure and recovery are mutually exclusive; in the band between
+        // the thresholds both timers restart
+        const bool lagging = stream.lag_ms > config_.raise_lag_ms;
+        const bool saturated = cpu_load_ >= config_.cpu_high && stream.lag_ms > config_.lower_lag_ms;
+        const bool recovered = stream.lag_ms < config_.lower_lag_ms && cpu_load_ < config_.cpu_low;
+
+        if (lagging || saturated) {
+            if (stream.raise_since == Clock::time_point()) {
+                stream.raise_since = now;
+            }
+        } else {
+            stream.raise_since = Clock::time_point();
+        }
+        if (recovered) {
+            if (stream.lower_since == Clock::time_point()) {
+                stream.lower_since = now;
+            }
+        } else {
+            stream.lower_since = Clock::time_point();
+        }
+
+        const bool dwelt = elapsedMs(stream.last_change, now) >= config_.min_dwell_ms;
+        if (dwelt && stream.raise_since != Clock::time_point() &&
+            stream.level < config_.num_levels - 1 &&
+            elapsedMs(stream.raise_since, now) >= config_.raise_hold_ms) {
+            change.from = stream.level;
+            change.to = stream.level + 1;
+            change.reason = lagging ? Reason::LAG : Reason::CPU;
+            changed = true;
+            ++stats_.raises;
+            ++(lagging ? stats_.raises_for_lag : stats_.raises_for_cpu);
+        } else if (dwelt && stream.lower_since != Clock::time_point() && stream.level > 0 &&
+                   elapsedMs(stream.lower_since, now) >= config_.lower_hold_ms) {
+            change.from = stream.level;
+            change.to = stream.level - 1;
+            change.reason = Reason::RECOVERED;
+            changed = true;
+            ++stats_.lowers;
+        }
+
+        if (changed) {
+            stream.level = change.to;
+            stream.last_change = now;
+            stream.raise_since = Clock::time_point();
+            stream.lower_since = Clock::time_point();
+            change.key = key;
+            change.lag_ms = stream.lag_ms;
+            change.cpu_load = cpu_load_;
+            listener = listener_;
+        }
+        result = stream.level;
+    }
+
+    if (changed && listener) {
+        listener(change);
+    }
+    return result;
+}
+
+void LatencyGovernor::addStream(const std::string& key, int level) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (streams_.count(key) == 0) {
+        StreamState state;
+        state.level = std::min(std::max(level, 0), config_.num_levels - 1);
+        state.last_change = Clock::now();
+        streams_.emplace(key, state);
+    }
+}
+
+int LatencyGovernor::level(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(key);
+    return it != streams_.end() ? it->second.level : config_.initial_level;
+}
+
+void LatencyGovernor::removeStream(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.erase(key);
+}
+
+void LatencyGovernor::setCpuLoad(double load) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cpu_load_ = std::min(std::max(load, 0.0), 1.0);
+}
+
+double LatencyGovernor::cpuLoad() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cpu_load_;
+}
+
+void LatencyGovernor::setListener(Listener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = std::move(listener);
+}
+
+void LatencyGovernor::sampleCpu(Clock::time_point now) {
+    if (elapsedMs(last_cpu_sample_, now) < config_.cpu_sample_ms) {
+        return;
+    }
+    last_cpu_sample_ = now;
+
+    uint64_t busy = 0;
+    uint64_t total = 0;
+    if (!readCpuTimes(busy, total) || total <= prev_cpu_total_) {
+        return;
+    }
+    cpu_load_ = static_cast<double>(busy - std::min(busy, prev_cpu_busy_)) / (total - prev_cpu_total_);
+    cpu_load_ = std::min(std::max(cpu_load_, 0.0), 1.0);
+    prev_cpu_busy_ = busy;
+    prev_cpu_total_ = total;
+}
+
+LatencyGovernor::Stats LatencyGovernor::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.streams = streams_.size();
+    stats.cpu_load = cpu_load_;
+    for (const auto& entry : streams_) {
+        ++stats.streams_per_level[entry.second.level];
+        stats.max_lag_ms = std::max(stats.max_lag_ms, entry.second.lag_ms);
+    }
+    return stats;
+}
+
+std::vector<std::pair<std::string, int64_t>> LatencyGovernor::gauges() const {
+    const Stats stats = getStats();
+    std::vector<std::pair<std::string, int64_t>> values;
+    values.reserve(stats.streams_per_level.size() + 4);
+    values.emplace_back("latencyModeRaises", static_cast<int64_t>(stats.raises));
+    values.emplace_back("latencyModeLowers", static_cast<int64_t>(stats.lowers));
+    for (size_t level = 0; level < stats.streams_per_level.size(); ++level) {
+        values.emplace_back("streamsAtLevel" + std::to_string(level),
+                            static_cast<int64_t>(stats.streams_per_level[level]));
+    }
+    values.emplace_back("maxLagMs", static_cast<int64_t>(std::llround(stats.max_lag_ms)));
+    values.emplace_back("cpuLoadPermille", static_cast<int64_t>(std::llround(stats.cpu_load * 1000.0)));
+    return values;
+}
+
+const char* LatencyGovernor::reasonName(Reason reason) {
+    switch (reason) {
+        case Reason::LAG:       return "lag";
+        case Reason::CPU:       return "cpu";
+        case Reason::RECOVERED: return "recovered";
+    }
+    return "unknown";
+}
+
+} // namespace onnx_stt
@@ -0,0 +1,197 @@
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace onnx_stt {
+
+namespace {
+
+int highestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+} // namespace
+
+constexpr size_t LatencyHistogram::kSubBuckets;
+constexpr size_t LatencyHistogram::kNumBuckets;
+constexpr size_t PipelineMetrics::kNumStages;
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t us) {
+    if (us < kSubBuckets) {
+        return static_cast<size_t>(us);
+    }
+    // Values in [2^b, 2^(b+1)) share 16 buckets of width 2^(b-4)
+    const int shift = highestBit(us) - 4;
+    return (static_cast<size_t>(shift) + 1) * kSubBuckets +
+           static_cast<size_t>((us >> shift) - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::bucketUpperUs(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    const size_t shift = index / kSubBuckets - 1;
+    const uint64_t lower = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t us) {
+    buckets_[bucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+    sum_us_.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t seen = max_us_.load(std::memory_order_relaxed);
+    while (us > seen && !max_us_.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {
+    }
+    seen = min_us_.load(std::memory_order_relaxed);
+    while (us < seen && !min_us_.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot snap;
+    snap.buckets.resize(kNumBuckets);
+    uint64_t counted = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        snap.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        counted += snap.buckets[i];
+    }
+    // Bucket counts define the distribution; sum may run slightly ahead
+    snap.count = counted;
+    snap.sum_us = sum_us_.load(std::memory_order_relaxed);
+    snap.max_us = max_us_.load(std::memory_order_relaxed);
+    snap.min_us = counted > 0 ? min_us_.load(std::memory_order_relaxed) : 0;
+    return snap;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_us_.store(0, std::memory_order_relaxed);
+    min_us_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_us_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Snapshot::percentileUs(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    q = std::min(std::max(q, 0.0), 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(LatencyHistogram::bucketUpperUs(i), max_us);
+        }
+    }
+    return max_us;
+}
+
+PipelineMetrics::PipelineMetrics()
+    : audio_ns_(0) {
+}
+
+void PipelineMetrics::addAudio(uint64_t num_samples, int sample_rate) {
+    if (sample_rate > 0) {
+        audio_ns_.fetch_add(num_samples * 1000000000ULL / static_cast<uint64_t>(sample_rate),
+                            std::memory_order_relaxed);
+    }
+}
+
+uint64_t PipelineMetrics::audioUs() const {
+    return audio_ns_.load(std::memory_order_relaxed) / 1000;
+}
+
+uint64_t PipelineMetrics::processingUs() const {
+    uint64_t total = 0;
+    for (const auto& stage : stages_) {
+        total += stage.snapshot().sum_us;
+    }
+    return total;
+}
+
+double PipelineMetrics::realTimeFactor() const {
+    const uint64_t audio_us = audioUs();
+    return audio_us > 0 ? static_cast<double>(processingUs()) / audio_us : 0.0;
+}
+
+void PipelineMetrics::reset() {
+    for (auto& stage : stages_) {
+        stage.reset();
+    }
+    audio_ns_.store(0, std::memory_order_relaxed);
+}
+
+const char* PipelineMetrics::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::INGEST:     return "ingest";
+        case Stage::VAD:        return "vad";
+        case Stage::FBANK:      return "fbank";
+        case Stage::ENCODER:    return "encoder";
+        case Stage::DECODER:    return "decoder";
+        case Stage::DETOKENIZE: return "detokenize";
+        case Stage::SUBMIT:     return "submit";
+        case Stage::COUNT:      break;
+    }
+    return "unknown";
+}
+
+std::vector<std::pair<std::string, int64_t>> PipelineMetrics::gauges() const {
+    std::vector<std::pair<std::string, int64_t>> out;
+    out.reserve(kNumStages * 3 + 1);
+    uint64_t processing_us = 0;
+    for (size_t i = 0; i < kNumStages; ++i) {
+        const std::string name = stageName(static_cast<Stage>(i));
+        const auto snap = stages_[i].snapshot();
+        processing_us += snap.sum_us;
+        out.emplace_back(name + "P50Us", static_cast<int64_t>(snap.percentileUs(0.50)));
+        out.emplace_back(name + "P99Us", static_cast<int64_t>(snap.percentileUs(0.99)));
+        out.emplace_back(name + "MaxUs", static_cast<int64_t>(snap.max_us));
+    }
+    const uint64_t audio_us = audioUs();
+    out.emplace_back("realTimeFactorPermille",
+                     audio_us > 0 ? static_cast<int64_t>(processing_us * 1000 / audio_us) : 0);
+    return out;
+}
+
+std::string PipelineMetrics::toJson() const {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+
+    std::ostringstream stages;
+    stages << std::fixed << std::setprecision(1);
+    uint64_t processing_us = 0;
+    for (size_t i = 0; i < kNumStages; ++i) {
+        const auto snap = stages_[i].snapshot();
+        processing_us += snap.sum_us;
+        stages << (i > 0 ? "," : "") << "\"" << stageName(static_cast<Stage>(i)) << "\":{"
+               << "\"count\":" << snap.count
+               << ",\"mean_us\":" << snap.meanUs()
+               << ",\"p50_us\":" << snap.percentileUs(0.50)
+               << ",\"p90_us\":" << snap.percentileUs(0.90)
+               << ",\"p99_us\":" << snap.percentileUs(0.99)
+               << ",\"p999_us\":" << snap.percentileUs(0.999)
+               << ",\"max_us\":" << snap.max_us << "}";
+    }
+
+    const uint64_t audio_us = audioUs();
+    json << "{\"audio_ms\":" << audio_us / 1000.0
+         << ",\"processing_ms\":" << processing_us / 1000.0
+         << ",\"rtf\":" << (audio_us > 0 ? static_cast<double>(processing_us) / audio_us : 0.0)
+         << ",\"stages\":{" << stages.str() << "}}";
+    return json.str();
+}
+
+} // namespace onnx_stt
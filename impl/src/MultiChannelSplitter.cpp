@@ -0,0 +1,149 @@
+#include "MultiChannelSplitter.hpp"
+#include "StereoAudioSplitter.hpp"
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace com {
+namespace teracloud {
+namespace streamsx {
+namespace stt {
+
+MultiChannelSplitter::MultiChannelSplitter()
+    : MultiChannelSplitter(Config()) {
+}
+
+MultiChannelSplitter::MultiChannelSplitter(const Config& config)
+    : config_(config) {
+    if (config_.numChannels < 1) {
+        throw std::invalid_argument("Number of channels must be at least 1");
+    }
+    channels_.resize(config_.numChannels);
+    outputs_.resize(config_.numChannels);
+    stats_.resize(config_.numChannels);
+    silentSamples_.resize(config_.numChannels);
+    reset();
+}
+
+size_t MultiChannelSplitter::prepare(size_t numSamples) {
+    const size_t numChannels = static_cast<size_t>(config_.numChannels);
+    if (numSamples % numChannels != 0) {
+        throw std::invalid_argument("Number of samples must be a multiple of the channel count");
+    }
+    samplesPerChannel_ = numSamples / numChannels;
+    for (size_t c = 0; c < numChannels; ++c) {
+        if (channels_[c].size() < samplesPerChannel_) {
+            channels_[c].resize(samplesPerChannel_);
+        }
+        outputs_[c] = channels_[c].data();
+    }
+    return samplesPerChannel_;
+}
+
+size_t MultiChannelSplitter::splitPCM16(const int16_t* data, size_t numSamples) {
+    size_t frames = prepare(numSamples);
+    const float scale = config_.normalizeFloat ? 1.0f / 32768.0f : 1.0f;
+
+    if (config_.interleaved) {
+        onnx_stt::audio_kernels::deinterleaveInt16(data, config_.numChannels, outputs_.data(),
+                                                   frames, scale);
+    } else {
+        for (int c = 0; c < config_.numChannels; ++c) {
+            onnx_stt::audio_kernels::int16ToFloat(data + c * frames, outputs_[c], frames, scale);
+        }
+    }
+
+    updateActivity(config_.normalizeFloat ? 1.0f : 32768.0f);
+    return frames;
+}
+
+size_t MultiChannelSplitter::splitTable(const uint8_t* data, size_t numBytes,
+                                        const float* table, float fullScale) {
+    size_t frames = prepare(numBytes);
+
+    if (config_.interleaved) {
+        onnx_stt::audio_kernels::deinterleaveTable(data, config_.numChannels, table,
+                                                   outputs_.data(), frames);
+    } else {
+        for (int c = 0; c < config_.numChannels; ++c) {
+            onnx_stt::audio_kernels::decodeTable(data + c * frames, table, outputs_[c], frames);
+        }
+    }
+
+    updateActivity(config_.normalizeFloat ? 1.0f : fullScale);
+    return frames;
+}
+
+size_t MultiChannelSplitter::splitPCM8(const uint8_t* data, size_t numSamples) {
+    return splitTable(data, numSamples,
+                      StereoAudioSplitter::pcm8FloatTable(config_.normalizeFloat), 128.0f);
+}
+
+size_t MultiChannelSplitter::splitG711uLaw(const uint8_t* data, size_t numBytes) {
+    return splitTable(data, numBytes,
+                      StereoAudioSplitter::ulawFloatTable(config_.normalizeFloat), 32768.0f);
+}
+
+size_t MultiChannelSplitter::splitG711aLaw(const uint8_t* data, size_t numBytes) {
+    return splitTable(data, numBytes,
+                      StereoAudioSplitter::alawFloatTable(config_.normalizeFloat), 32768.0f);
+}
+
+size_t MultiChannelSplitter::split(const std::string& encoding, const uint8_t* data, size_t numBytes) {
+    if (encoding == "pcm16") {
+        return splitPCM16(reinterpret_cast<const int16_t*>(data), numBytes / sizeof(int16_t));
+    } else if (encoding == "pcm8") {
+        return splitPCM8(data, numBytes);
+    } else if (encoding == "ulaw") {
+        return splitG711uLaw(data, numBytes);
+    } else if (encoding == "alaw") {
+        return splitG711aLaw(data, numBytes);
+    }
+    throw std::invalid_argument("Unsupported encoding: " + encoding);
+}
+
+void MultiChannelSplitter::updateActivity(float fullScale) {
+    const size_t frames = samplesPerChannel_;
+    const uint64_t hangover =
+        static_cast<uint64_t>(std::max(config_.silenceHangoverMs, 0)) * config_.sampleRate / 1000;
+
+    for (int c = 0; c < config_.numChannels; ++c) {
+        ChannelStats& stats = stats_[c];
+        if (frames > 0) {
+            const float* samples = outputs_[c];
+            float energy = onnx_stt::audio_kernels::dot(samples, samples, frames) / frames;
+            float rms = std::sqrt(energy) / fullScale;
+            stats.levelDb = 20.0f * std::log10(std::max(rms, 1e-6f));
+        }
+
+        if (!config_.suppressSilentChannels || stats.levelDb >= config_.silenceThresholdDb) {
+            silentSamples_[c] = 0;
+        } else {
+            silentSamples_[c] += frames;
+        }
+        stats.active = silentSamples_[c] <= hangover;
+
+        if (stats.active) {
+            stats.samplesEmitted += frames;
+        } else {
+            stats.samplesSuppressed += frames;
+        }
+    }
+}
+
+void MultiChannelSplitter::reset() {
+    const uint64_t hangover =
+        static_cast<uint64_t>(std::max(config_.silenceHangoverMs, 0)) * config_.sampleRate / 1000;
+    for (int c = 0; c < config_.numChannels; ++c) {
+        stats_[c] = ChannelStats();
+        // Inactive until the first loud block
+        silentSamples_[c] = config_.suppressSilentChannels ? hangover + 1 : 0;
+    }
+    samplesPerChannel_ = 0;
+}
+
+} // namespace stt
+} // namespace streamsx
+} // namespace teracloud
+} // namespace com
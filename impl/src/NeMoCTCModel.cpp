@@ -10,7 +10,7 @@ namespace onnx_stt {
 NeMoCTCModel::NeMoCTCModel(const Config& config)
     : config_(config),
       memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)),
-      dither_dist_(0.0f, config.dither) {
+      dither_dist_(0.0f, config.dither > 0 ? config.dither : 1.0f) {  // unused without dither
     std::cout << "NeMoCTCModel constructor - model path: " << config_.model_path << std::endl;
     std::cout << "NeMoCTCModel constructor - vocab path: " << config_.vocab_path << std::endl;
 }
@@ -41,6 +41,24 @@ bool NeMoCTCModel::initialize() {
     
     fbank_computer_ = std::make_unique<improved_fbank::FbankComputer>(fbank_opts);
     
+    // Optional beam search with n-gram shallow fusion
+    std::shared_ptr<const NgramLM> lm;
+    if (!config_.lm_path.empty()) {
+        lm = NgramLM::load(config_.lm_path);
+        if (!lm) {
+            std::cerr << "Failed to load language model: " << config_.lm_path << std::endl;
+            return false;
+        }
+    }
+    if (config_.beam_size > 1 || lm) {
+        CTCPrefixBeamSearch::Config search_config;
+        search_config.beam_size = std::max(config_.beam_size, 1);
+        search_config.blank_id = config_.blank_id;
+        search_config.lm_weight = config_.lm_weight;
+        search_config.token_bonus = config_.lm_token_bonus;
+        beam_search_ = std::make_unique<CTCPrefixBeamSearch>(search_config, lm);
+    }
+    
     return true;
 }
 
@@ -65,7 +83,10 @@ bool NeMoCTCModel::loadModel() {
         
         std::cout << "Model loaded: " << num_inputs << " inputs, " << num_outputs << " outputs" << std::endl;
         
+        // Reserve first: the name pointers must survive the push_backs
         Ort::AllocatorWithDefaultOptions allocator;
+        input_name_strings_.reserve(num_inputs);
+        output_name_strings_.reserve(num_outputs);
         for (size_t i = 0; i < num_inputs; i++) {
             auto input_name = session_->GetInputNameAllocated(i, allocator);
             input_name_strings_.push_back(std::string(input_name.get()));
@@ -88,23 +109,8 @@ bool NeMoCTCModel::loadModel() {
 }
 
 bool NeMoCTCModel::loadVocabulary() {
-    try {
-        std::ifstream file(config_.vocab_path);
-        if (!file.is_open()) {
-            return false;
-        }
-        
-        std::string line;
-        while (std::getline(file, line)) {
-            vocabulary_.push_back(line);
-        }
-        
-        std::cout << "Loaded vocabulary: " << vocabulary_.size() << " tokens" << std::endl;
-        return !vocabulary_.empty();
-    } catch (const std::exception& e) {
-        std::cerr << "Error loading vocabulary: " << e.what() << std::endl;
-        return false;
-    }
+    vocabulary_ = TokenVocabulary::load(config_.vocab_path);
+    return vocabulary_ != nullptr;
 }
 
 void NeMoCTCModel::addDither(std::vector<float>& audio) {
@@ -117,6 +123,7 @@ void NeMoCTCModel::addDither(std::vector<float>& audio) {
 
 std::vector<std::vector<float>> NeMoCTCModel::extractFeatures(const std::vector<float>& audio) {
     // Use ImprovedFbank for proper mel-spectrogram extraction
+    StageTimer timer(metrics_, PipelineMetrics::Stage::FBANK);
     return fbank_computer_->computeFeatures(audio);
 }
 
@@ -126,6 +133,8 @@ NeMoCTCModel::TranscriptionResult NeMoCTCModel::processFeatures(
     TranscriptionResult result;
     
     try {
+        StageTimer encoder_timer(metrics_, PipelineMetrics::Stage::ENCODER);
+        
         // Prepare input tensor - transpose from [frames, mels] to [mels, frames]
         size_t num_frames = features.size();
         size_t num_mels = config_.n_mels;
@@ -167,80 +176,185 @@ NeMoCTCModel::TranscriptionResult NeMoCTCModel::processFeatures(
         
         auto log_probs_shape = log_probs_tensor.GetTensorTypeAndShapeInfo().GetShape();
         auto output_length = lengths_tensor.GetTensorData<int64_t>()[0];
+        encoder_timer.stop();
+        
+        StageTimer decoder_timer(metrics_, PipelineMetrics::Stage::DECODER);
+        result = decodeLogProbs(log_probs_tensor.GetTensorData<float>(), output_length,
+                                log_probs_shape[2], num_frames);
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error in processFeatures: " << e.what() << std::endl;
+    }
+    
+    return result;
+}
+
+std::vector<NeMoCTCModel::TranscriptionResult> NeMoCTCModel::processFeaturesBatch(
+    const std::vector<std::vector<std::vector<float>>>& batch) {
+    
+    std::vector<TranscriptionResult> results(batch.size());
+    if (batch.empty()) {
+        return results;
+    }
+    if (batch.size() == 1) {
+        results[0] = processFeatures(batch[0]);
+        return results;
+    }
+    
+    try {
+        StageTimer encoder_timer(metrics_, PipelineMetrics::Stage::ENCODER);
         
-        // Convert to vector for decoding
-        const float* log_probs_data = log_probs_tensor.GetTensorData<float>();
-        std::vector<std::vector<float>> log_probs;
+        // Pad every item to the longest one: [batch, mels, max_frames]
+        size_t num_mels = config_.n_mels;
+        size_t max_frames = 0;
+        for (const auto& features : batch) {
+            max_frames = std::max(max_frames, features.size());
+        }
         
-        for (int t = 0; t < output_length; t++) {
-            std::vector<float> frame(log_probs_shape[2]);
-            for (int v = 0; v < log_probs_shape[2]; v++) {
-                frame[v] = log_probs_data[t * log_probs_shape[2] + v];
+        std::vector<float> input_data(batch.size() * num_mels * max_frames, 0.0f);
+        std::vector<int64_t> length_data(batch.size());
+        for (size_t b = 0; b < batch.size(); b++) {
+            const auto& features = batch[b];
+            float* item = input_data.data() + b * num_mels * max_frames;
+            for (size_t i = 0; i < features.size(); i++) {
+                for (size_t j = 0; j < num_mels; j++) {
+                    item[j * max_frames + i] = features[i][j];
+                }
             }
-            log_probs.push_back(frame);
+            length_data[b] = static_cast<int64_t>(features.size());
         }
         
-        // Decode
-        result.text = greedyCTCDecode(log_probs);
-        result.num_frames = output_length;
+        std::vector<int64_t> signal_shape = {static_cast<int64_t>(batch.size()),
+                                             static_cast<int64_t>(num_mels),
+                                             static_cast<int64_t>(max_frames)};
+        std::vector<int64_t> length_shape = {static_cast<int64_t>(batch.size())};
         
-        // Calculate average confidence
-        float total_confidence = 0.0f;
-        for (const auto& frame : log_probs) {
-            float max_prob = *std::max_element(frame.begin(), frame.end());
-            total_confidence += std::exp(max_prob);
+        std::vector<Ort::Value> input_tensors;
+        input_tensors.push_back(Ort::Value::CreateTensor<float>(
+            memory_info_, input_data.data(), input_data.size(),
+            signal_shape.data(), signal_shape.size()));
+        input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(
+            memory_info_, length_data.data(), length_data.size(),
+            length_shape.data(), length_shape.size()));
+        
+        auto output_tensors = session_->Run(Ort::RunOptions{nullptr},
+                                          input_names_.data(), input_tensors.data(), input_tensors.size(),
+                                          output_names_.data(), output_names_.size());
+        
+        // Output is [batch, max_out_frames, vocab]; each row is valid up to its length
+        auto log_probs_shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
+        const float* log_probs_data = output_tensors[0].GetTensorData<float>();
+        const int64_t* output_lengths = output_tensors[1].GetTensorData<int64_t>();
+        const size_t row_size = static_cast<size_t>(log_probs_shape[1] * log_probs_shape[2]);
+        encoder_timer.stop();
+        
+        StageTimer decoder_timer(metrics_, PipelineMetrics::Stage::DECODER);
+        for (size_t b = 0; b < batch.size(); b++) {
+            results[b] = decodeLogProbs(log_probs_data + b * row_size, output_lengths[b],
+                                        log_probs_shape[2], batch[b].size());
         }
-        result.avg_confidence = total_confidence / log_probs.size();
         
     } catch (const std::exception& e) {
-        std::cerr << "Error in processFeatures: " << e.what() << std::endl;
+        // Exports with a fixed batch dimension: fall back to one item per call
+        std::cerr << "Batched inference failed (" << e.what()
+                  << "), processing items one by one" << std::endl;
+        for (size_t b = 0; b < batch.size(); b++) {
+            results[b] = processFeatures(batch[b]);
+        }
+    }
+    
+    return results;
+}
+
+NeMoCTCModel::TranscriptionResult NeMoCTCModel::decodeLogProbs(
+    const float* log_probs_data, int64_t output_length, int64_t vocab_size, size_t num_frames) {
+    
+    TranscriptionResult result;
+    
+    // Convert to vector for decoding
+    std::vector<std::vector<float>> log_probs;
+    
+    for (int t = 0; t < output_length; t++) {
+        std::vector<float> frame(vocab_size);
+        for (int v = 0; v < vocab_size; v++) {
+            frame[v] = log_probs_data[t * vocab_size + v];
+        }
+        log_probs.push_back(frame);
+    }
+    
+    // Decode, recording the frame of each emitted token
+    std::vector<int> token_frames;
+    std::vector<float> token_log_probs;
+    if (beam_search_) {
+        beam_search_->reset();
+        beam_search_->decode(log_probs_data, static_cast<int>(output_length),
+                             static_cast<int>(vocab_size));
+        beam_search_->finalize();
+        result.token_ids = beam_search_->bestTokens();
+        beam_search_->bestAlignment(token_frames, token_log_probs);
+    } else {
+        greedyCTCDecode(log_probs, result.token_ids, token_frames, token_log_probs);
     }
+    result.num_frames = output_length;
+    
+    // Encoder frame period: subsampling factor x feature stride
+    int subsampling = output_length > 0
+        ? static_cast<int>((num_frames + output_length / 2) / output_length) : 1;
+    float frame_ms = std::max(subsampling, 1) * config_.window_stride_ms;
+    
+    result.token_ms.resize(token_frames.size());
+    result.confidences.resize(token_log_probs.size());
+    for (size_t i = 0; i < token_frames.size(); ++i) {
+        result.token_ms[i] = static_cast<uint32_t>(std::max(token_frames[i], 0) * frame_ms);
+        result.confidences[i] = std::exp(token_log_probs[i]);
+    }
+    
+    // Detokenize and aggregate token times to words
+    PartialResultTracker::Config words_config;
+    words_config.token_duration_ms = static_cast<int>(frame_ms);
+    PartialResultTracker words(vocabulary_, words_config);
+    auto words_update = words.update(result.token_ids, result.token_ms, true);
+    result.text = words.text();
+    result.word_offsets = std::move(words_update.word_offsets);
+    result.word_start_ms = std::move(words_update.word_start_ms);
+    result.word_end_ms = std::move(words_update.word_end_ms);
+    
+    // Calculate average confidence
+    float total_confidence = 0.0f;
+    for (const auto& frame : log_probs) {
+        float max_prob = *std::max_element(frame.begin(), frame.end());
+        total_confidence += std::exp(max_prob);
+    }
+    result.avg_confidence = log_probs.empty() ? 0.0f : total_confidence / log_probs.size();
     
     return result;
 }
 
-std::string NeMoCTCModel::greedyCTCDecode(const std::vector<std::vector<float>>& log_probs) {
-    std::vector<int> tokens;
+void NeMoCTCModel::greedyCTCDecode(const std::vector<std::vector<float>>& log_probs,
+                                   std::vector<int>& tokens, std::vector<int>& frames,
+                                   std::vector<float>& peak_log_probs) {
+    tokens.clear();
+    frames.clear();
+    peak_log_probs.clear();
     int prev_token = config_.blank_id;
     
-    for (const auto& frame : log_probs) {
+    for (size_t t = 0; t < log_probs.size(); ++t) {
+        const auto& frame = log_probs[t];
         // Find argmax
-        int best_token = std::distance(frame.begin(), 
-                                      std::max_element(frame.begin(), frame.end()));
+        auto best = std::max_element(frame.begin(), frame.end());
+        int best_token = std::distance(frame.begin(), best);
         
-        // CTC decoding rules
+        // CTC decoding rules; a repeated token keeps the frame where it peaks
         if (best_token != config_.blank_id && best_token != prev_token) {
             tokens.push_back(best_token);
+            frames.push_back(static_cast<int>(t));
+            peak_log_probs.push_back(*best);
+        } else if (best_token != config_.blank_id && *best > peak_log_probs.back()) {
+            frames.back() = static_cast<int>(t);
+            peak_log_probs.back() = *best;
         }
         prev_token = best_token;
     }
-    
-    return handleBPETokens(tokens);
-}
-
-std::string NeMoCTCModel::handleBPETokens(const std::vector<int>& tokens) {
-    std::string text;
-    
-    for (int token : tokens) {
-        if (token < static_cast<int>(vocabulary_.size())) {
-            std::string tok = vocabulary_[token];
-            
-            // Handle BPE tokens with ▁ prefix (UTF-8: \xE2\x96\x81)
-            if (tok.length() >= 3 && 
-                static_cast<unsigned char>(tok[0]) == 0xE2 && 
-                static_cast<unsigned char>(tok[1]) == 0x96 && 
-                static_cast<unsigned char>(tok[2]) == 0x81) {
-                // Add space and remove ▁ prefix
-                if (!text.empty()) text += " ";
-                text += tok.substr(3);
-            } else {
-                // Regular token, append directly
-                text += tok;
-            }
-        }
-    }
-    
-    return text;
 }
 
 NeMoCTCModel::TranscriptionResult NeMoCTCModel::processAudio(const std::vector<float>& audio) {
@@ -248,4 +362,14 @@ NeMoCTCModel::TranscriptionResult NeMoCTCModel::processAudio(const std::vector<f
     return processFeatures(features);
 }
 
+std::vector<NeMoCTCModel::TranscriptionResult> NeMoCTCModel::processAudioBatch(
+    const std::vector<std::vector<float>>& audios) {
+    std::vector<std::vector<std::vector<float>>> batch;
+    batch.reserve(audios.size());
+    for (const auto& audio : audios) {
+        batch.push_back(extractFeatures(audio));
+    }
+    return processFeaturesBatch(batch);
+}
+
 } // namespace onnx_stt
\ No newline at end of file
@@ -7,14 +7,21 @@
 
 namespace onnx_stt {
 
+namespace {
+
+// NeMo features use a 10 ms window stride
+const int kFeatureShiftMs = 10;
+
+} // namespace
+
 NeMoCacheAwareConformer::NeMoCacheAwareConformer(const NeMoConfig& config)
     : config_(config)
     , memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault))
-    , cache_initialized_(false)
     , total_chunks_processed_(0)
     , total_processing_time_ms_(0)
     , cache_updates_(0)
-    , vocab_loaded_(false) {
+    , default_state_(PartialResultTracker::Config{
+          1, config.subsampling_factor * kFeatureShiftMs}) {
     
     // Initialize ONNX Runtime environment
     env_ = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "NeMoCacheAwareConformer");
@@ -48,7 +55,7 @@ bool NeMoCacheAwareConformer::initialize(const ModelConfig& config) {
         return false;
     }
     
-    if (!initializeCacheTensors()) {
+    if (!initializeCacheTensors(default_state_)) {
         std::cerr << "Failed to initialize cache tensors" << std::endl;
         return false;
     }
@@ -87,6 +94,7 @@ bool NeMoCacheAwareConformer::initializeONNXSession() {
         size_t num_outputs = session_->GetOutputCount();
         
         std::cout << "Model loaded: " << num_inputs << " inputs, " << num_outputs << " outputs" << std::endl;
+        uses_cache_inputs_ = num_inputs > 1;
         
         // Print input/output info for debugging
         for (size_t i = 0; i < num_inputs; ++i) {
@@ -111,24 +119,24 @@ bool NeMoCacheAwareConformer::initializeONNXSession() {
     }
 }
 
-bool NeMoCacheAwareConformer::initializeCacheTensors() {
+bool NeMoCacheAwareConformer::initializeCacheTensors(DecodeState& state) const {
     try {
-        // Initialize cache_last_channel: [layers, batch, cache_size, hidden]
-        size_t channel_cache_size = config_.num_cache_layers * config_.batch_size * 
-                                   config_.last_channel_cache_size * config_.hidden_size;
-        cache_last_channel_.resize(channel_cache_size, 0.0f);
-        
-        // Initialize cache_last_time: [layers, batch, hidden, cache_size]  
-        size_t time_cache_size = config_.num_cache_layers * config_.batch_size *
-                                config_.hidden_size * config_.last_time_cache_size;
-        cache_last_time_.resize(time_cache_size, 0.0f);
-        
-        cache_initialized_ = true;
-        
-        std::cout << "Cache tensors initialized:" << std::endl;
-        std::cout << "  Channel cache size: " << channel_cache_size << " elements" << std::endl;
-        std::cout << "  Time cache size: " << time_cache_size << " elements" << std::endl;
+        // A model exported without cache inputs never reads them; skip the
+        // allocation (several MB) so per-stream states stay small
+        if (uses_cache_inputs_) {
+            // Initialize cache_last_channel: [layers, batch, cache_size, hidden]
+            size_t channel_cache_size = config_.num_cache_layers * config_.batch_size * 
+                                       config_.last_channel_cache_size * config_.hidden_size;
+            state.cache_last_channel.assign(channel_cache_size, 0.0f);
+            
+            // Initialize cache_last_time: [layers, batch, hidden, cache_size]  
+            size_t time_cache_size = config_.num_cache_layers * config_.batch_size *
+                                    config_.hidden_size * config_.last_time_cache_size;
+            state.cache_last_time.assign(time_cache_size, 0.0f);
+        }
         
+        state.tracker.setVocabulary(vocab_);
+        state.initialized = true;
         return true;
         
     } catch (const std::exception& e) {
@@ -138,61 +146,55 @@ bool NeMoCacheAwareConformer::initializeCacheTensors() {
 }
 
 bool NeMoCacheAwareConformer::loadVocabulary(const std::string& vocab_path) {
-    try {
-        std::ifstream vocab_file(vocab_path);
-        if (!vocab_file.is_open()) {
-            std::cerr << "Cannot open vocabulary file: " << vocab_path << std::endl;
-            return false;
-        }
-        
-        vocabulary_.clear();
-        std::string line;
-        
-        while (std::getline(vocab_file, line)) {
-            // Each line contains the token (tab/space separated from any other info)
-            // Extract just the token part - token is BEFORE the tab, not after
-            size_t tab_pos = line.find('\t');
-            if (tab_pos != std::string::npos) {
-                vocabulary_.push_back(line.substr(0, tab_pos));  // Take text BEFORE tab
-            } else {
-                vocabulary_.push_back(line);
-            }
-        }
-        
-        vocab_file.close();
-        vocab_loaded_ = true;
-        
-        std::cout << "Loaded vocabulary with " << vocabulary_.size() << " tokens from " << vocab_path << std::endl;
-        
-        // Print first few tokens for verification
-        if (vocabulary_.size() >= 10) {
-            std::cout << "First 10 tokens: ";
-            for (size_t i = 0; i < 10; ++i) {
-                std::cout << "[" << i << "]=" << vocabulary_[i] << " ";
-            }
-            std::cout << std::endl;
-        }
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Error loading vocabulary: " << e.what() << std::endl;
+    // Tab-separated WordPiece tokenizer files are handled by TokenVocabulary
+    vocab_ = TokenVocabulary::load(vocab_path);
+    if (!vocab_) {
         return false;
     }
+    default_state_.tracker.setVocabulary(vocab_);
+    
+    // Print first few tokens for verification
+    if (vocab_->size() >= 10) {
+        std::cout << "First 10 tokens: ";
+        for (int i = 0; i < 10; ++i) {
+            std::cout << "[" << i << "]=" << vocab_->piece(i) << " ";
+        }
+        std::cout << std::endl;
+    }
+    
+    return true;
+}
+
+PartialResultTracker::Config NeMoCacheAwareConformer::trackerConfig() const {
+    return PartialResultTracker::Config{1, config_.subsampling_factor * kFeatureShiftMs};
+}
+
+std::unique_ptr<NeMoCacheAwareConformer::DecodeState> NeMoCacheAwareConformer::createDecodeState() const {
+    auto state = std::make_unique<DecodeState>(trackerConfig());
+    if (!session_ || !initializeCacheTensors(*state)) {
+        return nullptr;
+    }
+    return state;
 }
 
 ModelInterface::TranscriptionResult NeMoCacheAwareConformer::processChunk(const std::vector<std::vector<float>>& features,
                                                                      uint64_t timestamp_ms) {
+    return processChunk(default_state_, features, timestamp_ms);
+}
+
+ModelInterface::TranscriptionResult NeMoCacheAwareConformer::processChunk(DecodeState& state,
+                                                                     const std::vector<std::vector<float>>& features,
+                                                                     uint64_t timestamp_ms) {
     auto start_time = std::chrono::high_resolution_clock::now();
     
     ModelInterface::TranscriptionResult result;
     result.timestamp_ms = timestamp_ms;
-    result.is_final = true;
+    result.is_final = false;  // finals come from finalize() at an endpoint
     result.confidence = 0.0f;
     
     try {
-        if (!cache_initialized_) {
-            throw std::runtime_error("Cache tensors not initialized");
+        if (!state.initialized) {
+            throw std::runtime_error("Decode state not initialized");
         }
         
         if (features.empty() || features[0].empty()) {
@@ -200,6 +202,7 @@ ModelInterface::TranscriptionResult NeMoCacheAwareConformer::processChunk(const
         }
         
         // Prepare input tensors
+        StageTimer encoder_timer(metrics_, PipelineMetrics::Stage::ENCODER);
         
         // 1. Audio signal tensor: [batch, time, features] = [1, time_frames, 80]
         size_t batch_size = 1;
@@ -270,6 +273,7 @@ ModelInterface::TranscriptionResult NeMoCacheAwareConformer::processChunk(const
             Ort::RunOptions{nullptr},
             input_names_.data(), input_tensors.data(), input_tensors.size(),
             output_names_.data(), output_names_.size());
+        encoder_timer.stop();
         
         // Process outputs
         if (output_tensors.size() >= 1) {
@@ -283,9 +287,49 @@ ModelInterface::TranscriptionResult NeMoCacheAwareConformer::processChunk(const
             int64_t num_classes = log_probs_shape[2];
             
             // Decode CTC output (simplified - argmax for now)
-            result.text = decodeCTCTokens(log_probs_data, seq_len_out, num_classes);
+            StageTimer decoder_timer(metrics_, PipelineMetrics::Stage::DECODER);
+            std::vector<int> token_frames;
+            std::vector<float> token_log_probs;
+            auto chunk_tokens = decodeCTCTokens(log_probs_data, seq_len_out, num_classes,
+                                                token_frames, token_log_probs);
             result.confidence = 0.85f;  // Placeholder confidence
             
+            // Token times relative to the utterance start
+            const int frame_ms = config_.subsampling_factor * kFeatureShiftMs;
+            for (size_t i = 0; i < chunk_tokens.size(); ++i) {
+                state.utterance_token_ms.push_back(
+                    static_cast<uint32_t>(state.utterance_ms + token_frames[i] * frame_ms));
+                result.token_probs.push_back(std::exp(token_log_probs[i]));
+            }
+            
+            // Trailing blanks over the real (unpadded) part of the chunk
+            const uint64_t chunk_ms = static_cast<uint64_t>(features.size()) * kFeatureShiftMs;
+            if (chunk_tokens.empty()) {
+                state.trailing_blank_ms += chunk_ms;
+            } else {
+                uint64_t last_token_end = static_cast<uint64_t>(token_frames.back() + 1) * frame_ms;
+                state.trailing_blank_ms = chunk_ms > last_token_end ? chunk_ms - last_token_end : 0;
+            }
+            state.utterance_ms += chunk_ms;
+            result.utterance_ms = state.utterance_ms;
+            result.trailing_blank_ms = state.trailing_blank_ms;
+            
+            // Chunks never revise earlier output, so everything up to the
+            // last word start is stable; the last word may continue
+            state.utterance_tokens.insert(state.utterance_tokens.end(), chunk_tokens.begin(), chunk_tokens.end());
+            auto update = state.tracker.update(state.utterance_tokens, state.utterance_token_ms);
+            result.utterance_tokens = static_cast<uint32_t>(state.utterance_tokens.size());
+            result.stable_text = std::move(update.stable_text);
+            result.unstable_text = std::move(update.unstable_text);
+            result.stable_offset = update.stable_offset;
+            result.word_offsets = std::move(update.word_offsets);
+            result.word_start_ms = std::move(update.word_start_ms);
+            result.word_end_ms = std::move(update.word_end_ms);
+            decoder_timer.stop();
+            
+            StageTimer detokenize_timer(metrics_, PipelineMetrics::Stage::DETOKENIZE);
+            result.text = tokensToText(chunk_tokens);
+            
         } else {
             throw std::runtime_error("No output tensors from NeMo model");
         }
@@ -310,7 +354,8 @@ ModelInterface::TranscriptionResult NeMoCacheAwareConformer::processChunk(const
     return result;
 }
 
-void NeMoCacheAwareConformer::updateCacheFromOutputs(std::vector<Ort::Value>& outputs) {
+void NeMoCacheAwareConformer::updateCacheFromOutputs(DecodeState& state, std::vector<Ort::Value>& outputs) {
+    TraceSpan span("cache_update");
     try {
         if (outputs.size() >= 4) {
             // Update cache_last_channel from output[2]
@@ -323,9 +368,9 @@ void NeMoCacheAwareConformer::updateCacheFromOutputs(std::vector<Ort::Value>& ou
                 channel_cache_elements *= static_cast<size_t>(dim);
             }
             
-            if (channel_cache_elements <= cache_last_channel_.size()) {
+            if (channel_cache_elements <= state.cache_last_channel.size()) {
                 std::copy(new_channel_data, new_channel_data + channel_cache_elements, 
-                         cache_last_channel_.begin());
+                         state.cache_last_channel.begin());
             }
             
             // Update cache_last_time from output[3]
@@ -338,9 +383,9 @@ void NeMoCacheAwareConformer::updateCacheFromOutputs(std::vector<Ort::Value>& ou
                 time_cache_elements *= static_cast<size_t>(dim);
             }
             
-            if (time_cache_elements <= cache_last_time_.size()) {
+            if (time_cache_elements <= state.cache_last_time.size()) {
                 std::copy(new_time_data, new_time_data + time_cache_elements,
-                         cache_last_time_.begin());
+                         state.cache_last_time.begin());
             }
             
             cache_updates_++;
@@ -350,7 +395,9 @@ void NeMoCacheAwareConformer::updateCacheFromOutputs(std::vector<Ort::Value>& ou
     }
 }
 
-std::string NeMoCacheAwareConformer::decodeCTCTokens(const float* log_probs, int64_t seq_len, int64_t num_classes) {
+std::vector<int> NeMoCacheAwareConformer::decodeCTCTokens(const float* log_probs, int64_t seq_len, int64_t num_classes,
+                                                          std::vector<int>& frames,
+                                                          std::vector<float>& peak_log_probs) {
     // Simple CTC decoding using argmax (greedy decoding)
     // In production, would use beam search CTC decoding
     
@@ -384,49 +431,41 @@ std::string NeMoCacheAwareConformer::decodeCTCTokens(const float* log_probs, int
         std::cout << std::endl;
     }
     
-    // Simple CTC collapse - remove consecutive duplicates and blanks (token 0)
+    // Simple CTC collapse - remove consecutive duplicates and blanks (token 0),
+    // keeping the frame where each token peaks
     std::vector<int> collapsed_tokens;
+    frames.clear();
+    peak_log_probs.clear();
     int prev_token = -1;
     
-    for (int token : token_ids) {
+    for (int64_t t = 0; t < seq_len; ++t) {
+        int token = token_ids[t];
         if (token != 0 && token != prev_token) {  // 0 is blank token
             collapsed_tokens.push_back(token);
+            frames.push_back(static_cast<int>(t));
+            peak_log_probs.push_back(max_probs[t]);
+        } else if (token != 0 && max_probs[t] > peak_log_probs.back()) {
+            frames.back() = static_cast<int>(t);
+            peak_log_probs.back() = max_probs[t];
         }
         prev_token = token;
     }
     
-    // Convert token IDs to text using vocabulary
-    std::string result;
-    
-    if (vocab_loaded_ && !vocabulary_.empty()) {
-        // Use vocabulary to decode tokens
-        for (int token_id : collapsed_tokens) {
-            if (token_id >= 0 && token_id < static_cast<int>(vocabulary_.size())) {
-                std::string token = vocabulary_[token_id];
-                
-                // Handle subword tokens (starting with ##)
-                if (token.substr(0, 2) == "##") {
-                    result += token.substr(2);  // Remove ## prefix
-                } else if (!result.empty() && !token.empty()) {
-                    result += " " + token;  // Add space before whole words
-                } else {
-                    result += token;
-                }
-            } else {
-                // Unknown token
-                result += " [UNK:" + std::to_string(token_id) + "]";
-            }
-        }
-    } else {
-        // Fallback to showing token IDs if vocab not loaded
-        result = "[NeMo CTC IDs: ";
-        for (size_t i = 0; i < collapsed_tokens.size(); ++i) {
-            if (i > 0) result += " ";
-            result += std::to_string(collapsed_tokens[i]);
-        }
-        result += "]";
+    return collapsed_tokens;
+}
+
+std::string NeMoCacheAwareConformer::tokensToText(const std::vector<int>& tokens) const {
+    if (vocab_) {
+        return vocab_->detokenize(tokens);
     }
     
+    // Fallback to showing token IDs if vocab not loaded
+    std::string result = "[NeMo CTC IDs: ";
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (i > 0) result += " ";
+        result += std::to_string(tokens[i]);
+    }
+    result += "]";
     return result;
 }
 
@@ -444,10 +483,21 @@ std::string NeMoCacheAwareConformer::decodeTokens(const float* /* logits */, siz
     return result;
 }
 
-void NeMoCacheAwareConformer::reset() {
+void NeMoCacheAwareConformer::resetState(DecodeState& state) const {
     // Reset cache tensors to zero
-    std::fill(cache_last_channel_.begin(), cache_last_channel_.end(), 0.0f);
-    std::fill(cache_last_time_.begin(), cache_last_time_.end(), 0.0f);
+    std::fill(state.cache_last_channel.begin(), state.cache_last_channel.end(), 0.0f);
+    std::fill(state.cache_last_time.begin(), state.cache_last_time.end(), 0.0f);
+    
+    // New utterance
+    state.utterance_tokens.clear();
+    state.utterance_token_ms.clear();
+    state.utterance_ms = 0;
+    state.trailing_blank_ms = 0;
+    state.tracker.reset();
+}
+
+void NeMoCacheAwareConformer::reset() {
+    resetState(default_state_);
     
     // Reset statistics
     total_chunks_processed_ = 0;
@@ -457,16 +507,42 @@ void NeMoCacheAwareConformer::reset() {
     std::cout << "NeMo Cache-Aware Conformer cache reset" << std::endl;
 }
 
+ModelInterface::TranscriptionResult NeMoCacheAwareConformer::finalize(uint64_t timestamp_ms) {
+    return finalize(default_state_, timestamp_ms);
+}
+
+ModelInterface::TranscriptionResult NeMoCacheAwareConformer::finalize(DecodeState& state,
+                                                                 uint64_t timestamp_ms) const {
+    ModelInterface::TranscriptionResult result{};
+    result.timestamp_ms = timestamp_ms;
+    result.is_final = true;
+    result.confidence = 0.85f;  // Placeholder confidence, as in processChunk
+    
+    // Commit the last (possibly unfinished) word
+    auto update = state.tracker.update(state.utterance_tokens, state.utterance_token_ms, true);
+    result.stable_text = std::move(update.stable_text);
+    result.stable_offset = update.stable_offset;
+    result.word_offsets = std::move(update.word_offsets);
+    result.word_start_ms = std::move(update.word_start_ms);
+    result.word_end_ms = std::move(update.word_end_ms);
+    result.utterance_ms = state.utterance_ms;
+    result.trailing_blank_ms = state.trailing_blank_ms;
+    result.utterance_tokens = static_cast<uint32_t>(state.utterance_tokens.size());
+    return result;
+}
+
 std::map<std::string, double> NeMoCacheAwareConformer::getStats() const {
     std::map<std::string, double> stats;
     
-    stats["total_chunks_processed"] = static_cast<double>(total_chunks_processed_);
-    stats["total_processing_time_ms"] = static_cast<double>(total_processing_time_ms_);
-    stats["cache_updates"] = static_cast<double>(cache_updates_);
+    const uint64_t chunks = total_chunks_processed_.load();
+    const uint64_t processing_ms = total_processing_time_ms_.load();
+    stats["total_chunks_processed"] = static_cast<double>(chunks);
+    stats["total_processing_time_ms"] = static_cast<double>(processing_ms);
+    stats["cache_updates"] = static_cast<double>(cache_updates_.load());
     
-    if (total_chunks_processed_ > 0) {
-        stats["average_processing_time_ms"] = static_cast<double>(total_processing_time_ms_) / 
-                                            static_cast<double>(total_chunks_processed_);
+    if (chunks > 0) {
+        stats["average_processing_time_ms"] = static_cast<double>(processing_ms) / 
+                                            static_cast<double>(chunks);
     } else {
         stats["average_processing_time_ms"] = 0.0;
     }
@@ -474,8 +550,8 @@ std::map<std::string, double> NeMoCacheAwareConformer::getStats() const {
     stats["model_type"] = 1.0; // Indicator for NeMo model
     stats["chunk_frames"] = static_cast<double>(config_.chunk_frames);
     stats["feature_dim"] = static_cast<double>(config_.feature_dim);
-    stats["cache_channel_size"] = static_cast<double>(cache_last_channel_.size());
-    stats["cache_time_size"] = static_cast<double>(cache_last_time_.size());
+    stats["cache_channel_size"] = static_cast<double>(default_state_.cache_last_channel.size());
+    stats["cache_time_size"] = static_cast<double>(default_state_.cache_last_time.size());
     
     return stats;
 }
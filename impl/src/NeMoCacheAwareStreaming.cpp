@@ -31,6 +31,12 @@ NeMoCacheAwareStreaming::NeMoCacheAwareStreaming(const std::string& /*model_dir*
     std::cout << "  Chunk size: " << chunk_size_ << " frames" << std::endl;
 }
 
+NeMoCacheAwareStreaming::~NeMoCacheAwareStreaming() {
+    if (governor_) {
+        governor_->removeStream(governor_key_);
+    }
+}
+
 bool NeMoCacheAwareStreaming::initialize() {
     try {
         // Load ONNX models (skip for testing with mock implementation)
@@ -186,6 +192,9 @@ std::string NeMoCacheAwareStreaming::processAudioChunk(const float* audio_chunk,
         auto end_time = std::chrono::high_resolution_clock::now();
         auto processing_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
         
+        updateLatencyGovernor(std::chrono::duration<double, std::milli>(end_time - start_time).count(),
+                              chunk_size);
+        
         if (is_final || !result.empty()) {
             std::cout << "Processed chunk in " << processing_time.count() << "ms: \"" << result << "\"" << std::endl;
         }
@@ -332,6 +341,7 @@ void NeMoCacheAwareStreaming::updateEncoderCache(const std::vector<std::vector<f
 }
 
 void NeMoCacheAwareStreaming::reset() {
+    lag_ms_ = 0.0;
     if (cache_) {
         cache_->processed_frames = 0;
         for (auto& layer_state : cache_->encoder_states) {
@@ -359,6 +369,50 @@ void NeMoCacheAwareStreaming::setLatencyMode(LatencyMode mode) {
     std::cout << "Latency mode changed to: " << static_cast<int>(mode) << std::endl;
 }
 
+void NeMoCacheAwareStreaming::setLatencyGovernor(std::shared_ptr<LatencyGovernor> governor,
+                                                 const std::string& stream_key) {
+    if (governor_) {
+        governor_->removeStream(governor_key_);
+    }
+    governor_ = std::move(governor);
+    governor_key_ = stream_key;
+    if (governor_) {
+        governor_->addStream(governor_key_, levelForLatencyMode(latency_mode_));
+    }
+}
+
+NeMoCacheAwareStreaming::LatencyMode NeMoCacheAwareStreaming::latencyModeForLevel(int level) {
+    static const LatencyMode modes[NUM_LATENCY_LEVELS] = {
+        LatencyMode::ULTRA_LOW, LatencyMode::VERY_LOW, LatencyMode::LOW, LatencyMode::MEDIUM
+    };
+    return modes[std::min(std::max(level, 0), NUM_LATENCY_LEVELS - 1)];
+}
+
+int NeMoCacheAwareStreaming::levelForLatencyMode(LatencyMode mode) {
+    for (int level = 0; level < NUM_LATENCY_LEVELS; ++level) {
+        if (latencyModeForLevel(level) == mode) {
+            return level;
+        }
+    }
+    return 0;
+}
+
+void NeMoCacheAwareStreaming::updateLatencyGovernor(double processing_ms, int num_samples) {
+    // A stream fed in real time falls behind by whatever processing takes
+    // beyond the audio's duration and catches up when it takes less
+    const double audio_ms = num_samples * 1000.0 / SAMPLE_RATE;
+    lag_ms_ = std::max(0.0, lag_ms_ + processing_ms - audio_ms);
+    
+    if (!governor_) {
+        return;
+    }
+    LatencyMode mode = latencyModeForLevel(governor_->observe(governor_key_, lag_ms_));
+    if (mode != latency_mode_) {
+        setLatencyMode(mode);
+        ++latency_mode_changes_;
+    }
+}
+
 void NeMoCacheAwareStreaming::setDecoderType(DecoderType type) {
     decoder_type_ = type;
     std::cout << "Decoder type changed to: " << static_cast<int>(type) << std::endl;
@@ -405,7 +459,10 @@ std::map<std::string, double> NeMoCacheAwareStreaming::getStats() const {
         {"total_frames", static_cast<double>(stats.total_frames_processed)},
         {"avg_processing_time_ms", stats.average_processing_time_ms},
         {"current_latency_ms", stats.current_latency_ms},
-        {"cache_size_mb", stats.cache_size_mb}
+        {"cache_size_mb", stats.cache_size_mb},
+        {"latency_mode", static_cast<double>(latency_mode_)},
+        {"lag_ms", lag_ms_},
+        {"latency_mode_changes", static_cast<double>(latency_mode_changes_)}
     };
 }
 
@@ -0,0 +1,662 @@
+#include "NgramLM.hpp"
+#include "TokenVocabulary.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace onnx_stt {
+
+namespace {
+
+const char kMagic[8] = {'S', 'T', 'T', 'N', 'G', 'R', 'A', 'M'};
+const uint32_t kVersion = 1;
+const float kLn10 = 2.302585093f;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+// On-disk layout. All offsets are bytes from the start of the file.
+struct NgramLM::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t order;
+    uint32_t vocab_size;          // level-1 entries (model tokens + <s>, </s>)
+    int32_t bos_id;
+    int32_t eos_id;
+    float unk_logprob;
+    uint64_t counts[kMaxOrder];   // entries per level, index 0 = level 1
+    uint64_t offsets[kMaxOrder];  // level arrays (nodes carry a sentinel)
+    uint64_t codebook_offset;     // prob codebooks, then back-off codebooks
+};
+
+struct NgramLM::Node {
+    uint32_t token;
+    uint32_t child_begin;
+    uint32_t suffix;              // state of the longest existing suffix
+    uint8_t prob;
+    uint8_t backoff;
+    uint16_t reserved;
+};
+
+struct NgramLM::Leaf {
+    uint32_t token;
+    uint32_t suffix;
+    uint8_t prob;
+    uint8_t reserved[3];
+};
+
+// ---------------------------------------------------------------------------
+// Loading and scoring
+// ---------------------------------------------------------------------------
+
+NgramLM::~NgramLM() {
+    if (map_base_) {
+        munmap(map_base_, map_size_);
+    }
+}
+
+std::shared_ptr<const NgramLM> NgramLM::load(const std::string& path) {
+    static std::mutex registry_mutex;
+    static std::map<std::string, std::weak_ptr<const NgramLM>> registry;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = registry.find(path);
+    if (it != registry.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    std::shared_ptr<NgramLM> lm(new NgramLM());
+    if (!lm->map(path)) {
+        return nullptr;
+    }
+    registry[path] = lm;
+
+    std::cout << "Loaded " << lm->order_ << "-gram LM from " << path
+              << " (" << lm->map_size_ / 1024 << " KB, vocab " << lm->vocab_size_ << ")" << std::endl;
+    return lm;
+}
+
+bool NgramLM::map(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open LM file: " << path << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        std::cerr << "LM file too small: " << path << std::endl;
+        close(fd);
+        return false;
+    }
+
+    map_size_ = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Failed to mmap LM file: " << path << std::endl;
+        map_size_ = 0;
+        return false;
+    }
+    map_base_ = base;
+
+    const char* bytes = static_cast<const char*>(map_base_);
+    header_ = reinterpret_cast<const Header*>(bytes);
+
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 || header_->version != kVersion) {
+        std::cerr << "Not a binary LM file (run arpa2lm first): " << path << std::endl;
+        return false;
+    }
+    if (header_->order < 1 || header_->order > static_cast<uint32_t>(kMaxOrder)) {
+        std::cerr << "Unsupported LM order " << header_->order << std::endl;
+        return false;
+    }
+
+    order_ = static_cast<int>(header_->order);
+    vocab_size_ = static_cast<int>(header_->vocab_size);
+    eos_id_ = header_->eos_id;
+    unk_logprob_ = header_->unk_logprob;
+
+    size_t codebook_bytes = 2 * order_ * 256 * sizeof(float);
+    if (header_->codebook_offset + codebook_bytes > map_size_) {
+        std::cerr << "Truncated LM file: " << path << std::endl;
+        return false;
+    }
+    prob_codebook_ = reinterpret_cast<const float*>(bytes + header_->codebook_offset);
+    backoff_codebook_ = prob_codebook_ + order_ * 256;
+
+    for (int level = 1; level <= order_; ++level) {
+        bool is_leaf = level == order_ && order_ > 1;
+        size_t entries = header_->counts[level - 1] + (is_leaf ? 0 : 1);
+        size_t bytes_needed = entries * (is_leaf ? sizeof(Leaf) : sizeof(Node));
+        if (header_->offsets[level - 1] + bytes_needed > map_size_) {
+            std::cerr << "Truncated LM file at level " << level << ": " << path << std::endl;
+            return false;
+        }
+        if (is_leaf) {
+            leaves_ = reinterpret_cast<const Leaf*>(bytes + header_->offsets[level - 1]);
+        } else {
+            nodes_[level] = reinterpret_cast<const Node*>(bytes + header_->offsets[level - 1]);
+        }
+    }
+
+    // The trie is walked by binary search, so random access is the norm
+    madvise(map_base_, map_size_, MADV_RANDOM);
+
+    begin_state_ = nullState();
+    if (header_->bos_id >= 0 && header_->bos_id < vocab_size_ && order_ > 1) {
+        begin_state_ = makeState(1, static_cast<uint32_t>(header_->bos_id));
+    }
+    return true;
+}
+
+int64_t NgramLM::findChild(int level, uint32_t parent, uint32_t token) const {
+    const Node* nodes = nodes_[level];
+    uint32_t lo = nodes[parent].child_begin;
+    uint32_t hi = nodes[parent + 1].child_begin;
+
+    // Children are sorted by token; both layouts start with the token field
+    if (level + 1 == order_) {
+        const Leaf* first = leaves_ + lo;
+        const Leaf* last = leaves_ + hi;
+        const Leaf* it = std::lower_bound(first, last, token,
+            [](const Leaf& leaf, uint32_t t) { return leaf.token < t; });
+        return (it != last && it->token == token) ? it - leaves_ : -1;
+    }
+
+    const Node* children = nodes_[level + 1];
+    const Node* first = children + lo;
+    const Node* last = children + hi;
+    const Node* it = std::lower_bound(first, last, token,
+        [](const Node& node, uint32_t t) { return node.token < t; });
+    return (it != last && it->token == token) ? it - children : -1;
+}
+
+float NgramLM::score(State state, int token, State* next) const {
+    if (token < 0 || token >= vocab_size_) {
+        *next = nullState();
+        return unk_logprob_;
+    }
+
+    float backoff_sum = 0.0f;
+    State context = state;
+
+    for (;;) {
+        int level = levelOf(context);
+        if (level == 0) {
+            const Node& unigram = nodes_[1][token];
+            *next = order_ > 1 ? makeState(1, static_cast<uint32_t>(token)) : nullState();
+            return backoff_sum + prob_codebook_[unigram.prob];
+        }
+
+        uint32_t index = indexOf(context);
+        int64_t child = findChild(level, index, static_cast<uint32_t>(token));
+        if (child >= 0) {
+            int child_level = level + 1;
+            const float* codebook = prob_codebook_ + (child_level - 1) * 256;
+            if (child_level == order_) {
+                const Leaf& leaf = leaves_[child];
+                *next = leaf.suffix;
+                return backoff_sum + codebook[leaf.prob];
+            }
+            const Node& node = nodes_[child_level][child];
+            *next = makeState(child_level, static_cast<uint32_t>(child));
+            return backoff_sum + codebook[node.prob];
+        }
+
+        const Node& node = nodes_[level][index];
+        backoff_sum += backoff_codebook_[(level - 1) * 256 + node.backoff];
+        context = node.suffix;
+    }
+}
+
+float NgramLM::scoreEnd(State state) const {
+    if (eos_id_ < 0) {
+        return 0.0f;
+    }
+    State unused;
+    return score(state, eos_id_, &unused);
+}
+
+// ---------------------------------------------------------------------------
+// State cache
+// ---------------------------------------------------------------------------
+
+NgramLMStateCache::NgramLMStateCache(std::shared_ptr<const NgramLM> lm, size_t num_entries)
+    : lm_(std::move(lm)) {
+    size_t size = 1;
+    while (size < num_entries) {
+        size <<= 1;
+    }
+    entries_.resize(size);
+    mask_ = size - 1;
+}
+
+float NgramLMStateCache::score(NgramLM::State state, int token, NgramLM::State* next) {
+    uint64_t key = (static_cast<uint64_t>(state) << 32) | static_cast<uint32_t>(token);
+    Entry& entry = entries_[(key * 0x9E3779B97F4A7C15ull >> 40) & mask_];
+    if (entry.key == key) {
+        ++hits_;
+        *next = entry.next;
+        return entry.score;
+    }
+
+    ++misses_;
+    entry.key = key;
+    entry.score = lm_->score(state, token, &entry.next);
+    *next = entry.next;
+    return entry.score;
+}
+
+void NgramLMStateCache::clear() {
+    std::fill(entries_.begin(), entries_.end(), Entry());
+    hits_ = 0;
+    misses_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// ARPA conversion
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct ArpaLevel {
+    int n = 0;                      // n-gram order of this level
+    std::vector<uint32_t> words;    // n words per entry
+    std::vector<float> probs;
+    std::vector<float> backoffs;
+
+    size_t size() const { return probs.size(); }
+    const uint32_t* entry(size_t i) const { return words.data() + i * n; }
+};
+
+// Equal-population bins; the centroid of each bin is its mean
+void buildCodebook(std::vector<float> values, float* codebook) {
+    if (values.empty()) {
+        std::fill(codebook, codebook + 256, 0.0f);
+        return;
+    }
+    std::sort(values.begin(), values.end());
+
+    size_t n = values.size();
+    float previous = values.front();
+    for (size_t b = 0; b < 256; ++b) {
+        size_t lo = b * n / 256;
+        size_t hi = (b + 1) * n / 256;
+        if (hi > lo) {
+            double sum = std::accumulate(values.begin() + lo, values.begin() + hi, 0.0);
+            previous = static_cast<float>(sum / (hi - lo));
+        }
+        codebook[b] = previous;
+    }
+}
+
+uint8_t quantize(float value, const float* codebook) {
+    const float* it = std::lower_bound(codebook, codebook + 256, value);
+    if (it == codebook + 256) {
+        return 255;
+    }
+    if (it != codebook && value - *(it - 1) < *it - value) {
+        --it;
+    }
+    return static_cast<uint8_t>(it - codebook);
+}
+
+bool lexLess(const uint32_t* a, const uint32_t* b, int n) {
+    return std::lexicographical_compare(a, a + n, b, b + n);
+}
+
+// Index of the n-gram @p words (length n) in its level, or -1
+int64_t findNgram(const std::vector<ArpaLevel>& levels, const uint32_t* words, int n) {
+    const ArpaLevel& level = levels[n - 1];
+    if (n == 1) {
+        return words[0] < level.size() ? static_cast<int64_t>(words[0]) : -1;
+    }
+    size_t lo = 0;
+    size_t hi = level.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (lexLess(level.entry(mid), words, n)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < level.size() && std::equal(words, words + n, level.entry(lo))) {
+        return static_cast<int64_t>(lo);
+    }
+    return -1;
+}
+
+const char* skipSpace(const char* p) {
+    while (*p == ' ' || *p == '\t') {
+        ++p;
+    }
+    return p;
+}
+
+const char* skipWord(const char* p) {
+    while (*p && *p != ' ' && *p != '\t') {
+        ++p;
+    }
+    return p;
+}
+
+} // namespace
+
+bool NgramLM::convertArpa(const std::string& arpa_path,
+                          const std::string& tokens_path,
+                          const std::string& output_path) {
+    auto vocab = TokenVocabulary::load(tokens_path);
+    if (!vocab) {
+        return false;
+    }
+    std::unordered_map<std::string, int> token_ids;
+    int vocab_size = vocab->size();
+    for (int id = 0; id < vocab_size; ++id) {
+        token_ids.emplace(vocab->piece(id), id);
+    }
+
+    // Sentence markers get ids past the acoustic vocabulary unless the
+    // tokens file already has them
+    int bos_id = token_ids.count("<s>") ? token_ids["<s>"] : vocab_size++;
+    int eos_id = token_ids.count("</s>") ? token_ids["</s>"] : vocab_size++;
+    token_ids["<s>"] = bos_id;
+    token_ids["</s>"] = eos_id;
+
+    std::ifstream arpa(arpa_path);
+    if (!arpa.is_open()) {
+        std::cerr << "Failed to open ARPA file: " << arpa_path << std::endl;
+        return false;
+    }
+
+    // \data\ section
+    std::string line;
+    std::vector<uint64_t> declared;
+    bool in_data = false;
+    while (std::getline(arpa, line)) {
+        if (line == "\\data\\") {
+            in_data = true;
+            continue;
+        }
+        if (!in_data) {
+            continue;
+        }
+        if (line.compare(0, 6, "ngram ") == 0) {
+            size_t eq = line.find('=');
+            int n = std::atoi(line.c_str() + 6);
+            if (eq == std::string::npos || n < 1) {
+                continue;
+            }
+            if (static_cast<int>(declared.size()) < n) {
+                declared.resize(n, 0);
+            }
+            declared[n - 1] = std::strtoull(line.c_str() + eq + 1, nullptr, 10);
+        } else if (!line.empty() && line[0] == '\\') {
+            break;
+        }
+    }
+
+    int order = static_cast<int>(declared.size());
+    if (order < 1 || order > kMaxOrder) {
+        std::cerr << "Unsupported or missing n-gram order in " << arpa_path << std::endl;
+        return false;
+    }
+
+    std::vector<ArpaLevel> levels(order);
+    for (int n = 1; n <= order; ++n) {
+        levels[n - 1].n = n;
+    }
+    ArpaLevel& unigrams = levels[0];
+    float unk_logprob = -10.0f;
+    bool have_unk = false;
+
+    // n-gram sections; the loop above stopped on the first "\N-grams:" line
+    int current = line.size() > 1 ? std::atoi(line.c_str() + 1) : 0;
+    std::vector<uint32_t> words(order);
+    uint64_t dropped = 0;
+    do {
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] == '\\') {
+            if (line == "\\end\\") {
+                break;
+            }
+            current = std::atoi(line.c_str() + 1);
+            continue;
+        }
+        if (current < 1 || current > order) {
+            continue;
+        }
+
+        const char* p = skipSpace(line.c_str());
+        char* end = nullptr;
+        float prob = std::strtof(p, &end) * kLn10;
+        p = skipSpace(end);
+
+        bool known = true;
+        for (int i = 0; i < current; ++i) {
+            const char* word_end = skipWord(p);
+            std::string word(p, word_end);
+            p = skipSpace(word_end);
+            if (current == 1 && word == "<unk>") {
+                unk_logprob = prob;
+                have_unk = true;
+            }
+            auto it = token_ids.find(word);
+            if (it == token_ids.end()) {
+                dropped += (current == 1 && word == "<unk>") ? 0 : 1;
+                known = false;
+                break;
+            }
+            words[i] = static_cast<uint32_t>(it->second);
+        }
+        if (!known) {
+            continue;
+        }
+
+        float backoff = *p ? std::strtof(p, nullptr) * kLn10 : 0.0f;
+        ArpaLevel& level = levels[current - 1];
+        level.words.insert(level.words.end(), words.begin(), words.begin() + current);
+        level.probs.push_back(prob);
+        level.backoffs.push_back(backoff);
+    } while (std::getline(arpa, line));
+
+    if (!have_unk) {
+        unk_logprob = -10.0f * kLn10;
+    }
+
+    // Level 1 becomes a dense array indexed by token id
+    {
+        ArpaLevel dense;
+        dense.n = 1;
+        dense.words.resize(vocab_size);
+        std::iota(dense.words.begin(), dense.words.end(), 0u);
+        dense.probs.assign(vocab_size, unk_logprob);
+        dense.backoffs.assign(vocab_size, 0.0f);
+        for (size_t i = 0; i < unigrams.size(); ++i) {
+            uint32_t id = unigrams.words[i];
+            dense.probs[id] = unigrams.probs[i];
+            dense.backoffs[id] = unigrams.backoffs[i];
+        }
+        unigrams = std::move(dense);
+    }
+
+    // Higher levels: sort lexicographically, which groups siblings by parent
+    // and orders them by token
+    for (int n = 2; n <= order; ++n) {
+        ArpaLevel& level = levels[n - 1];
+        std::vector<size_t> perm(level.size());
+        std::iota(perm.begin(), perm.end(), 0);
+        std::sort(perm.begin(), perm.end(), [&](size_t a, size_t b) {
+            return lexLess(level.entry(a), level.entry(b), n);
+        });
+
+        ArpaLevel sorted;
+        sorted.n = n;
+        for (size_t k = 0; k < perm.size(); ++k) {
+            size_t i = perm[k];
+            // Duplicates and n-grams whose context is missing cannot be
+            // reached through the trie
+            if (!sorted.probs.empty() &&
+                std::equal(level.entry(i), level.entry(i) + n, sorted.entry(sorted.size() - 1))) {
+                ++dropped;
+                continue;
+            }
+            if (findNgram(levels, level.entry(i), n - 1) < 0) {
+                ++dropped;
+                continue;
+            }
+            sorted.words.insert(sorted.words.end(), level.entry(i), level.entry(i) + n);
+            sorted.probs.push_back(level.probs[i]);
+            sorted.backoffs.push_back(level.backoffs[i]);
+        }
+        level = std::move(sorted);
+    }
+
+    for (int n = 1; n <= order; ++n) {
+        if (levels[n - 1].size() >= (1u << 28)) {
+            std::cerr << "Too many " << n << "-grams for the binary LM format" << std::endl;
+            return false;
+        }
+    }
+
+    // Suffix state of an n-gram w1..wn: the longest of w2..wn, w3..wn, ...
+    // present in the model
+    auto suffixState = [&](const uint32_t* entry, int n) -> State {
+        for (int start = 1; start < n; ++start) {
+            int len = n - start;
+            int64_t index = findNgram(levels, entry + start, len);
+            if (index >= 0) {
+                return makeState(len, static_cast<uint32_t>(index));
+            }
+        }
+        return nullState();
+    };
+
+    // Assemble the file
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.order = static_cast<uint32_t>(order);
+    header.vocab_size = static_cast<uint32_t>(vocab_size);
+    header.bos_id = bos_id;
+    header.eos_id = eos_id;
+    header.unk_logprob = unk_logprob;
+
+    std::vector<float> codebooks(2 * order * 256, 0.0f);
+    for (int n = 1; n <= order; ++n) {
+        buildCodebook(levels[n - 1].probs, &codebooks[(n - 1) * 256]);
+        if (n < order) {
+            buildCodebook(levels[n - 1].backoffs, &codebooks[(order + n - 1) * 256]);
+        }
+    }
+
+    size_t offset = alignUp(sizeof(Header), 8);
+    header.codebook_offset = offset;
+    offset = alignUp(offset + codebooks.size() * sizeof(float), 8);
+
+    std::vector<std::vector<Node>> node_levels(order + 1);
+    std::vector<Leaf> leaves;
+
+    for (int n = 1; n <= order; ++n) {
+        const ArpaLevel& level = levels[n - 1];
+        const float* prob_book = &codebooks[(n - 1) * 256];
+        const float* backoff_book = &codebooks[(order + n - 1) * 256];
+        header.counts[n - 1] = level.size();
+        header.offsets[n - 1] = offset;
+
+        if (n == order && order > 1) {
+            leaves.resize(level.size());
+            for (size_t i = 0; i < level.size(); ++i) {
+                Leaf& leaf = leaves[i];
+                std::memset(&leaf, 0, sizeof(leaf));
+                leaf.token = level.entry(i)[n - 1];
+                leaf.suffix = suffixState(level.entry(i), n);
+                leaf.prob = quantize(level.probs[i], prob_book);
+            }
+            offset = alignUp(offset + leaves.size() * sizeof(Leaf), 8);
+            continue;
+        }
+
+        // child_begin: first entry of level n+1 whose parent is >= i
+        std::vector<Node>& nodes = node_levels[n];
+        nodes.resize(level.size() + 1);
+        std::memset(nodes.data(), 0, nodes.size() * sizeof(Node));
+        size_t child = 0;
+        const ArpaLevel* next = n < order ? &levels[n] : nullptr;
+        for (size_t i = 0; i < level.size(); ++i) {
+            Node& node = nodes[i];
+            node.token = level.entry(i)[n - 1];
+            node.suffix = n == 1 ? nullState() : suffixState(level.entry(i), n);
+            node.prob = quantize(level.probs[i], prob_book);
+            node.backoff = quantize(level.backoffs[i], backoff_book);
+            if (next) {
+                while (child < next->size() && lexLess(next->entry(child), level.entry(i), n)) {
+                    ++child;
+                }
+            }
+            node.child_begin = static_cast<uint32_t>(child);
+        }
+        nodes.back().child_begin = next ? static_cast<uint32_t>(next->size()) : 0;
+        offset = alignUp(offset + nodes.size() * sizeof(Node), 8);
+    }
+
+    std::ofstream out(output_path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Failed to create LM file: " << output_path << std::endl;
+        return false;
+    }
+
+    auto writeAt = [&out](size_t position, const void* data, size_t size) {
+        static const char zeros[8] = {};
+        size_t current_pos = static_cast<size_t>(out.tellp());
+        if (position > current_pos) {
+            out.write(zeros, position - current_pos);
+        }
+        out.write(static_cast<const char*>(data), size);
+    };
+
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.codebook_offset, codebooks.data(), codebooks.size() * sizeof(float));
+    for (int n = 1; n <= order; ++n) {
+        if (n == order && order > 1) {
+            writeAt(header.offsets[n - 1], leaves.data(), leaves.size() * sizeof(Leaf));
+        } else {
+            const std::vector<Node>& nodes = node_levels[n];
+            writeAt(header.offsets[n - 1], nodes.data(), nodes.size() * sizeof(Node));
+        }
+    }
+
+    if (!out.good()) {
+        std::cerr << "Failed writing LM file: " << output_path << std::endl;
+        return false;
+    }
+
+    std::cout << "Converted " << order << "-gram LM: ";
+    for (int n = 1; n <= order; ++n) {
+        std::cout << (n > 1 ? ", " : "") << levels[n - 1].size() << " " << n << "-grams";
+    }
+    std::cout << " (" << dropped << " dropped)" << std::endl;
+    return true;
+}
+
+} // namespace onnx_stt
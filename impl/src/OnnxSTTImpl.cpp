@@ -1,5 +1,7 @@
 #include "OnnxSTTImpl.hpp"
 #include "NeMoCTCModel.hpp"
+#include "AudioKernels.hpp"
+#include "PartialResultTracker.hpp"
 #include <iostream>
 #include <chrono>
 #include <cmath>
@@ -10,7 +12,7 @@
 namespace onnx_stt {
 
 OnnxSTTImpl::OnnxSTTImpl(const Config& config)
-    : config_(config) {
+    : config_(config), endpointer_(config.endpoint_config) {
     last_process_time_ = std::chrono::steady_clock::now();
 }
 
@@ -39,6 +41,7 @@ bool OnnxSTTImpl::initialize() {
                 std::cerr << "Failed to initialize NeMo CTC model" << std::endl;
                 return false;
             }
+            nemo_ctc_model_->setMetrics(&metrics_);
             
             std::cout << "OnnxSTTImpl initialized with NeMo CTC model" << std::endl;
             
@@ -67,6 +70,7 @@ bool OnnxSTTImpl::initialize() {
                 std::cerr << "Failed to initialize NeMo cache-aware model" << std::endl;
                 return false;
             }
+            nemo_cache_model_->setMetrics(&metrics_);
             
             // Initialize real feature extraction using ImprovedFbank
             improved_fbank::FbankComputer::Options fbank_opts;
@@ -84,6 +88,12 @@ bool OnnxSTTImpl::initialize() {
             std::cout << "OnnxSTTImpl initialized with NeMo cache-aware streaming Conformer" << std::endl;
         }
         
+        default_stream_ = createStream();
+        if (!default_stream_) {
+            std::cerr << "Failed to create decoder state" << std::endl;
+            return false;
+        }
+        
         return true;
         
     } catch (const std::exception& e) {
@@ -92,12 +102,47 @@ bool OnnxSTTImpl::initialize() {
     }
 }
 
+size_t OnnxSTTImpl::samplesPerChunk() const {
+    // FastConformer model needs 500 frames to produce exactly 125 frames after subsampling factor 4
+    return 500 * (config_.sample_rate * config_.frame_shift_ms / 1000);
+}
+
+std::unique_ptr<OnnxSTTImpl::StreamState> OnnxSTTImpl::createStream() const {
+    auto stream = std::make_unique<StreamState>();
+    stream->last_active = std::chrono::steady_clock::now();
+    
+    if (nemo_cache_model_) {
+        stream->decode = nemo_cache_model_->createDecodeState();
+        if (!stream->decode) {
+            return nullptr;
+        }
+        // The chunk ring is allocated on the stream's first audio
+    }
+    return stream;
+}
+
+size_t OnnxSTTImpl::ringSamples() const {
+    // One chunk plus the largest tuple we expect (3 s), i.e. a 131072-sample
+    // ring at 16 kHz; larger tuples grow the ring for as long as needed
+    return samplesPerChunk() + static_cast<size_t>(config_.sample_rate) * 3;
+}
+
 OnnxSTTImpl::TranscriptionResult OnnxSTTImpl::processAudioChunk(
     const int16_t* samples, 
     size_t num_samples, 
     uint64_t timestamp_ms) {
     
+    return processAudio(*default_stream_, samples, num_samples, timestamp_ms);
+}
+
+OnnxSTTImpl::TranscriptionResult OnnxSTTImpl::processAudio(
+    StreamState& stream,
+    const int16_t* samples, 
+    size_t num_samples, 
+    uint64_t timestamp_ms) {
+    
     auto start_time = std::chrono::steady_clock::now();
+    TraceSpan span("chunk", stream.trace_id, stream.chunks++);
     TranscriptionResult result;
     result.timestamp_ms = timestamp_ms;
     result.is_final = false;
@@ -106,61 +151,104 @@ OnnxSTTImpl::TranscriptionResult OnnxSTTImpl::processAudioChunk(
     try {
         // Stage 1: Voice Activity Detection (optional - for now process all audio)
         
-        // Stage 2: Convert int16 to float and buffer
-        std::vector<float> float_samples(num_samples);
-        for (size_t i = 0; i < num_samples; ++i) {
-            float_samples[i] = samples[i] / 32768.0f;
-        }
+        // Stage 2: Convert int16 to float directly into the stream's buffer
+        StageTimer ingest_timer(&metrics_, PipelineMetrics::Stage::INGEST);
+        metrics_.addAudio(num_samples, config_.sample_rate);
+        stream.last_timestamp_ms = timestamp_ms;
+        stream.last_active = start_time;
         
-        // Add to audio buffer
-        audio_buffer_.insert(audio_buffer_.end(), 
-                           float_samples.begin(), 
-                           float_samples.end());
+        if (nemo_cache_model_) {
+            if (!stream.chunk_buffer) {
+                stream.chunk_buffer = std::make_unique<StreamingBuffer>(
+                    ringSamples(), samplesPerChunk(), 0);
+            }
+            size_t written = stream.chunk_buffer->appendInt16(samples, num_samples);
+            if (written < num_samples) {
+                // A tuple larger than the free space (or a backlog): grow
+                // the ring rather than drop speech
+                stream.chunk_buffer->resize(stream.chunk_buffer->available() + (num_samples - written));
+                stream.chunk_buffer->appendInt16(samples + written, num_samples - written);
+                std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                stats_.buffer_grows++;
+            }
+        } else {
+            const size_t offset = stream.audio_buffer.size();
+            stream.audio_buffer.resize(offset + num_samples);
+            audio_kernels::int16ToFloat(samples, stream.audio_buffer.data() + offset,
+                                        num_samples, 1.0f / 32768.0f);
+        }
         
-        // Update stats
-        stats_.total_audio_ms += (num_samples * 1000) / config_.sample_rate;
+        ingest_timer.stop();
         
         if (config_.model_type == Config::NEMO_CTC) {
             // For CTC model, process in larger chunks or complete audio
             const size_t min_samples = config_.sample_rate / 10;  // At least 100ms
             
-            if (audio_buffer_.size() >= min_samples) {
+            if (stream.audio_buffer.size() >= min_samples) {
                 // Process available audio
-                auto ctc_result = nemo_ctc_model_->processAudio(audio_buffer_);
+                std::unique_lock<std::mutex> ctc_lock(ctc_mutex_);
+                auto ctc_result = nemo_ctc_model_->processAudio(stream.audio_buffer);
+                ctc_lock.unlock();
                 
                 result.text = ctc_result.text;
                 result.confidence = ctc_result.avg_confidence;
                 result.is_final = true;  // CTC processes complete utterances
+                result.stable_text = ctc_result.text;
+                result.word_offsets = std::move(ctc_result.word_offsets);
+                result.word_start_ms = std::move(ctc_result.word_start_ms);
+                result.word_end_ms = std::move(ctc_result.word_end_ms);
                 
                 // Clear buffer after processing
-                audio_buffer_.clear();
+                stream.audio_buffer.clear();
             }
         } else {
             // Process if we have enough samples for a NeMo chunk (500 frames * 160 samples/frame)
-            // FastConformer model needs 500 frames to produce exactly 125 frames after subsampling factor 4
-            const size_t samples_per_chunk = 500 * (config_.sample_rate * config_.frame_shift_ms / 1000);
+            const size_t samples_per_chunk = samplesPerChunk();
             
-            while (audio_buffer_.size() >= samples_per_chunk) {
-                // Extract chunk
-                std::vector<float> chunk(audio_buffer_.begin(), 
-                                       audio_buffer_.begin() + samples_per_chunk);
-                audio_buffer_.erase(audio_buffer_.begin(), 
-                                  audio_buffer_.begin() + samples_per_chunk);
-                
-                // Stage 3: Real feature extraction using ImprovedFbank
-                auto features_2d = fbank_computer_->computeFeatures(chunk);
+            while (const float* chunk = stream.chunk_buffer->nextChunk()) {
+                // Stage 3: Real feature extraction using ImprovedFbank, reading
+                // the chunk in place
+                StageTimer fbank_timer(&metrics_, PipelineMetrics::Stage::FBANK);
+                auto features_2d = fbank_computer_->computeFeatures(chunk, samples_per_chunk);
+                fbank_timer.stop();
                 
                 std::cout << "Extracted " << features_2d.size() << " feature frames for " 
-                          << chunk.size() << " audio samples" << std::endl;
+                          << samples_per_chunk << " audio samples" << std::endl;
                 
                 // Stage 4: Speech recognition using NeMo cache-aware model
-                auto nemo_result = nemo_cache_model_->processChunk(features_2d, timestamp_ms);
+                auto nemo_result = nemo_cache_model_->processChunk(*stream.decode, features_2d, timestamp_ms);
                 
-                // Update result
+                // Update result; several chunks in one call accumulate
+                // their committed text, and each chunk's words replace the
+                // unstable ones the previous chunk listed
                 result.text = nemo_result.text;
                 result.confidence = nemo_result.confidence;
                 result.is_final = nemo_result.is_final;
+                if (result.stable_text.empty()) {
+                    result.stable_offset = nemo_result.stable_offset;
+                }
+                result.stable_text += nemo_result.stable_text;
+                result.unstable_text = std::move(nemo_result.unstable_text);
+                mergeWords(result, nemo_result);
+                
+                // Endpoint: commit the last word, emit a final, start a new utterance
+                if (config_.enable_endpointing &&
+                    endpointer_.detect(nemo_result.utterance_ms, nemo_result.trailing_blank_ms,
+                                       nemo_result.utterance_tokens > 0)) {
+                    StageTimer decoder_timer(&metrics_, PipelineMetrics::Stage::DECODER);
+                    auto final_result = nemo_cache_model_->finalize(*stream.decode, timestamp_ms);
+                    decoder_timer.stop();
+                    result.stable_text += final_result.stable_text;
+                    result.unstable_text.clear();
+                    mergeWords(result, final_result);
+                    result.is_final = true;
+                    nemo_cache_model_->resetState(*stream.decode);
+                    break;  // further buffered audio starts the next call's utterance
+                }
             }
+            
+            // Give back what a large tuple made the ring grow to (no-op otherwise)
+            stream.chunk_buffer->resize(ringSamples());
         }
         
         // Calculate latency
@@ -169,13 +257,6 @@ OnnxSTTImpl::TranscriptionResult OnnxSTTImpl::processAudioChunk(
             end_time - start_time).count();
         result.latency_ms = duration;
         
-        // Update stats
-        stats_.total_processing_ms += duration;
-        if (stats_.total_audio_ms > 0) {
-            stats_.real_time_factor = 
-                static_cast<double>(stats_.total_processing_ms) / stats_.total_audio_ms;
-        }
-        
     } catch (const std::exception& e) {
         std::cerr << "Error processing audio chunk: " << e.what() << std::endl;
     }
@@ -183,14 +264,178 @@ OnnxSTTImpl::TranscriptionResult OnnxSTTImpl::processAudioChunk(
     return result;
 }
 
-void OnnxSTTImpl::reset() {
-    if (nemo_cache_model_) {
-        nemo_cache_model_->reset();
+OnnxSTTImpl::TranscriptionResult OnnxSTTImpl::finalizeStream(StreamState& stream) {
+    TraceSpan span("finalize", stream.trace_id, stream.chunks);
+    TranscriptionResult result;
+    result.timestamp_ms = stream.last_timestamp_ms;
+    result.is_final = true;
+    result.confidence = 0.0;
+    result.latency_ms = 0;
+    
+    try {
+        if (nemo_ctc_model_) {
+            // Whatever is below the 100 ms decode threshold
+            if (!stream.audio_buffer.empty()) {
+                std::unique_lock<std::mutex> ctc_lock(ctc_mutex_);
+                auto ctc_result = nemo_ctc_model_->processAudio(stream.audio_buffer);
+                ctc_lock.unlock();
+                result.text = ctc_result.text;
+                result.confidence = ctc_result.avg_confidence;
+                result.stable_text = ctc_result.text;
+                result.word_offsets = std::move(ctc_result.word_offsets);
+                result.word_start_ms = std::move(ctc_result.word_start_ms);
+                result.word_end_ms = std::move(ctc_result.word_end_ms);
+            }
+        } else if (nemo_cache_model_ && stream.decode) {
+            // A partial chunk left in the buffer is dropped; commit the
+            // last word of what was decoded
+            StageTimer decoder_timer(&metrics_, PipelineMetrics::Stage::DECODER);
+            auto final_result = nemo_cache_model_->finalize(*stream.decode, stream.last_timestamp_ms);
+            result.text = final_result.stable_text;
+            result.confidence = final_result.confidence;
+            result.stable_text = std::move(final_result.stable_text);
+            result.stable_offset = final_result.stable_offset;
+            result.word_offsets = std::move(final_result.word_offsets);
+            result.word_start_ms = std::move(final_result.word_start_ms);
+            result.word_end_ms = std::move(final_result.word_end_ms);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error finalizing stream: " << e.what() << std::endl;
+    }
+    
+    return result;
+}
+
+void OnnxSTTImpl::resetStream(StreamState& stream) const {
+    if (nemo_cache_model_ && stream.decode) {
+        nemo_cache_model_->resetState(*stream.decode);
     }
     // NeMo CTC model doesn't need reset
-    audio_buffer_.clear();
-    feature_buffer_.clear();
-    stats_ = Stats{};
+    stream.audio_buffer.clear();
+    stream.chunk_buffer.reset();   // reallocated on the next audio
+}
+
+bool OnnxSTTImpl::processStreamChunk(const StreamKey& key,
+                                     const int16_t* samples,
+                                     size_t num_samples,
+                                     uint64_t timestamp_ms,
+                                     TranscriptionResult& result,
+                                     TraceTag trace) {
+    StreamState* stream = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        auto it = streams_.find(key);
+        if (it == streams_.end()) {
+            if (config_.max_streams > 0 && streams_.size() >= config_.max_streams) {
+                std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                stats_.streams_rejected++;
+                return false;
+            }
+            auto created = createStream();
+            if (!created) {
+                return false;
+            }
+            it = streams_.emplace(key, std::move(created)).first;
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.streams_opened++;
+        }
+        stream = it->second.get();
+    }
+    
+    // Only this key's caller touches the stream, so decode without the lock
+    if (trace.stream_id != 0) {
+        stream->trace_id = trace.stream_id;
+        stream->chunks = trace.chunk;
+    }
+    result = processAudio(*stream, samples, num_samples, timestamp_ms);
+    return true;
+}
+
+bool OnnxSTTImpl::isIdle(const StreamState& stream, uint64_t idle_ms,
+                         std::chrono::steady_clock::time_point now) const {
+    return now - stream.last_active >= std::chrono::milliseconds(idle_ms);
+}
+
+bool OnnxSTTImpl::closeStream(const StreamKey& key, TranscriptionResult& final_result,
+                              uint64_t idle_ms) {
+    std::unique_ptr<StreamState> stream;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        auto it = streams_.find(key);
+        if (it == streams_.end() ||
+            !isIdle(*it->second, idle_ms, std::chrono::steady_clock::now())) {
+            return false;
+        }
+        stream = std::move(it->second);
+        streams_.erase(it);
+    }
+    
+    final_result = finalizeStream(*stream);
+    if (idle_ms > 0) {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.streams_evicted++;
+    }
+    return true;
+}
+
+size_t OnnxSTTImpl::idleStreams(uint64_t idle_ms, std::vector<StreamKey>& keys) const {
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    size_t found = 0;
+    for (const auto& entry : streams_) {
+        if (isIdle(*entry.second, idle_ms, now)) {
+            keys.push_back(entry.first);
+            ++found;
+        }
+    }
+    return found;
+}
+
+size_t OnnxSTTImpl::activeStreams() const {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    return streams_.size();
+}
+
+size_t OnnxSTTImpl::evictIdleStreams(uint64_t idle_ms,
+                                     std::vector<std::pair<StreamKey, TranscriptionResult>>& finals) {
+    const auto now = std::chrono::steady_clock::now();
+    size_t evicted = 0;
+    
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        if (!isIdle(*it->second, idle_ms, now)) {
+            ++it;
+            continue;
+        }
+        finals.emplace_back(it->first, finalizeStream(*it->second));
+        it = streams_.erase(it);
+        ++evicted;
+    }
+    
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    stats_.streams_evicted += evicted;
+    return evicted;
+}
+
+OnnxSTTImpl::Stats OnnxSTTImpl::getStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats = stats_;
+    }
+    stats.active_streams = activeStreams();
+    stats.total_audio_ms = metrics_.audioUs() / 1000;
+    stats.total_processing_ms = metrics_.processingUs() / 1000;
+    stats.real_time_factor = metrics_.realTimeFactor();
+    return stats;
+}
+
+void OnnxSTTImpl::reset() {
+    if (default_stream_) {
+        resetStream(*default_stream_);
+    }
+    // Keyed stream counters describe streams that outlive the reset
+    metrics_.reset();
 }
 
 std::vector<float> OnnxSTTImpl::extractFeatures(const std::vector<float>& /*audio*/) {
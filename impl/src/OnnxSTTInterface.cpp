@@ -24,6 +24,9 @@ public:
         implConfig.blank_id = config.blank_id;
         implConfig.num_threads = config.num_threads;
         implConfig.use_gpu = config.use_gpu;
+        implConfig.enable_endpointing = config.enable_endpointing;
+        implConfig.endpoint_config = config.endpoint_config;
+        implConfig.max_streams = config.max_streams;
         
         // Convert model type
         if (config.model_type == ModelType::NEMO_CTC) {
@@ -42,16 +45,7 @@ public:
     TranscriptionResult processAudioChunk(const int16_t* samples, 
                                         size_t num_samples, 
                                         uint64_t timestamp_ms) override {
-        auto implResult = impl_->processAudioChunk(samples, num_samples, timestamp_ms);
-        
-        TranscriptionResult result;
-        result.text = implResult.text;
-        result.is_final = implResult.is_final;
-        result.confidence = implResult.confidence;
-        result.timestamp_ms = implResult.timestamp_ms;
-        result.latency_ms = implResult.latency_ms;
-        
-        return result;
+        return convert(impl_->processAudioChunk(samples, num_samples, timestamp_ms));
     }
     
     void reset() override {
@@ -65,12 +59,79 @@ public:
         stats.total_audio_ms = implStats.total_audio_ms;
         stats.total_processing_ms = implStats.total_processing_ms;
         stats.real_time_factor = implStats.real_time_factor;
+        stats.active_streams = implStats.active_streams;
+        stats.streams_opened = implStats.streams_opened;
+        stats.streams_evicted = implStats.streams_evicted;
+        stats.streams_rejected = implStats.streams_rejected;
+        stats.buffer_grows = implStats.buffer_grows;
         
         return stats;
     }
     
+    bool processStreamChunk(const StreamKey& key,
+                            const int16_t* samples,
+                            size_t num_samples,
+                            uint64_t timestamp_ms,
+                            TranscriptionResult& result,
+                            TraceTag trace) override {
+        OnnxSTTImpl::TranscriptionResult implResult;
+        if (!impl_->processStreamChunk(key, samples, num_samples, timestamp_ms, implResult, trace)) {
+            return false;
+        }
+        result = convert(std::move(implResult));
+        return true;
+    }
+    
+    bool closeStream(const StreamKey& key, TranscriptionResult& final_result,
+                     uint64_t idle_ms) override {
+        OnnxSTTImpl::TranscriptionResult implResult;
+        if (!impl_->closeStream(key, implResult, idle_ms)) {
+            return false;
+        }
+        final_result = convert(std::move(implResult));
+        return true;
+    }
+    
+    size_t idleStreams(uint64_t idle_ms, std::vector<StreamKey>& keys) const override {
+        return impl_->idleStreams(idle_ms, keys);
+    }
+    
+    size_t evictIdleStreams(uint64_t idle_ms,
+                            std::vector<std::pair<StreamKey, TranscriptionResult>>& finals) override {
+        std::vector<std::pair<StreamKey, OnnxSTTImpl::TranscriptionResult>> implFinals;
+        size_t evicted = impl_->evictIdleStreams(idle_ms, implFinals);
+        for (auto& entry : implFinals) {
+            finals.emplace_back(entry.first, convert(std::move(entry.second)));
+        }
+        return evicted;
+    }
+    
+    size_t activeStreams() const override {
+        return impl_->activeStreams();
+    }
+    
+    PipelineMetrics& getMetrics() override {
+        return impl_->getMetrics();
+    }
+    
 private:
     std::unique_ptr<OnnxSTTImpl> impl_;
+    
+    static TranscriptionResult convert(OnnxSTTImpl::TranscriptionResult implResult) {
+        TranscriptionResult result;
+        result.text = std::move(implResult.text);
+        result.is_final = implResult.is_final;
+        result.confidence = implResult.confidence;
+        result.timestamp_ms = implResult.timestamp_ms;
+        result.latency_ms = implResult.latency_ms;
+        result.stable_text = std::move(implResult.stable_text);
+        result.unstable_text = std::move(implResult.unstable_text);
+        result.stable_offset = implResult.stable_offset;
+        result.word_offsets = std::move(implResult.word_offsets);
+        result.word_start_ms = std::move(implResult.word_start_ms);
+        result.word_end_ms = std::move(implResult.word_end_ms);
+        return result;
+    }
 };
 
 // Factory function implementation
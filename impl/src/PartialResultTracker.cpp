@@ -0,0 +1,115 @@
+#include "PartialResultTracker.hpp"
+#include <algorithm>
+
+namespace onnx_stt {
+
+PartialResultTracker::PartialResultTracker(std::shared_ptr<const TokenVocabulary> vocab)
+    : PartialResultTracker(std::move(vocab), Config()) {
+}
+
+PartialResultTracker::PartialResultTracker(std::shared_ptr<const TokenVocabulary> vocab,
+                                           const Config& config)
+    : config_(config), vocab_(vocab), detokenizer_(std::move(vocab)) {
+}
+
+void PartialResultTracker::setVocabulary(std::shared_ptr<const TokenVocabulary> vocab) {
+    vocab_ = vocab;
+    detokenizer_.setVocabulary(std::move(vocab));
+    reset();
+}
+
+bool PartialResultTracker::startsWord(size_t index) const {
+    if (index == 0 || !vocab_) {
+        return true;
+    }
+    int token = merged_[index];
+    return token >= 0 && token < vocab_->size() && vocab_->startsWord(token);
+}
+
+PartialResultTracker::Update PartialResultTracker::update(const int* tokens,
+                                                          const uint32_t* token_ms,
+                                                          size_t count, bool is_final) {
+    ++updates_;
+
+    // Committed tokens are final: keep them and take only the decoder's tail
+    const std::vector<int>& held = detokenizer_.tokens();
+    merged_.assign(held.begin(), held.begin() + committed_);
+    if (count > committed_) {
+        merged_.insert(merged_.end(), tokens + committed_, tokens + count);
+    }
+    merged_ms_.resize(committed_);
+    if (token_ms && count > committed_) {
+        merged_ms_.insert(merged_ms_.end(), token_ms + committed_, token_ms + count);
+    }
+
+    size_t changed = detokenizer_.update(merged_);
+    const size_t n = merged_.size();
+    since_.resize(n);
+    for (size_t i = changed; i < n; ++i) {
+        since_[i] = updates_;
+    }
+
+    // Longest prefix unchanged for stable_updates updates (since_ is
+    // non-decreasing, so the stable tokens are a prefix)
+    const uint32_t needed = static_cast<uint32_t>(std::max(config_.stable_updates, 1));
+    size_t stable = committed_;
+    while (stable < n && updates_ - since_[stable] + 1 >= needed) {
+        ++stable;
+    }
+
+    // Commit up to the last stable word start: the word before it is complete
+    size_t commit = committed_;
+    if (is_final || !vocab_) {
+        commit = is_final ? n : stable;
+    } else {
+        for (size_t k = stable; k-- > committed_ + 1;) {
+            if (startsWord(k)) {
+                commit = k;
+                break;
+            }
+        }
+    }
+
+    const std::string& text = detokenizer_.text();
+    const size_t begin = detokenizer_.textBegin(committed_);
+    const size_t end = detokenizer_.textBegin(commit);
+
+    Update result;
+    result.stable_offset = begin;
+    result.stable_text.assign(text, begin, end - begin);
+    result.unstable_text.assign(text, end, std::string::npos);
+    const bool timed = merged_ms_.size() == n;
+    const uint32_t duration = static_cast<uint32_t>(std::max(config_.token_duration_ms, 0));
+    for (size_t i = committed_; i < n; ++i) {
+        if (!startsWord(i)) {
+            // Continuation: extends the word opened in this update, if any
+            if (timed && !result.word_end_ms.empty()) {
+                result.word_end_ms.back() = merged_ms_[i] + duration;
+            }
+            continue;
+        }
+        size_t offset = detokenizer_.textBegin(i);
+        if (offset < text.size() && text[offset] == ' ') {
+            ++offset;  // word separator
+        }
+        result.word_offsets.push_back(static_cast<uint32_t>(offset));
+        if (timed) {
+            result.word_start_ms.push_back(merged_ms_[i]);
+            result.word_end_ms.push_back(merged_ms_[i] + duration);
+        }
+    }
+
+    committed_ = commit;
+    return result;
+}
+
+void PartialResultTracker::reset() {
+    detokenizer_.reset();
+    since_.clear();
+    merged_.clear();
+    merged_ms_.clear();
+    committed_ = 0;
+    updates_ = 0;
+}
+
+} // namespace onnx_stt
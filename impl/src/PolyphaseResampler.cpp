@@ -0,0 +1,217 @@
+#include "PolyphaseResampler.hpp"
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace onnx_stt {
+
+namespace {
+
+struct QualitySettings {
+    int taps;          // taps per phase when upsampling
+    double beta;       // Kaiser window shape
+    double rolloff;    // cutoff as a fraction of the lower Nyquist frequency
+};
+
+const QualitySettings kQuality[] = {
+    {8, 5.0, 0.90},    // FAST
+    {16, 7.0, 0.94},   // MEDIUM
+    {32, 9.0, 0.97},   // HIGH
+};
+
+int gcd(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Zeroth-order modified Bessel function of the first kind
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+PolyphaseResampler::PolyphaseResampler(int input_rate, int output_rate, Quality quality)
+    : input_rate_(input_rate), output_rate_(output_rate) {
+    if (input_rate <= 0 || output_rate <= 0) {
+        throw std::invalid_argument("Sample rates must be positive");
+    }
+    int g = gcd(input_rate, output_rate);
+    filter_ = getFilter(output_rate / g, input_rate / g, quality);
+    reset();
+}
+
+std::shared_ptr<const PolyphaseResampler::Filter>
+PolyphaseResampler::getFilter(int up, int down, Quality quality) {
+    static std::mutex registry_mutex;
+    static std::map<std::tuple<int, int, int>, std::weak_ptr<const Filter>> registry;
+
+    auto key = std::make_tuple(up, down, static_cast<int>(quality));
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = registry.find(key);
+    if (it != registry.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    std::shared_ptr<const Filter> filter = designFilter(up, down, quality);
+    registry[key] = filter;
+    return filter;
+}
+
+std::shared_ptr<PolyphaseResampler::Filter>
+PolyphaseResampler::designFilter(int up, int down, Quality quality) {
+    auto filter = std::make_shared<Filter>();
+    filter->up = up;
+    filter->down = down;
+    if (up == down) {
+        return filter;  // passthrough
+    }
+
+    const QualitySettings& q = kQuality[std::min(std::max(static_cast<int>(quality), 0), 2)];
+
+    // Downsampling narrows the pass band, so the same transition width
+    // relative to it needs proportionally more input taps; keep a multiple
+    // of 8 for the SIMD dot product
+    double ratio = std::min(1.0, static_cast<double>(up) / down);
+    int taps = static_cast<int>(std::ceil(q.taps / ratio));
+    taps = (taps + 7) / 8 * 8;
+    filter->taps = taps;
+
+    // Prototype low-pass at the upsampled rate up * input_rate, centred on
+    // a whole tap so that outputs land exactly on input-grid times
+    const int length = taps * up;
+    const int center = length / 2;
+    const double cutoff = q.rolloff * 0.5 * ratio / up;  // cycles per upsampled sample
+    const double i0_beta = besselI0(q.beta);
+
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+    for (int n = 0; n < length; ++n) {
+        double x = n - center;
+        double arg = 2.0 * cutoff * x;
+        double sinc = std::abs(arg) < 1e-12 ? 1.0 : std::sin(M_PI * arg) / (M_PI * arg);
+        double r = x / center;
+        double window = besselI0(q.beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / i0_beta;
+        prototype[n] = 2.0 * cutoff * sinc * window;
+        sum += prototype[n];
+    }
+
+    // Unity DC gain per output sample: each phase sums to about 1
+    const double gain = up / sum;
+
+    // Phase p, tap j multiplies input sample (newest - taps + 1 + j)
+    filter->coeffs.resize(static_cast<size_t>(up) * taps);
+    for (int p = 0; p < up; ++p) {
+        for (int j = 0; j < taps; ++j) {
+            filter->coeffs[static_cast<size_t>(p) * taps + j] =
+                static_cast<float>(prototype[(taps - 1 - j) * up + p] * gain);
+        }
+    }
+    return filter;
+}
+
+size_t PolyphaseResampler::process(const float* input, size_t count, std::vector<float>& out) {
+    total_in_ += count;
+    if (isPassthrough()) {
+        out.insert(out.end(), input, input + count);
+        total_out_ += count;
+        return count;
+    }
+
+    const int up = filter_->up;
+    const int down = filter_->down;
+    const int taps = filter_->taps;
+    const float* coeffs = filter_->coeffs.data();
+
+    work_.insert(work_.end(), input, input + count);
+
+    // pos_ / up is the newest input sample (relative to this call's input)
+    // under the filter; its window starts at the same index in work_
+    const int64_t end = static_cast<int64_t>(count) * up;
+    size_t produced = 0;
+    while (pos_ < end) {
+        const int64_t newest = pos_ / up;
+        const int phase = static_cast<int>(pos_ % up);
+        out.push_back(audio_kernels::dot(coeffs + static_cast<size_t>(phase) * taps,
+                                         work_.data() + newest, taps));
+        ++produced;
+        pos_ += down;
+    }
+    pos_ -= end;
+
+    // Keep the last taps - 1 samples as history
+    std::copy(work_.end() - (taps - 1), work_.end(), work_.begin());
+    work_.resize(taps - 1);
+
+    total_out_ += produced;
+    return produced;
+}
+
+size_t PolyphaseResampler::flush(std::vector<float>& out) {
+    const uint64_t up = filter_->up;
+    const uint64_t down = filter_->down;
+    const uint64_t target = (total_in_ * up + down - 1) / down;
+    const size_t start = out.size();
+    if (total_out_ < target && !isPassthrough()) {
+        const uint64_t missing = target - total_out_;
+        std::vector<float> zeros(filter_->taps, 0.0f);
+        while (out.size() - start < missing) {
+            process(zeros.data(), zeros.size(), out);
+        }
+        out.resize(start + missing);
+    }
+    reset();
+    return out.size() - start;
+}
+
+void PolyphaseResampler::reset() {
+    const int taps = filter_->taps;
+    work_.assign(taps > 0 ? taps - 1 : 0, 0.0f);
+    // Start at the prototype centre so output 0 lines up with input 0
+    pos_ = static_cast<int64_t>(taps) * filter_->up / 2;
+    total_in_ = 0;
+    total_out_ = 0;
+}
+
+std::vector<float> PolyphaseResampler::resample(const float* input, size_t count,
+                                                int input_rate, int output_rate,
+                                                Quality quality) {
+    PolyphaseResampler resampler(input_rate, output_rate, quality);
+    std::vector<float> out;
+    out.reserve(static_cast<size_t>(
+        static_cast<double>(count) * output_rate / input_rate) + 1);
+    resampler.process(input, count, out);
+    resampler.flush(out);
+    return out;
+}
+
+PolyphaseResampler::Quality PolyphaseResampler::parseQuality(const std::string& name) {
+    if (name == "fast") {
+        return FAST;
+    }
+    if (name == "high") {
+        return HIGH;
+    }
+    return MEDIUM;
+}
+
+} // namespace onnx_stt
@@ -3,14 +3,43 @@
 #include "KaldifeatExtractor.hpp"
 #include "ZipformerModel.hpp"
 #include "NeMoCacheAwareConformer.hpp"
+#include "AudioKernels.hpp"
+#include "PartialResultTracker.hpp"
 #include <iostream>
 #include <chrono>
 #include <numeric>
 
 namespace onnx_stt {
 
+namespace {
+
+uint64_t elapsedUs(std::chrono::steady_clock::time_point from,
+                   std::chrono::steady_clock::time_point to) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+} // namespace
+
 STTPipeline::STTPipeline(const Config& config) 
-    : config_(config), last_speech_time_ms_(0), in_speech_segment_(false) {}
+    : config_(config), endpointer_(config.endpoint_config),
+      last_speech_time_ms_(0), in_speech_segment_(false),
+      trace_stream_id_(Tracer::instance().newStreamId()) {
+    if (config_.input_sample_rate > 0 && config_.input_sample_rate != config_.sample_rate) {
+        resampler_ = std::make_unique<PolyphaseResampler>(
+            config_.input_sample_rate, config_.sample_rate, config_.resample_quality);
+    }
+    context_ring_.resize(static_cast<size_t>(std::max(config_.feature_context_ms, 0)) *
+                         config_.sample_rate / 1000);
+}
+
+STTPipeline::~STTPipeline() {
+    if (config_.enable_profiling && !config_.profile_path.empty()) {
+        if (!Tracer::instance().writeChromeTrace(config_.profile_path)) {
+            std::cerr << "Failed to write trace to " << config_.profile_path << std::endl;
+        }
+    }
+}
 
 bool STTPipeline::initialize() {
     try {
@@ -37,6 +66,10 @@ bool STTPipeline::initialize() {
         std::cout << "  Feature extractor: " << (config_.feature_type == Config::KALDIFEAT ? "kaldifeat" : "simple_fbank") << std::endl;
         std::cout << "  Model: " << config_.model_config.model_type << std::endl;
         
+        if (config_.enable_profiling) {
+            Tracer::instance().enable();
+        }
+        
         return true;
         
     } catch (const std::exception& e) {
@@ -46,11 +79,29 @@ bool STTPipeline::initialize() {
 }
 
 STTPipeline::Result STTPipeline::processAudio(const int16_t* samples, size_t num_samples, uint64_t timestamp_ms) {
-    auto audio_float = convertInt16ToFloat(samples, num_samples);
-    return processAudio(audio_float, timestamp_ms);
+    // One conversion pass into a reused buffer; no allocation once it has grown
+    TraceSpan span("chunk", trace_stream_id_, stats_.total_chunks_processed);
+    StageTimer ingest_timer(&metrics_, PipelineMetrics::Stage::INGEST);
+    converted_.resize(num_samples);
+    audio_kernels::int16ToFloat(samples, converted_.data(), num_samples, 1.0f / 32768.0f);
+    ingest_timer.stop();
+    return processFloat(converted_, timestamp_ms);
 }
 
 STTPipeline::Result STTPipeline::processAudio(const std::vector<float>& audio, uint64_t timestamp_ms) {
+    TraceSpan span("chunk", trace_stream_id_, stats_.total_chunks_processed);
+    return processFloat(audio, timestamp_ms);
+}
+
+STTPipeline::Result STTPipeline::processFloat(const std::vector<float>& audio, uint64_t timestamp_ms) {
+    metrics_.addAudio(audio.size(), resampler_ ? config_.input_sample_rate : config_.sample_rate);
+    if (resampler_) {
+        StageTimer ingest_timer(&metrics_, PipelineMetrics::Stage::INGEST);
+        resampled_.clear();
+        resampler_->process(audio.data(), audio.size(), resampled_);
+        ingest_timer.stop();
+        return processAudioInternal(resampled_, timestamp_ms);
+    }
     return processAudioInternal(audio, timestamp_ms);
 }
 
@@ -65,12 +116,19 @@ STTPipeline::Result STTPipeline::processAudioInternal(const std::vector<float>&
     // Step 1: Voice Activity Detection
     auto vad_start = std::chrono::steady_clock::now();
     
+    // Samples of this chunk to featurize (all of it unless gated)
+    size_t feature_samples = audio.size();
+    const bool gating = config_.gate_features && config_.enable_vad && vad_;
+    
     if (config_.enable_vad && vad_) {
+        TraceSpan vad_span("vad");
         auto vad_result = vad_->processChunk(audio, timestamp_ms);
+        vad_span.stop();
         result.speech_detected = vad_result.is_speech;
         result.vad_confidence = vad_result.confidence;
         
         auto vad_end = std::chrono::steady_clock::now();
+        metrics_.record(PipelineMetrics::Stage::VAD, elapsedUs(vad_start, vad_end));
         result.vad_latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
             vad_end - vad_start).count();
         
@@ -87,8 +145,46 @@ STTPipeline::Result STTPipeline::processAudioInternal(const std::vector<float>&
             }
         }
         
+        if (gating) {
+            if (vad_result.is_speech) {
+                tail_remaining_ = static_cast<size_t>(std::max(config_.feature_tail_ms, 0)) *
+                                  config_.sample_rate / 1000;
+            } else {
+                // Hangover: only the first feature_tail_ms of silence is featurized
+                feature_samples = in_speech_segment_ ? std::min(feature_samples, tail_remaining_) : 0;
+                tail_remaining_ -= feature_samples;
+                if (in_speech_segment_) {
+                    stats_.feature_frames_skipped += samplesToFrames(audio.size() - feature_samples);
+                }
+            }
+            
+            // The VAD ended the segment: the decoder saw no long trailing
+            // silence to endpoint on, so finalize here
+            if (result.is_final) {
+                finalizeUtterance(result, timestamp_ms);
+            }
+        }
+        
         // Skip processing if no speech detected
         if (!vad_result.is_speech && !in_speech_segment_) {
+            if (gating) {
+                skipped_samples_ += audio.size();
+                pushContext(audio.data(), audio.size());
+            }
+            stats_.silence_chunks++;
+            stats_.total_chunks_processed++;
+            
+            auto end_time = std::chrono::steady_clock::now();
+            result.latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                end_time - start_time).count();
+            
+            return result;
+        }
+        
+        if (gating && feature_samples == 0) {
+            // Hangover beyond the tail: nothing for the model this chunk
+            skipped_samples_ += audio.size();
+            pushContext(audio.data(), audio.size());
             stats_.silence_chunks++;
             stats_.total_chunks_processed++;
             
@@ -96,7 +192,6 @@ STTPipeline::Result STTPipeline::processAudioInternal(const std::vector<float>&
             result.latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                 end_time - start_time).count();
             
-            updateStats(result);
             return result;
         }
         
@@ -110,31 +205,70 @@ STTPipeline::Result STTPipeline::processAudioInternal(const std::vector<float>&
     
     // Step 2: Feature Extraction
     auto feature_start = std::chrono::steady_clock::now();
+    TraceSpan fbank_span("fbank");
+    
+    const std::vector<float>* feature_audio = &audio;
+    uint64_t feature_timestamp_ms = timestamp_ms;
+    if (gating) {
+        // Left context: audio skipped since the last call (silence before
+        // an onset, or the part of the hangover beyond the tail)
+        feature_input_.clear();
+        size_t context = std::min(skipped_samples_, context_fill_);
+        appendContext(context, feature_input_);
+        feature_input_.insert(feature_input_.end(), audio.begin(), audio.begin() + feature_samples);
+        feature_audio = &feature_input_;
+        uint64_t context_ms = context * 1000 / config_.sample_rate;
+        feature_timestamp_ms = timestamp_ms > context_ms ? timestamp_ms - context_ms : 0;
+        
+        skipped_samples_ = audio.size() - feature_samples;
+        pushContext(audio.data(), audio.size());
+    }
     
-    auto features = feature_extractor_->computeFeatures(audio);
+    auto features = feature_extractor_->computeFeatures(*feature_audio);
+    stats_.feature_frames += features.size();
+    fbank_span.stop();
     
     auto feature_end = std::chrono::steady_clock::now();
+    metrics_.record(PipelineMetrics::Stage::FBANK, elapsedUs(feature_start, feature_end));
     result.feature_latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         feature_end - feature_start).count();
     
     // Step 3: ASR Model Processing
     auto model_start = std::chrono::steady_clock::now();
     
-    auto model_result = model_->processChunk(features, timestamp_ms);
+    TraceSpan model_span("model");
+    auto model_result = model_->processChunk(features, feature_timestamp_ms);
+    model_span.stop();
     
     auto model_end = std::chrono::steady_clock::now();
+    if (!model_records_stages_) {
+        metrics_.record(PipelineMetrics::Stage::ENCODER, elapsedUs(model_start, model_end));
+    }
     result.model_latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         model_end - model_start).count();
     
     // Combine results
     result.text = model_result.text;
     result.confidence = model_result.confidence;
+    result.stable_text = std::move(model_result.stable_text);
+    result.unstable_text = std::move(model_result.unstable_text);
+    result.stable_offset = model_result.stable_offset;
+    result.word_offsets = std::move(model_result.word_offsets);
+    result.word_start_ms = std::move(model_result.word_start_ms);
+    result.word_end_ms = std::move(model_result.word_end_ms);
     
     // Override finality if model says it's final or if VAD detected end of speech
     if (model_result.is_final) {
         result.is_final = true;
     }
     
+    // Step 4: Endpointing on the decoder output
+    if (config_.enable_endpointing &&
+        endpointer_.detect(model_result.utterance_ms, model_result.trailing_blank_ms,
+                           model_result.utterance_tokens > 0)) {
+        finalizeUtterance(result, timestamp_ms);
+    }
+    
     // Calculate total latency
     auto end_time = std::chrono::steady_clock::now();
     result.latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -142,11 +276,27 @@ STTPipeline::Result STTPipeline::processAudioInternal(const std::vector<float>&
     
     // Update statistics
     stats_.total_chunks_processed++;
-    updateStats(result);
     
     return result;
 }
 
+void STTPipeline::finalizeUtterance(Result& result, uint64_t timestamp_ms) {
+    StageTimer timer(&metrics_, PipelineMetrics::Stage::DECODER);
+    auto final_result = model_->finalize(timestamp_ms);
+    
+    // The final result commits what was still unstable; its words replace
+    // the unstable ones the chunk result already listed
+    result.stable_text += final_result.stable_text;
+    result.unstable_text.clear();
+    mergeWords(result, final_result);
+    result.is_final = true;
+    
+    // Start a fresh utterance: clears decoder state and encoder caches
+    model_->reset();
+    in_speech_segment_ = false;
+    stats_.endpoints++;
+}
+
 void STTPipeline::reset() {
     if (vad_) {
         vad_->reset();
@@ -154,27 +304,44 @@ void STTPipeline::reset() {
     if (model_) {
         model_->reset();
     }
+    if (resampler_) {
+        resampler_->reset();
+    }
     
     audio_buffer_.clear();
     last_speech_time_ms_ = 0;
     in_speech_segment_ = false;
+    context_pos_ = 0;
+    context_fill_ = 0;
+    skipped_samples_ = 0;
+    tail_remaining_ = 0;
     
     // Reset statistics
     stats_ = Stats();
+    metrics_.reset();
 }
 
 STTPipeline::Stats STTPipeline::getStats() const {
-    // Update real-time factor
-    if (stats_.total_chunks_processed > 0) {
-        // Assuming 100ms chunks (configurable)
-        double total_audio_ms = stats_.total_chunks_processed * 100.0;
-        double total_processing_ms = stats_.avg_total_latency_ms * stats_.total_chunks_processed;
-        stats_.real_time_factor = total_processing_ms / total_audio_ms;
-    }
+    // Averages and real-time factor from the stage histograms
+    const auto vad = metrics_.stage(PipelineMetrics::Stage::VAD).snapshot();
+    const auto fbank = metrics_.stage(PipelineMetrics::Stage::FBANK).snapshot();
+    const auto encoder = metrics_.stage(PipelineMetrics::Stage::ENCODER).snapshot();
+    const auto decoder = metrics_.stage(PipelineMetrics::Stage::DECODER).snapshot();
+    const auto detokenize = metrics_.stage(PipelineMetrics::Stage::DETOKENIZE).snapshot();
+    stats_.avg_vad_latency_ms = vad.meanUs() / 1000.0;
+    stats_.avg_feature_latency_ms = fbank.meanUs() / 1000.0;
+    stats_.avg_model_latency_ms = encoder.count > 0
+        ? (encoder.sum_us + decoder.sum_us + detokenize.sum_us) / 1000.0 / encoder.count
+        : 0.0;
+    stats_.avg_total_latency_ms = stats_.total_chunks_processed > 0
+        ? metrics_.processingUs() / 1000.0 / stats_.total_chunks_processed
+        : 0.0;
+    stats_.real_time_factor = metrics_.realTimeFactor();
+    stats_.total_audio_ms = metrics_.audioUs() / 1000;
     
     // Get component stats
     if (vad_) {
-        // VAD doesn't have a getStats method in our interface, so we'll use defaults
+        stats_.vad_stats = vad_->getStats();
         stats_.vad_stats["enabled"] = config_.enable_vad ? 1.0 : 0.0;
     }
     
@@ -190,6 +357,17 @@ bool STTPipeline::initializeVAD() {
         return true;
     }
     
+    switch (config_.vad_mode) {
+        case Config::ENERGY_VAD:
+            vad_ = createEnergyVAD(config_.vad_config);
+            return vad_ != nullptr;
+        case Config::CASCADE_VAD:
+            vad_ = createCascadeVAD(config_.vad_config, config_.cascade_config);
+            return vad_ != nullptr;
+        case Config::SILERO_VAD:
+            break;
+    }
+    
     // Try Silero VAD first, fall back to energy VAD
     vad_ = createSileroVAD(config_.vad_config);
     if (!vad_) {
@@ -221,25 +399,47 @@ bool STTPipeline::initializeFeatureExtractor() {
 
 bool STTPipeline::initializeModel() {
     model_ = createModel(config_.model_config);
-    return model_ != nullptr;
+    if (!model_) {
+        return false;
+    }
+    model_records_stages_ = model_->setMetrics(&metrics_);
+    return true;
 }
 
-void STTPipeline::updateStats(const Result& result) {
-    // Update latency averages
-    double n = static_cast<double>(stats_.total_chunks_processed);
-    
-    stats_.avg_vad_latency_ms = (stats_.avg_vad_latency_ms * (n - 1) + result.vad_latency_ms) / n;
-    stats_.avg_feature_latency_ms = (stats_.avg_feature_latency_ms * (n - 1) + result.feature_latency_ms) / n;
-    stats_.avg_model_latency_ms = (stats_.avg_model_latency_ms * (n - 1) + result.model_latency_ms) / n;
-    stats_.avg_total_latency_ms = (stats_.avg_total_latency_ms * (n - 1) + result.latency_ms) / n;
+void STTPipeline::pushContext(const float* samples, size_t num_samples) {
+    const size_t capacity = context_ring_.size();
+    if (capacity == 0) {
+        return;
+    }
+    if (num_samples >= capacity) {
+        std::copy(samples + num_samples - capacity, samples + num_samples, context_ring_.begin());
+        context_pos_ = 0;
+        context_fill_ = capacity;
+        return;
+    }
+    size_t first = std::min(num_samples, capacity - context_pos_);
+    std::copy(samples, samples + first, context_ring_.begin() + context_pos_);
+    std::copy(samples + first, samples + num_samples, context_ring_.begin());
+    context_pos_ = (context_pos_ + num_samples) % capacity;
+    context_fill_ = std::min(context_fill_ + num_samples, capacity);
 }
 
-std::vector<float> STTPipeline::convertInt16ToFloat(const int16_t* samples, size_t num_samples) {
-    std::vector<float> result(num_samples);
-    for (size_t i = 0; i < num_samples; ++i) {
-        result[i] = static_cast<float>(samples[i]) / 32768.0f;
+void STTPipeline::appendContext(size_t num_samples, std::vector<float>& out) const {
+    const size_t capacity = context_ring_.size();
+    num_samples = std::min(num_samples, context_fill_);
+    if (num_samples == 0) {
+        return;
     }
-    return result;
+    // The newest num_samples samples end just before context_pos_
+    size_t start = (context_pos_ + capacity - num_samples) % capacity;
+    size_t first = std::min(num_samples, capacity - start);
+    out.insert(out.end(), context_ring_.begin() + start, context_ring_.begin() + start + first);
+    out.insert(out.end(), context_ring_.begin(), context_ring_.begin() + (num_samples - first));
+}
+
+size_t STTPipeline::samplesToFrames(size_t num_samples) const {
+    size_t shift = static_cast<size_t>(config_.feature_config.frame_shift_ms) * config_.sample_rate / 1000;
+    return shift > 0 ? num_samples / shift : 0;
 }
 
 // Factory functions
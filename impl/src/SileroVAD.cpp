@@ -1,6 +1,8 @@
 #include "SileroVAD.hpp"
+#include "AudioKernels.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <numeric>
 
@@ -32,14 +34,29 @@ bool SileroVAD::initialize(const Config& config) {
             return false;
         }
         
+        // Window ring: consecutive windows overlap by window - shift samples
+        size_t window = static_cast<size_t>(window_size_samples_);
+        size_t shift = std::max(1, std::min(frame_shift_samples_, window_size_samples_));
+        audio_buffer_ = std::make_unique<StreamingBuffer>(window * 4, window, window - shift);
+        window_.assign(window, 0.0f);
+        
         // Initialize state tensors (for LSTM layers)
-        state_h_.resize(2 * 64, 0.0f); // 2 layers, 64 hidden units
-        state_c_.resize(2 * 64, 0.0f);
+        for (int i = 0; i < 2; ++i) {
+            state_h_[i].assign(kStateSize, 0.0f);
+            state_c_[i].assign(kStateSize, 0.0f);
+        }
+        state_index_ = 0;
+        
+        if (!bindTensors()) {
+            session_.reset();
+            return false;
+        }
         
         return true;
         
     } catch (const std::exception& e) {
         std::cerr << "Failed to initialize Silero VAD: " << e.what() << std::endl;
+        session_.reset();
         return false;
     }
 }
@@ -54,6 +71,8 @@ bool SileroVAD::loadModel(const std::string& model_path) {
         
         // Input names and shapes
         size_t num_inputs = session_->GetInputCount();
+        input_names_.clear();
+        input_shapes_.clear();
         input_names_.reserve(num_inputs);
         input_shapes_.reserve(num_inputs);
         
@@ -67,6 +86,8 @@ bool SileroVAD::loadModel(const std::string& model_path) {
         
         // Output names and shapes  
         size_t num_outputs = session_->GetOutputCount();
+        output_names_.clear();
+        output_shapes_.clear();
         output_names_.reserve(num_outputs);
         output_shapes_.reserve(num_outputs);
         
@@ -78,6 +99,16 @@ bool SileroVAD::loadModel(const std::string& model_path) {
             output_shapes_.emplace_back(output_shape);
         }
         
+        // Cache the name arrays handed to every Run
+        input_name_ptrs_.clear();
+        for (const auto& name : input_names_) {
+            input_name_ptrs_.push_back(name.c_str());
+        }
+        output_name_ptrs_.clear();
+        for (const auto& name : output_names_) {
+            output_name_ptrs_.push_back(name.c_str());
+        }
+        
         return true;
         
     } catch (const std::exception& e) {
@@ -86,98 +117,116 @@ bool SileroVAD::loadModel(const std::string& model_path) {
     }
 }
 
+bool SileroVAD::bindTensors() {
+    if (output_names_.size() < 3) {
+        std::cerr << "Silero VAD model must output probability, h and c" << std::endl;
+        return false;
+    }
+    
+    memory_info_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    sample_rate_value_ = config_.sample_rate;
+    
+    std::vector<int64_t> audio_shape = {1, static_cast<int64_t>(window_.size())};
+    std::vector<int64_t> state_shape = {2, 1, 64}; // [layers, batch, hidden]
+    std::vector<int64_t> prob_shape = {1, 1};
+    
+    for (int phase = 0; phase < 2; ++phase) {
+        std::vector<float>& h_in = state_h_[phase];
+        std::vector<float>& c_in = state_c_[phase];
+        std::vector<float>& h_out = state_h_[1 - phase];
+        std::vector<float>& c_out = state_c_[1 - phase];
+        
+        // Inputs by name; exports without "h"/"c" names use (audio, h, c) order
+        input_tensors_[phase].clear();
+        int state_inputs = 0;
+        for (size_t i = 0; i < input_names_.size(); ++i) {
+            const std::string& name = input_names_[i];
+            if (name == "sr") {
+                input_tensors_[phase].push_back(Ort::Value::CreateTensor<int64_t>(
+                    memory_info_, &sample_rate_value_, 1, nullptr, 0));
+            } else if (name == "h" || (name != "c" && i == 1)) {
+                input_tensors_[phase].push_back(Ort::Value::CreateTensor<float>(
+                    memory_info_, h_in.data(), h_in.size(), state_shape.data(), state_shape.size()));
+                state_inputs++;
+            } else if (name == "c" || i == 2) {
+                input_tensors_[phase].push_back(Ort::Value::CreateTensor<float>(
+                    memory_info_, c_in.data(), c_in.size(), state_shape.data(), state_shape.size()));
+                state_inputs++;
+            } else {
+                input_tensors_[phase].push_back(Ort::Value::CreateTensor<float>(
+                    memory_info_, window_.data(), window_.size(), audio_shape.data(), audio_shape.size()));
+            }
+        }
+        if (state_inputs != 2) {
+            std::cerr << "Unsupported Silero VAD model inputs" << std::endl;
+            return false;
+        }
+        
+        // Outputs are written in place: probability, then the other state pair
+        output_tensors_[phase].clear();
+        output_tensors_[phase].push_back(Ort::Value::CreateTensor<float>(
+            memory_info_, &speech_prob_, 1, prob_shape.data(), prob_shape.size()));
+        output_tensors_[phase].push_back(Ort::Value::CreateTensor<float>(
+            memory_info_, h_out.data(), h_out.size(), state_shape.data(), state_shape.size()));
+        output_tensors_[phase].push_back(Ort::Value::CreateTensor<float>(
+            memory_info_, c_out.data(), c_out.size(), state_shape.data(), state_shape.size()));
+    }
+    
+    // Extra outputs (if any) are not requested
+    output_name_ptrs_.resize(3);
+    return true;
+}
+
 VADInterface::VADResult SileroVAD::processChunk(const int16_t* samples, 
                                                size_t num_samples, 
                                                uint64_t timestamp_ms) {
-    std::vector<float> audio_float;
-    convertInt16ToFloat(samples, num_samples, audio_float);
-    return processChunk(audio_float, timestamp_ms);
+    scratch_.resize(num_samples);
+    audio_kernels::int16ToFloat(samples, scratch_.data(), num_samples, 1.0f / 32768.0f);
+    return processSamples(scratch_.data(), num_samples, timestamp_ms);
 }
 
 VADInterface::VADResult SileroVAD::processChunk(const std::vector<float>& audio, 
                                                uint64_t timestamp_ms) {
+    return processSamples(audio.data(), audio.size(), timestamp_ms);
+}
+
+VADInterface::VADResult SileroVAD::processSamples(const float* samples, size_t num_samples, 
+                                                 uint64_t timestamp_ms) {
     if (!session_) {
         // Fallback: assume all audio is speech if no model loaded
         return {true, 1.0f, timestamp_ms};
     }
     
-    // Add to buffer
-    audio_buffer_.insert(audio_buffer_.end(), audio.begin(), audio.end());
-    
     VADResult result = {false, 0.0f, timestamp_ms};
     
-    // Process complete windows
-    while (audio_buffer_.size() >= static_cast<size_t>(window_size_samples_)) {
-        std::vector<float> window(audio_buffer_.begin(), 
-                                 audio_buffer_.begin() + window_size_samples_);
+    // Feed the ring in pieces it can hold and process complete windows
+    size_t offset = 0;
+    while (offset < num_samples) {
+        offset += audio_buffer_->append(samples + offset, num_samples - offset);
         
-        auto window_result = runInference(window, timestamp_ms);
-        
-        // Use the latest result (could accumulate/average multiple windows)
-        result = window_result;
-        
-        // Shift buffer by frame_shift_samples_
-        audio_buffer_.erase(audio_buffer_.begin(), 
-                           audio_buffer_.begin() + frame_shift_samples_);
+        while (const float* window = audio_buffer_->nextChunk()) {
+            std::memcpy(window_.data(), window, window_.size() * sizeof(float));
+            
+            // Use the latest result (could accumulate/average multiple windows)
+            result = runInference(timestamp_ms);
+        }
     }
     
     return result;
 }
 
-VADInterface::VADResult SileroVAD::runInference(const std::vector<float>& audio_chunk, 
-                                               uint64_t timestamp_ms) {
+VADInterface::VADResult SileroVAD::runInference(uint64_t timestamp_ms) {
     try {
-        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-        
-        // Prepare input tensors
-        std::vector<Ort::Value> input_tensors;
-        std::vector<const char*> input_names_ptr;
-        
-        for (size_t i = 0; i < input_names_.size(); ++i) {
-            input_names_ptr.push_back(input_names_[i].c_str());
-        }
+        const int phase = state_index_;
+        session_->Run(Ort::RunOptions{nullptr},
+                      input_name_ptrs_.data(), input_tensors_[phase].data(), input_tensors_[phase].size(),
+                      output_name_ptrs_.data(), output_tensors_[phase].data(), output_tensors_[phase].size());
         
-        // Input audio tensor [1, window_size]
-        std::vector<int64_t> audio_shape = {1, static_cast<int64_t>(audio_chunk.size())};
-        input_tensors.emplace_back(Ort::Value::CreateTensor<float>(
-            memory_info, const_cast<float*>(audio_chunk.data()), 
-            audio_chunk.size(), audio_shape.data(), audio_shape.size()));
+        // New states were written to the other pair; read it next time
+        state_index_ = 1 - phase;
+        windows_processed_++;
         
-        // State tensors (h and c for LSTM)
-        std::vector<int64_t> state_shape = {2, 1, 64}; // [layers, batch, hidden]
-        input_tensors.emplace_back(Ort::Value::CreateTensor<float>(
-            memory_info, state_h_.data(), state_h_.size(), 
-            state_shape.data(), state_shape.size()));
-        input_tensors.emplace_back(Ort::Value::CreateTensor<float>(
-            memory_info, state_c_.data(), state_c_.size(), 
-            state_shape.data(), state_shape.size()));
-        
-        // Prepare output tensors
-        std::vector<const char*> output_names_ptr;
-        for (const auto& name : output_names_) {
-            output_names_ptr.push_back(name.c_str());
-        }
-        
-        // Run inference
-        auto output_tensors = session_->Run(Ort::RunOptions{nullptr}, 
-                                          input_names_ptr.data(), input_tensors.data(), input_tensors.size(),
-                                          output_names_ptr.data(), output_names_ptr.size());
-        
-        // Extract speech probability
-        float* output_data = output_tensors[0].GetTensorMutableData<float>();
-        float speech_prob = output_data[0];
-        
-        // Update states if available
-        if (output_tensors.size() > 1) {
-            float* new_h = output_tensors[1].GetTensorMutableData<float>();
-            std::copy(new_h, new_h + state_h_.size(), state_h_.begin());
-        }
-        if (output_tensors.size() > 2) {
-            float* new_c = output_tensors[2].GetTensorMutableData<float>();
-            std::copy(new_c, new_c + state_c_.size(), state_c_.begin());
-        }
-        
-        return {speech_prob > config_.speech_threshold, speech_prob, timestamp_ms};
+        return {speech_prob_ > config_.speech_threshold, speech_prob_, timestamp_ms};
         
     } catch (const std::exception& e) {
         std::cerr << "Silero VAD inference failed: " << e.what() << std::endl;
@@ -185,17 +234,18 @@ VADInterface::VADResult SileroVAD::runInference(const std::vector<float>& audio_
     }
 }
 
-void SileroVAD::reset() {
-    std::fill(state_h_.begin(), state_h_.end(), 0.0f);
-    std::fill(state_c_.begin(), state_c_.end(), 0.0f);
-    audio_buffer_.clear();
+std::map<std::string, double> SileroVAD::getStats() const {
+    return {{"windows", static_cast<double>(windows_processed_)}};
 }
 
-void SileroVAD::convertInt16ToFloat(const int16_t* samples, size_t num_samples, 
-                                   std::vector<float>& output) {
-    output.resize(num_samples);
-    for (size_t i = 0; i < num_samples; ++i) {
-        output[i] = static_cast<float>(samples[i]) / 32768.0f;
+void SileroVAD::reset() {
+    for (int i = 0; i < 2; ++i) {
+        std::fill(state_h_[i].begin(), state_h_[i].end(), 0.0f);
+        std::fill(state_c_[i].begin(), state_c_[i].end(), 0.0f);
+    }
+    state_index_ = 0;
+    if (audio_buffer_) {
+        audio_buffer_->clear();
     }
 }
 
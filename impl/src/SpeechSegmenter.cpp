@@ -0,0 +1,225 @@
+#include "SpeechSegmenter.hpp"
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace onnx_stt {
+
+SpeechSegmenter::SpeechSegmenter()
+    : SpeechSegmenter(Config()) {
+}
+
+SpeechSegmenter::SpeechSegmenter(const Config& config)
+    : config_(config) {
+    auto samples = [this](int ms) {
+        return static_cast<size_t>(std::max(ms, 0)) * config_.sample_rate / 1000;
+    };
+    pre_roll_ = samples(config_.pre_roll_ms);
+    post_roll_ = samples(config_.post_roll_ms);
+    close_after_ = post_roll_ + pre_roll_ + samples(config_.merge_gap_ms);
+    min_speech_ = samples(config_.min_segment_ms);
+    // Room for the pre-roll plus at least a second of audio to cut in
+    max_segment_ = std::max(samples(config_.max_segment_ms),
+                            pre_roll_ + static_cast<size_t>(config_.sample_rate));
+    reset();
+}
+
+size_t SpeechSegmenter::push(const float* samples, size_t num_samples, bool is_speech,
+                             std::vector<SpeechSegment>& out) {
+    stats_.samples_in += num_samples;
+
+    if (!in_segment_) {
+        if (!is_speech) {
+            keepHistory(samples, num_samples);
+            position_ += num_samples;
+            return 0;
+        }
+        // Speech onset: the segment starts with the buffered pre-roll
+        in_segment_ = true;
+        current_ = SpeechSegment();
+        current_.audio.swap(history_);
+        current_start_ = position_ - current_.audio.size();
+        trailing_silence_ = 0;
+        speech_samples_ = 0;
+    }
+
+    appendToSegment(samples, num_samples, is_speech);
+    position_ += num_samples;
+
+    size_t produced = 0;
+    while (in_segment_ && current_.audio.size() >= max_segment_) {
+        produced += cutSegment(out);
+    }
+    // Close once the silence is too long for the next region to merge
+    if (in_segment_ && trailing_silence_ > close_after_) {
+        produced += closeSegment(current_.audio.size() - trailing_silence_ + post_roll_, out);
+    }
+    return produced;
+}
+
+size_t SpeechSegmenter::flush(std::vector<SpeechSegment>& out) {
+    size_t produced = 0;
+    if (in_segment_) {
+        size_t keep = current_.audio.size() - trailing_silence_ +
+                      std::min(trailing_silence_, post_roll_);
+        produced = closeSegment(keep, out);
+    }
+    history_.clear();
+    position_ = 0;
+    return produced;
+}
+
+void SpeechSegmenter::reset() {
+    history_.clear();
+    in_segment_ = false;
+    current_ = SpeechSegment();
+    current_start_ = 0;
+    trailing_silence_ = 0;
+    speech_samples_ = 0;
+    position_ = 0;
+}
+
+void SpeechSegmenter::appendToSegment(const float* samples, size_t num_samples, bool is_speech) {
+    current_.audio.insert(current_.audio.end(), samples, samples + num_samples);
+    if (is_speech) {
+        trailing_silence_ = 0;
+        speech_samples_ += num_samples;
+    } else {
+        trailing_silence_ += num_samples;
+    }
+}
+
+size_t SpeechSegmenter::closeSegment(size_t keep_samples, std::vector<SpeechSegment>& out) {
+    std::vector<float>& audio = current_.audio;
+    keep_samples = std::min(keep_samples, audio.size());
+    in_segment_ = false;
+
+    // The end of this segment's silence is the pre-roll of the next one
+    size_t history = std::min(pre_roll_, audio.size());
+    history_.assign(audio.end() - history, audio.end());
+
+    if (speech_samples_ < min_speech_) {
+        stats_.dropped_short++;
+        current_ = SpeechSegment();
+        return 0;
+    }
+
+    audio.resize(keep_samples);
+    current_.id = next_id_++;
+    current_.start_ms = toMs(current_start_);
+    current_.end_ms = toMs(current_start_ + keep_samples);
+    current_.speech_ms = toMs(speech_samples_);
+    stats_.segments++;
+    stats_.samples_emitted += keep_samples;
+    out.push_back(std::move(current_));
+    current_ = SpeechSegment();
+    return 1;
+}
+
+size_t SpeechSegmenter::cutSegment(std::vector<SpeechSegment>& out) {
+    std::vector<float>& audio = current_.audio;
+
+    // Cut at the quietest 10 ms frame of the last second before the limit
+    const size_t frame = std::max<size_t>(config_.sample_rate / 100, 1);
+    const size_t search_end = max_segment_ - frame;
+    const size_t search_begin = max_segment_ - static_cast<size_t>(config_.sample_rate);
+    size_t cut = max_segment_;
+    float quietest = std::numeric_limits<float>::max();
+    for (size_t pos = search_begin; pos <= search_end; pos += frame) {
+        float energy = audio_kernels::dot(&audio[pos], &audio[pos], frame);
+        if (energy < quietest) {
+            quietest = energy;
+            cut = pos + frame / 2;
+        }
+    }
+
+    SpeechSegment segment;
+    segment.audio.assign(audio.begin(), audio.begin() + cut);
+    uint64_t segment_speech = std::min<uint64_t>(speech_samples_, cut);
+    segment.id = next_id_++;
+    segment.start_ms = toMs(current_start_);
+    segment.end_ms = toMs(current_start_ + cut);
+    segment.speech_ms = toMs(segment_speech);
+    out.push_back(std::move(segment));
+    stats_.segments++;
+    stats_.forced_cuts++;
+    stats_.samples_emitted += cut;
+
+    // The rest continues as the next segment
+    audio.erase(audio.begin(), audio.begin() + cut);
+    current_start_ += cut;
+    speech_samples_ -= segment_speech;
+    trailing_silence_ = std::min(trailing_silence_, audio.size());
+    return 1;
+}
+
+void SpeechSegmenter::keepHistory(const float* samples, size_t num_samples) {
+    if (num_samples >= pre_roll_) {
+        history_.assign(samples + num_samples - pre_roll_, samples + num_samples);
+        return;
+    }
+    history_.insert(history_.end(), samples, samples + num_samples);
+    if (history_.size() > pre_roll_) {
+        history_.erase(history_.begin(), history_.end() - pre_roll_);
+    }
+}
+
+uint64_t SpeechSegmenter::toMs(uint64_t samples) const {
+    return samples * 1000 / config_.sample_rate;
+}
+
+void SegmentQueue::push(SpeechSegment segment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_samples_ += segment.audio.size();
+    pending_.push_back(std::move(segment));
+}
+
+void SegmentQueue::push(std::vector<SpeechSegment>& segments) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& segment : segments) {
+        pending_samples_ += segment.audio.size();
+        pending_.push_back(std::move(segment));
+    }
+    segments.clear();
+}
+
+std::vector<SpeechSegment> SegmentQueue::popBatch(size_t max_segments, size_t max_batch_samples) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<SpeechSegment> batch;
+    if (pending_.empty() || max_segments == 0) {
+        return batch;
+    }
+
+    // Shortest first, so the longest are popped from the back
+    std::sort(pending_.begin(), pending_.end(),
+              [](const SpeechSegment& a, const SpeechSegment& b) {
+                  return a.audio.size() < b.audio.size();
+              });
+
+    const size_t longest = pending_.back().audio.size();
+    while (!pending_.empty() && batch.size() < max_segments &&
+           (batch.empty() || (batch.size() + 1) * longest <= max_batch_samples)) {
+        pending_samples_ -= pending_.back().audio.size();
+        batch.push_back(std::move(pending_.back()));
+        pending_.pop_back();
+    }
+    return batch;
+}
+
+size_t SegmentQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+bool SegmentQueue::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.empty();
+}
+
+uint64_t SegmentQueue::pendingSamples() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_samples_;
+}
+
+} // namespace onnx_stt
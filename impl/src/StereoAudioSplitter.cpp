@@ -1,4 +1,6 @@
 #include "StereoAudioSplitter.hpp"
+#include "AudioKernels.hpp"
+#include "PolyphaseResampler.hpp"
 #include <algorithm>
 #include <cmath>
 #include <cstring>
@@ -90,6 +92,68 @@ int16_t StereoAudioSplitter::alawToPcm(uint8_t alaw) {
     return alaw_table[alaw];
 }
 
+namespace {
+
+// Float decode tables derived once from the int16 G.711 tables
+struct G711FloatTables {
+    float normalized[256];
+    float pcm[256];
+    
+    explicit G711FloatTables(int16_t (*decode)(uint8_t)) {
+        for (int i = 0; i < 256; ++i) {
+            int16_t value = decode(static_cast<uint8_t>(i));
+            normalized[i] = value / 32768.0f;
+            pcm[i] = static_cast<float>(value);
+        }
+    }
+};
+
+} // anonymous namespace
+
+const float* StereoAudioSplitter::ulawFloatTable(bool normalize) {
+    static const G711FloatTables tables(&StereoAudioSplitter::ulawToPcm);
+    return normalize ? tables.normalized : tables.pcm;
+}
+
+const float* StereoAudioSplitter::alawFloatTable(bool normalize) {
+    static const G711FloatTables tables(&StereoAudioSplitter::alawToPcm);
+    return normalize ? tables.normalized : tables.pcm;
+}
+
+const float* StereoAudioSplitter::pcm8FloatTable(bool normalize) {
+    // Unsigned 8-bit: a table avoids the per-sample offset and scale
+    static const struct Pcm8Tables {
+        float normalized[256];
+        float pcm[256];
+        Pcm8Tables() {
+            for (int i = 0; i < 256; ++i) {
+                normalized[i] = normalizeUint8(static_cast<uint8_t>(i));
+                pcm[i] = static_cast<float>(i - 128);
+            }
+        }
+    } tables;
+    return normalize ? tables.normalized : tables.pcm;
+}
+
+size_t StereoAudioSplitter::splitInterleavedPCM16(
+    const int16_t* interleavedData,
+    size_t numSamples,
+    float* left,
+    float* right,
+    bool normalizeFloat) {
+    
+    if (numSamples % 2 != 0) {
+        throw std::invalid_argument("Number of samples must be even for stereo data");
+    }
+    
+    // Split interleaved samples: L R L R L R -> L L L, R R R
+    size_t numSamplesPerChannel = numSamples / 2;
+    onnx_stt::audio_kernels::deinterleaveStereoInt16(
+        interleavedData, left, right, numSamplesPerChannel,
+        normalizeFloat ? 1.0f / 32768.0f : 1.0f);
+    return numSamplesPerChannel;
+}
+
 StereoAudioSplitter::ChannelBuffers 
 StereoAudioSplitter::splitInterleavedPCM16(
     const int16_t* interleavedData, 
@@ -101,73 +165,53 @@ StereoAudioSplitter::splitInterleavedPCM16(
     }
     
     ChannelBuffers result;
-    size_t numSamplesPerChannel = numSamples / 2;
-    
-    result.left.reserve(numSamplesPerChannel);
-    result.right.reserve(numSamplesPerChannel);
-    
-    // Split interleaved samples: L R L R L R -> L L L, R R R
-    for (size_t i = 0; i < numSamples; i += 2) {
-        float leftSample = options.normalizeFloat ? 
-            normalizeInt16(interleavedData[i]) : 
-            static_cast<float>(interleavedData[i]);
-            
-        float rightSample = options.normalizeFloat ? 
-            normalizeInt16(interleavedData[i + 1]) : 
-            static_cast<float>(interleavedData[i + 1]);
-        
-        result.left.push_back(leftSample);
-        result.right.push_back(rightSample);
-    }
+    result.left.resize(numSamples / 2);
+    result.right.resize(numSamples / 2);
+    splitInterleavedPCM16(interleavedData, numSamples,
+                          result.left.data(), result.right.data(), options.normalizeFloat);
     
     // Apply resampling if needed (e.g., 8kHz to 16kHz for NeMo)
     if (options.targetSampleRate > 0 && 
         options.targetSampleRate != options.sourceSampleRate) {
-        float factor = static_cast<float>(options.targetSampleRate) / 
-                      static_cast<float>(options.sourceSampleRate);
-        
-        if (factor > 1.0f) {
-            result.left = upsampleLinear(result.left, factor);
-            result.right = upsampleLinear(result.right, factor);
-        } else {
-            // Downsampling not implemented yet
-            throw std::runtime_error("Downsampling not yet implemented");
-        }
+        result.left = resample(result.left, options.sourceSampleRate, options.targetSampleRate);
+        result.right = resample(result.right, options.sourceSampleRate, options.targetSampleRate);
     }
     
     return result;
 }
 
-StereoAudioSplitter::ChannelBuffers 
-StereoAudioSplitter::splitInterleavedPCM8(
+size_t StereoAudioSplitter::splitInterleavedPCM8(
     const uint8_t* interleavedData,
     size_t numSamples,
-    const SplitOptions& options) {
+    float* left,
+    float* right,
+    bool normalizeFloat) {
     
     if (numSamples % 2 != 0) {
         throw std::invalid_argument("Number of samples must be even for stereo data");
     }
     
-    ChannelBuffers result;
     size_t numSamplesPerChannel = numSamples / 2;
+    onnx_stt::audio_kernels::deinterleaveStereoTable(
+        interleavedData, pcm8FloatTable(normalizeFloat), left, right, numSamplesPerChannel);
+    return numSamplesPerChannel;
+}
+
+StereoAudioSplitter::ChannelBuffers 
+StereoAudioSplitter::splitInterleavedPCM8(
+    const uint8_t* interleavedData,
+    size_t numSamples,
+    const SplitOptions& options) {
     
-    result.left.reserve(numSamplesPerChannel);
-    result.right.reserve(numSamplesPerChannel);
-    
-    // Split interleaved 8-bit samples
-    for (size_t i = 0; i < numSamples; i += 2) {
-        float leftSample = options.normalizeFloat ? 
-            normalizeUint8(interleavedData[i]) : 
-            static_cast<float>(interleavedData[i] - 128);
-            
-        float rightSample = options.normalizeFloat ? 
-            normalizeUint8(interleavedData[i + 1]) : 
-            static_cast<float>(interleavedData[i + 1] - 128);
-        
-        result.left.push_back(leftSample);
-        result.right.push_back(rightSample);
+    if (numSamples % 2 != 0) {
+        throw std::invalid_argument("Number of samples must be even for stereo data");
     }
     
+    ChannelBuffers result;
+    result.left.resize(numSamples / 2);
+    result.right.resize(numSamples / 2);
+    splitInterleavedPCM8(interleavedData, numSamples,
+                         result.left.data(), result.right.data(), options.normalizeFloat);
     return result;
 }
 
@@ -179,72 +223,74 @@ StereoAudioSplitter::splitNonInterleaved(
     const SplitOptions& options) {
     
     ChannelBuffers result;
-    result.left.reserve(numSamplesPerChannel);
-    result.right.reserve(numSamplesPerChannel);
+    result.left.resize(numSamplesPerChannel);
+    result.right.resize(numSamplesPerChannel);
     
-    // Process left channel
-    for (size_t i = 0; i < numSamplesPerChannel; ++i) {
-        float sample = options.normalizeFloat ? 
-            normalizeInt16(leftData[i]) : 
-            static_cast<float>(leftData[i]);
-        result.left.push_back(sample);
-    }
-    
-    // Process right channel
-    for (size_t i = 0; i < numSamplesPerChannel; ++i) {
-        float sample = options.normalizeFloat ? 
-            normalizeInt16(rightData[i]) : 
-            static_cast<float>(rightData[i]);
-        result.right.push_back(sample);
-    }
+    const float scale = options.normalizeFloat ? 1.0f / 32768.0f : 1.0f;
+    onnx_stt::audio_kernels::int16ToFloat(leftData, result.left.data(), numSamplesPerChannel, scale);
+    onnx_stt::audio_kernels::int16ToFloat(rightData, result.right.data(), numSamplesPerChannel, scale);
     
     return result;
 }
 
-StereoAudioSplitter::ChannelBuffers 
-StereoAudioSplitter::splitG711uLaw(
+size_t StereoAudioSplitter::splitG711(
     const uint8_t* g711Data,
     size_t numBytes,
+    const float* table,
+    float* left,
+    float* right,
     bool isInterleaved) {
     
-    ChannelBuffers result;
+    size_t numSamplesPerChannel = numBytes / 2;
     
     if (isInterleaved) {
         if (numBytes % 2 != 0) {
             throw std::invalid_argument("Number of bytes must be even for interleaved stereo");
         }
         
-        size_t numSamplesPerChannel = numBytes / 2;
-        result.left.reserve(numSamplesPerChannel);
-        result.right.reserve(numSamplesPerChannel);
-        
-        // Decode interleaved µ-law: L R L R -> PCM L L L, R R R
-        for (size_t i = 0; i < numBytes; i += 2) {
-            int16_t leftPcm = ulawToPcm(g711Data[i]);
-            int16_t rightPcm = ulawToPcm(g711Data[i + 1]);
-            
-            result.left.push_back(normalizeInt16(leftPcm));
-            result.right.push_back(normalizeInt16(rightPcm));
-        }
+        // Decode interleaved G.711: L R L R -> PCM L L L, R R R
+        onnx_stt::audio_kernels::deinterleaveStereoTable(g711Data, table, left, right,
+                                                         numSamplesPerChannel);
     } else {
         // Non-interleaved: first half is left, second half is right
-        size_t numSamplesPerChannel = numBytes / 2;
-        result.left.reserve(numSamplesPerChannel);
-        result.right.reserve(numSamplesPerChannel);
-        
-        // Decode left channel
-        for (size_t i = 0; i < numSamplesPerChannel; ++i) {
-            int16_t pcm = ulawToPcm(g711Data[i]);
-            result.left.push_back(normalizeInt16(pcm));
-        }
-        
-        // Decode right channel
-        for (size_t i = numSamplesPerChannel; i < numBytes; ++i) {
-            int16_t pcm = ulawToPcm(g711Data[i]);
-            result.right.push_back(normalizeInt16(pcm));
-        }
+        onnx_stt::audio_kernels::decodeTable(g711Data, table, left, numSamplesPerChannel);
+        onnx_stt::audio_kernels::decodeTable(g711Data + numSamplesPerChannel, table, right,
+                                             numSamplesPerChannel);
     }
     
+    return numSamplesPerChannel;
+}
+
+size_t StereoAudioSplitter::splitG711uLaw(
+    const uint8_t* g711Data,
+    size_t numBytes,
+    float* left,
+    float* right,
+    bool isInterleaved,
+    bool normalizeFloat) {
+    return splitG711(g711Data, numBytes, ulawFloatTable(normalizeFloat), left, right, isInterleaved);
+}
+
+size_t StereoAudioSplitter::splitG711aLaw(
+    const uint8_t* g711Data,
+    size_t numBytes,
+    float* left,
+    float* right,
+    bool isInterleaved,
+    bool normalizeFloat) {
+    return splitG711(g711Data, numBytes, alawFloatTable(normalizeFloat), left, right, isInterleaved);
+}
+
+StereoAudioSplitter::ChannelBuffers 
+StereoAudioSplitter::splitG711uLaw(
+    const uint8_t* g711Data,
+    size_t numBytes,
+    bool isInterleaved) {
+    
+    ChannelBuffers result;
+    result.left.resize(numBytes / 2);
+    result.right.resize(numBytes / 2);
+    splitG711uLaw(g711Data, numBytes, result.left.data(), result.right.data(), isInterleaved);
     return result;
 }
 
@@ -255,43 +301,9 @@ StereoAudioSplitter::splitG711aLaw(
     bool isInterleaved) {
     
     ChannelBuffers result;
-    
-    if (isInterleaved) {
-        if (numBytes % 2 != 0) {
-            throw std::invalid_argument("Number of bytes must be even for interleaved stereo");
-        }
-        
-        size_t numSamplesPerChannel = numBytes / 2;
-        result.left.reserve(numSamplesPerChannel);
-        result.right.reserve(numSamplesPerChannel);
-        
-        // Decode interleaved A-law
-        for (size_t i = 0; i < numBytes; i += 2) {
-            int16_t leftPcm = alawToPcm(g711Data[i]);
-            int16_t rightPcm = alawToPcm(g711Data[i + 1]);
-            
-            result.left.push_back(normalizeInt16(leftPcm));
-            result.right.push_back(normalizeInt16(rightPcm));
-        }
-    } else {
-        // Non-interleaved
-        size_t numSamplesPerChannel = numBytes / 2;
-        result.left.reserve(numSamplesPerChannel);
-        result.right.reserve(numSamplesPerChannel);
-        
-        // Decode left channel
-        for (size_t i = 0; i < numSamplesPerChannel; ++i) {
-            int16_t pcm = alawToPcm(g711Data[i]);
-            result.left.push_back(normalizeInt16(pcm));
-        }
-        
-        // Decode right channel
-        for (size_t i = numSamplesPerChannel; i < numBytes; ++i) {
-            int16_t pcm = alawToPcm(g711Data[i]);
-            result.right.push_back(normalizeInt16(pcm));
-        }
-    }
-    
+    result.left.resize(numBytes / 2);
+    result.right.resize(numBytes / 2);
+    splitG711aLaw(g711Data, numBytes, result.left.data(), result.right.data(), isInterleaved);
     return result;
 }
 
@@ -342,15 +354,10 @@ std::vector<float> StereoAudioSplitter::resample(
         return input;  // No resampling needed
     }
     
-    float factor = static_cast<float>(outputRate) / static_cast<float>(inputRate);
-    
-    if (factor > 1.0f) {
-        // Upsampling
-        return upsampleLinear(input, factor);
-    } else {
-        // Downsampling - not implemented yet
-        throw std::runtime_error("Downsampling not yet implemented");
-    }
+    // Band-limited in both directions; stream with PolyphaseResampler
+    // instead when the audio arrives in chunks
+    return onnx_stt::PolyphaseResampler::resample(input.data(), input.size(),
+                                                  inputRate, outputRate);
 }
 
 } // namespace stt
@@ -0,0 +1,209 @@
+#include "TokenVocabulary.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace onnx_stt {
+
+namespace {
+
+// U+2581 LOWER ONE EIGHTH BLOCK, the SentencePiece word marker
+const char kWordMarker[] = "\xE2\x96\x81";
+const size_t kWordMarkerLen = 3;
+
+// WordPiece continuation prefix
+const char kContinuation[] = "##";
+const size_t kContinuationLen = 2;
+
+} // namespace
+
+std::shared_ptr<const TokenVocabulary> TokenVocabulary::load(const std::string& path) {
+    static std::mutex registry_mutex;
+    static std::map<std::string, std::weak_ptr<const TokenVocabulary>> registry;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = registry.find(path);
+    if (it != registry.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    std::shared_ptr<TokenVocabulary> vocab(new TokenVocabulary());
+    if (!vocab->parse(path)) {
+        return nullptr;
+    }
+    registry[path] = vocab;
+    return vocab;
+}
+
+bool TokenVocabulary::parse(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open tokens file: " << path << std::endl;
+        return false;
+    }
+
+    // Collect (id, piece) first: ids may be explicit and out of order
+    std::vector<std::pair<int, std::string>> entries;
+    std::string line;
+    int next_id = 0;
+    int max_id = -1;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        // Format: "piece id", "piece<TAB>score" or just "piece"
+        std::string piece = line;
+        int id = next_id;
+        size_t tab_pos = line.find('\t');
+        size_t space_pos = line.find_last_of(' ');
+        if (tab_pos != std::string::npos && tab_pos > 0) {
+            piece = line.substr(0, tab_pos);
+        } else if (space_pos != std::string::npos && space_pos > 0 && space_pos + 1 < line.size()) {
+            char* end = nullptr;
+            long parsed = std::strtol(line.c_str() + space_pos + 1, &end, 10);
+            if (*end == '\0' && parsed >= 0) {
+                piece = line.substr(0, space_pos);
+                id = static_cast<int>(parsed);
+            }
+        }
+        entries.emplace_back(id, piece);
+        next_id = id + 1;
+        max_id = std::max(max_id, id);
+    }
+
+    if (entries.empty()) {
+        std::cerr << "Tokens file is empty: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<const std::string*> by_id(max_id + 1, nullptr);
+    bool has_marker = false;
+    bool has_continuation = false;
+    for (const auto& entry : entries) {
+        by_id[entry.first] = &entry.second;
+        has_marker |= entry.second.compare(0, kWordMarkerLen, kWordMarker) == 0;
+        has_continuation |= entry.second.compare(0, kContinuationLen, kContinuation) == 0;
+    }
+
+    // WordPiece vocabularies mark continuations instead of word starts
+    const bool wordpiece = has_continuation && !has_marker;
+
+    size_t total = 0;
+    for (const auto& entry : entries) {
+        total += entry.second.size();
+    }
+    blob_.reserve(total);
+
+    int count = max_id + 1;
+    piece_begin_.resize(count);
+    text_begin_.resize(count);
+    piece_end_.resize(count);
+    starts_word_.assign(count, 0);
+
+    for (int id = 0; id < count; ++id) {
+        uint32_t begin = static_cast<uint32_t>(blob_.size());
+        piece_begin_[id] = begin;
+        text_begin_[id] = begin;
+        if (by_id[id]) {
+            const std::string& piece = *by_id[id];
+            blob_ += piece;
+            if (wordpiece) {
+                if (piece.compare(0, kContinuationLen, kContinuation) == 0) {
+                    text_begin_[id] = begin + kContinuationLen;
+                } else {
+                    starts_word_[id] = 1;
+                }
+            } else if (piece.compare(0, kWordMarkerLen, kWordMarker) == 0) {
+                starts_word_[id] = 1;
+                text_begin_[id] = begin + kWordMarkerLen;
+            }
+        }
+        piece_end_[id] = static_cast<uint32_t>(blob_.size());
+    }
+
+    std::cout << "Loaded vocabulary: " << count << " tokens from " << path << std::endl;
+    return true;
+}
+
+int TokenVocabulary::findId(const std::string& piece) const {
+    for (int id = 0; id < size(); ++id) {
+        if (piece_end_[id] - piece_begin_[id] == piece.size() &&
+            blob_.compare(piece_begin_[id], piece.size(), piece) == 0) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+std::string TokenVocabulary::piece(int id) const {
+    if (id < 0 || id >= size()) {
+        return std::string();
+    }
+    return blob_.substr(piece_begin_[id], piece_end_[id] - piece_begin_[id]);
+}
+
+void TokenVocabulary::detokenize(const int* ids, size_t count, std::string& out) const {
+    for (size_t i = 0; i < count; ++i) {
+        appendToken(ids[i], out);
+    }
+}
+
+std::string TokenVocabulary::detokenize(const std::vector<int>& ids) const {
+    std::string text;
+    detokenize(ids.data(), ids.size(), text);
+    return text;
+}
+
+// ---------------------------------------------------------------------------
+
+IncrementalDetokenizer::IncrementalDetokenizer(std::shared_ptr<const TokenVocabulary> vocab)
+    : vocab_(std::move(vocab)) {
+}
+
+void IncrementalDetokenizer::setVocabulary(std::shared_ptr<const TokenVocabulary> vocab) {
+    vocab_ = std::move(vocab);
+    reset();
+}
+
+size_t IncrementalDetokenizer::update(const int* tokens, size_t count) {
+    size_t common = 0;
+    size_t limit = std::min(count, tokens_.size());
+    while (common < limit && tokens_[common] == tokens[common]) {
+        ++common;
+    }
+
+    if (common < tokens_.size()) {
+        text_.resize(textBegin(common));
+        tokens_.resize(common);
+        token_end_.resize(common);
+    }
+    for (size_t i = common; i < count; ++i) {
+        push(tokens[i]);
+    }
+    return common;
+}
+
+void IncrementalDetokenizer::push(int token) {
+    if (vocab_) {
+        vocab_->appendToken(token, text_);
+    }
+    tokens_.push_back(token);
+    token_end_.push_back(static_cast<uint32_t>(text_.size()));
+}
+
+void IncrementalDetokenizer::reset() {
+    tokens_.clear();
+    token_end_.clear();
+    text_.clear();
+}
+
+} // namespace onnx_stt
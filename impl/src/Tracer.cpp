@@ -0,0 +1,147 @@
+#include "Tracer.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace onnx_stt {
+
+constexpr size_t Tracer::kDefaultEventsPerThread;
+
+std::atomic<bool> Tracer::enabled_{false};
+thread_local TraceSpan::Context TraceSpan::context_;
+
+Tracer::Tracer()
+    : epoch_(std::chrono::steady_clock::now()),
+      events_per_thread_(kDefaultEventsPerThread),
+      next_stream_id_(1),
+      next_async_id_(1) {
+}
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::enable(size_t events_per_thread) {
+    events_per_thread_.store(std::max<size_t>(events_per_thread, 1), std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::begin(const char* name, uint64_t stream_id, uint64_t chunk) {
+    record('B', name, 0, stream_id, chunk);
+}
+
+void Tracer::end(const char* name, uint64_t stream_id, uint64_t chunk) {
+    record('E', name, 0, stream_id, chunk);
+}
+
+void Tracer::asyncBegin(const char* name, uint64_t id, uint64_t stream_id, uint64_t chunk) {
+    record('b', name, id, stream_id, chunk);
+}
+
+void Tracer::asyncEnd(const char* name, uint64_t id, uint64_t stream_id, uint64_t chunk) {
+    record('e', name, id, stream_id, chunk);
+}
+
+Tracer::ThreadBuffer* Tracer::threadBuffer() {
+    // Only the first event of a thread takes the lock
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer(
+            events_per_thread_.load(std::memory_order_relaxed),
+            static_cast<uint32_t>(buffers_.size() + 1))));
+        buffer = buffers_.back().get();
+    }
+    return buffer;
+}
+
+void Tracer::record(char phase, const char* name, uint64_t id, uint64_t stream_id, uint64_t chunk) {
+    const uint64_t ts_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_).count());
+
+    ThreadBuffer* buffer = threadBuffer();
+    const size_t index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= buffer->capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Event& event = buffer->events[index];
+    event.name = name;
+    event.ts_ns = ts_ns;
+    event.id = id;
+    event.stream_id = stream_id;
+    event.chunk = chunk;
+    event.phase = phase;
+    // Readers see the event only once it is complete
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+std::string Tracer::toChromeTraceJson() const {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (const auto& buffer : buffers_) {
+        json << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+             << buffer->tid << ",\"args\":{\"name\":\"stt-" << buffer->tid << "\"}}";
+        first = false;
+
+        const size_t size = buffer->size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < size; ++i) {
+            const Event& event = buffer->events[i];
+            json << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"stt\",\"ph\":\"" << event.phase
+                 << "\",\"ts\":" << event.ts_ns / 1000.0 << ",\"pid\":1,\"tid\":" << buffer->tid;
+            if (event.phase == 'b' || event.phase == 'e') {
+                json << ",\"id\":\"0x" << std::hex << event.id << std::dec << "\"";
+            }
+            json << ",\"args\":{\"stream\":" << event.stream_id << ",\"chunk\":" << event.chunk << "}}";
+        }
+    }
+    json << "\n]}\n";
+    return json.str();
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << toChromeTraceJson();
+    return static_cast<bool>(file);
+}
+
+size_t Tracer::eventCount() const {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    size_t total = 0;
+    for (const auto& buffer : buffers_) {
+        total += buffer->size.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+uint64_t Tracer::droppedEvents() const {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    uint64_t total = 0;
+    for (const auto& buffer : buffers_) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (const auto& buffer : buffers_) {
+        buffer->size.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace onnx_stt
@@ -65,6 +65,13 @@ ModelInterface::TranscriptionResult ZipformerModel::processChunk(
     return convertFromZipformerResult(zipformer_result, timestamp_ms, latency_ms);
 }
 
+ModelInterface::TranscriptionResult ZipformerModel::finalize(uint64_t timestamp_ms) {
+    if (!zipformer_) {
+        return ModelInterface::finalize(timestamp_ms);
+    }
+    return convertFromZipformerResult(zipformer_->finalize(), timestamp_ms, 0);
+}
+
 void ZipformerModel::reset() {
     if (zipformer_) {
         zipformer_->reset();
@@ -131,6 +138,15 @@ ModelInterface::TranscriptionResult ZipformerModel::convertFromZipformerResult(
     converted_result.confidence = result.confidence;
     converted_result.timestamp_ms = timestamp_ms;
     converted_result.latency_ms = latency_ms;
+    converted_result.stable_text = result.stable_text;
+    converted_result.unstable_text = result.unstable_text;
+    converted_result.stable_offset = result.stable_offset;
+    converted_result.word_offsets = result.word_offsets;
+    converted_result.word_start_ms = result.word_start_ms;
+    converted_result.word_end_ms = result.word_end_ms;
+    converted_result.utterance_ms = result.utterance_ms;
+    converted_result.trailing_blank_ms = result.trailing_blank_ms;
+    converted_result.utterance_tokens = static_cast<uint32_t>(result.tokens.size());
     
     // Copy token probabilities if available
     if (!result.token_probs.empty()) {
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <numeric>
 #include <functional>
@@ -9,10 +10,38 @@
 
 namespace onnx_stt {
 
+namespace {
+
+void setIncremental(ZipformerRNNT::Result& result, PartialResultTracker::Update update) {
+    result.stable_text = std::move(update.stable_text);
+    result.unstable_text = std::move(update.unstable_text);
+    result.stable_offset = update.stable_offset;
+    result.word_offsets = std::move(update.word_offsets);
+    result.word_start_ms = std::move(update.word_start_ms);
+    result.word_end_ms = std::move(update.word_end_ms);
+}
+
+void setAlignment(ZipformerRNNT::Result& result, const ZipformerRNNT::Hypothesis& best,
+                  int frames_decoded, int frame_ms) {
+    int trailing = best.frames.empty() ? frames_decoded : frames_decoded - 1 - best.frames.back();
+    result.utterance_ms = static_cast<uint64_t>(frames_decoded) * frame_ms;
+    result.trailing_blank_ms = static_cast<uint64_t>(std::max(trailing, 0)) * frame_ms;
+    result.token_ms.resize(best.frames.size());
+    result.token_probs.resize(best.token_log_probs.size());
+    for (size_t i = 0; i < best.frames.size(); ++i) {
+        result.token_ms[i] = static_cast<uint32_t>(best.frames[i] * frame_ms);
+        result.token_probs[i] = std::exp(best.token_log_probs[i]);
+    }
+}
+
+} // namespace
+
 ZipformerRNNT::ZipformerRNNT(const Config& config)
     : config_(config)
     , env_(ORT_LOGGING_LEVEL_WARNING, "ZipformerRNNT")
-    , memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {
+    , memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault))
+    , tracker_(nullptr, PartialResultTracker::Config{
+          config.stable_chunks, config.subsampling_factor * config.frame_shift_ms}) {
 }
 
 ZipformerRNNT::~ZipformerRNNT() = default;
@@ -40,6 +69,15 @@ bool ZipformerRNNT::initialize() {
             return false;
         }
         
+        // Load the LM before reset() so hypotheses start in its <s> state
+        if (!config_.lm_path.empty()) {
+            auto lm = NgramLM::load(config_.lm_path);
+            if (!lm) {
+                return false;
+            }
+            lm_cache_.reset(new NgramLMStateCache(lm));
+        }
+        
         // Initialize cache state
         cache_state_.initialize(config_);
         
@@ -69,7 +107,12 @@ ZipformerRNNT::Result ZipformerRNNT::processChunk(const std::vector<float>& feat
         if (!hypotheses_.empty()) {
             const auto& best = hypotheses_[0];
             result.tokens = best.tokens;
-            result.text = tokensToText(best.tokens);
+            setAlignment(result, best, frames_decoded_,
+                         config_.subsampling_factor * config_.frame_shift_ms);
+            // Beam re-ranking usually only appends, so this re-renders
+            // just the changed tail
+            setIncremental(result, tracker_.update(best.tokens, result.token_ms));
+            result.text = tracker_.text();
             result.confidence = std::exp(best.score / best.tokens.size());
             result.is_final = false;
         }
@@ -231,7 +274,7 @@ std::vector<float> ZipformerRNNT::runJoiner(const std::vector<float>& encoder_ou
 
 void ZipformerRNNT::beamSearchStep(const std::vector<float>& encoder_out) {
     // Temporary storage for new hypotheses
-    std::priority_queue<Hypothesis> candidates;
+    std::vector<Hypothesis> candidates;
     
     // The encoder output is [batch, time, 512]
     // For joiner, we need to process each time step
@@ -239,7 +282,8 @@ void ZipformerRNNT::beamSearchStep(const std::vector<float>& encoder_out) {
     size_t encoder_dim = 512;
     size_t num_frames = encoder_out.size() / encoder_dim;
     
-    // Extract last frame
+    // Extract last frame; emitted tokens are stamped with its index
+    const int frame_index = frames_decoded_ + std::max(static_cast<int>(num_frames) - 1, 0);
     std::vector<float> last_encoder_frame(encoder_dim);
     if (num_frames > 0) {
         size_t offset = (num_frames - 1) * encoder_dim;
@@ -269,7 +313,7 @@ void ZipformerRNNT::beamSearchStep(const std::vector<float>& encoder_out) {
         
         // Consider top-k tokens
         std::vector<std::pair<float, int>> token_scores;
-        int vocab_size = std::min(static_cast<int>(tokens_.size()), static_cast<int>(logits.size()));
+        int vocab_size = std::min(vocab_->size(), static_cast<int>(logits.size()));
         for (int i = 0; i < vocab_size; ++i) {
             token_scores.push_back({logits[i], i});
         }
@@ -287,83 +331,50 @@ void ZipformerRNNT::beamSearchStep(const std::vector<float>& encoder_out) {
             int token_id = score_token.second;
             Hypothesis new_hyp = hyp;
             
+            new_hyp.score = hyp.score + score;
             if (token_id != blank_id_) {
                 // Non-blank token: add to sequence
                 new_hyp.tokens.push_back(token_id);
+                new_hyp.frames.push_back(frame_index);
+                new_hyp.token_log_probs.push_back(score);
+                if (lm_cache_) {
+                    new_hyp.score += config_.lm_weight *
+                        lm_cache_->score(hyp.lm_state, token_id, &new_hyp.lm_state);
+                }
             }
             
-            new_hyp.score = hyp.score + score;
             new_hyp.decoder_state = decoder_out;  // Update decoder state
-            
-            candidates.push(new_hyp);
-            if (candidates.size() > static_cast<size_t>(config_.beam_size * 2)) {
-                candidates.pop();  // Keep only top candidates
-            }
+            candidates.push_back(std::move(new_hyp));
         }
     }
     
-    // Select top beam_size hypotheses
-    hypotheses_.clear();
-    while (!candidates.empty() && hypotheses_.size() < static_cast<size_t>(config_.beam_size)) {
-        hypotheses_.push_back(candidates.top());
-        candidates.pop();
-    }
-    
-    // Reverse to have best hypothesis first
-    std::reverse(hypotheses_.begin(), hypotheses_.end());
-}
-
-std::string ZipformerRNNT::tokensToText(const std::vector<int>& tokens) {
-    std::string text;
-    
-    for (int token_id : tokens) {
-        if (token_id >= 0 && token_id < static_cast<int>(tokens_.size())) {
-            const std::string& token = tokens_[token_id];
-            
-            // Handle BPE tokens (e.g., "▁" for word boundaries)
-            if (token.find("▁") == 0) {
-                if (!text.empty()) {
-                    text += " ";
-                }
-                text += token.substr(3);  // Remove "▁"
-            } else {
-                text += token;
-            }
-        }
-    }
+    frames_decoded_ += static_cast<int>(num_frames);
     
-    return text;
+    // Keep the top beam_size hypotheses, best first
+    size_t keep = std::min(candidates.size(), static_cast<size_t>(config_.beam_size));
+    std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(),
+                      [](const Hypothesis& a, const Hypothesis& b) { return a.score > b.score; });
+    candidates.resize(keep);
+    hypotheses_.swap(candidates);
 }
 
 bool ZipformerRNNT::loadTokens(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open tokens file: " << path << std::endl;
+    vocab_ = TokenVocabulary::load(path);
+    if (!vocab_) {
         return false;
     }
-    
-    tokens_.clear();
-    std::string line;
-    
-    while (std::getline(file, line)) {
-        // Format: "token id" or just "token"
-        size_t space_pos = line.find_last_of(' ');
-        if (space_pos != std::string::npos) {
-            tokens_.push_back(line.substr(0, space_pos));
-        } else {
-            tokens_.push_back(line);
-        }
-    }
+    tracker_.setVocabulary(vocab_);
     
     // Find blank token (usually "<blk>" or similar)
-    for (size_t i = 0; i < tokens_.size(); ++i) {
-        if (tokens_[i] == "<blk>" || tokens_[i] == "<blank>") {
-            blank_id_ = i;
-            break;
-        }
+    blank_id_ = vocab_->findId("<blk>");
+    if (blank_id_ < 0) {
+        blank_id_ = vocab_->findId("<blank>");
+    }
+    if (blank_id_ < 0) {
+        blank_id_ = 0;
     }
     
-    std::cout << "Loaded " << tokens_.size() << " tokens, blank_id=" << blank_id_ << std::endl;
+    std::cout << "Loaded " << vocab_->size() << " tokens, blank_id=" << blank_id_ << std::endl;
     return true;
 }
 
@@ -373,7 +384,10 @@ ZipformerRNNT::Result ZipformerRNNT::finalize() {
     if (!hypotheses_.empty()) {
         const auto& best = hypotheses_[0];
         result.tokens = best.tokens;
-        result.text = tokensToText(best.tokens);
+        setAlignment(result, best, frames_decoded_,
+                         config_.subsampling_factor * config_.frame_shift_ms);
+        setIncremental(result, tracker_.update(best.tokens, result.token_ms, true));
+        result.text = tracker_.text();
         result.confidence = std::exp(best.score / best.tokens.size());
         result.is_final = true;
     }
@@ -391,7 +405,10 @@ void ZipformerRNNT::reset() {
     empty_hyp.tokens.clear();
     empty_hyp.score = 0.0f;
     empty_hyp.decoder_state.resize(config_.decoder_dim, 0.0f);
+    empty_hyp.lm_state = lm_cache_ ? lm_cache_->lm().beginState() : NgramLM::nullState();
     hypotheses_.push_back(empty_hyp);
+    frames_decoded_ = 0;
+    tracker_.reset();
 }
 
 } // namespace onnx_stt
\ No newline at end of file
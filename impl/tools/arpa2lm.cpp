@@ -0,0 +1,27 @@
+/**
+ * arpa2lm - convert an ARPA n-gram model to the memory-mapped binary
+ * format loaded by onnx_stt::NgramLM.
+ *
+ * The ARPA words must be the acoustic model's BPE tokens (train the LM on
+ * tokenized text). Usage:
+ *
+ *   arpa2lm model.arpa tokens.txt model.lm.bin
+ */
+
+#include "NgramLM.hpp"
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <model.arpa> <tokens.txt> <output.bin>" << std::endl;
+        return 1;
+    }
+
+    if (!onnx_stt::NgramLM::convertArpa(argv[1], argv[2], argv[3])) {
+        return 1;
+    }
+
+    // Map the result once so a bad file is caught here, not at deploy time
+    auto lm = onnx_stt::NgramLM::load(argv[3]);
+    return lm ? 0 : 1;
+}
@@ -0,0 +1,517 @@
+/**
+ * stt_bench - reproducible throughput and latency benchmark
+ *
+ * Plays the WAV files of a manifest through N concurrent simulated streams,
+ * each with its own model instance, and reports real-time factor, per-chunk
+ * latency percentiles, time to first token, peak RSS and WER against the
+ * reference text. Usage:
+ *
+ *   stt_bench --backend pipeline|ctc|zipformer --model <path> --manifest <file>
+ *             [--streams N] [--realtime] [--chunk-ms MS] [--threads N]
+ *             [--vad] [--json out.json]
+ *
+ * Manifest lines are "<file.wav>[<TAB><reference text>]"; '#' starts a
+ * comment. Files must be 16 kHz, 16-bit mono. Stream i starts at manifest
+ * entry i and plays every entry once.
+ *
+ * Backends:
+ *   pipeline   STTPipeline; --model is a NeMo .onnx file or a Zipformer
+ *              model directory (encoder/decoder/joiner-epoch-99-avg-1.onnx)
+ *   ctc        NeMoCTCModel; whole utterances, decoded once all their audio
+ *              has arrived, so "chunk" latency is per utterance
+ *   zipformer  ZipformerRNNT with KaldifeatExtractor; --model is the
+ *              model directory as above, with tokens.txt
+ *
+ * Chunk latency runs from the chunk's arrival (its real-time schedule with
+ * --realtime, otherwise the call) to the end of its decode. Time to first
+ * token runs from an utterance's first chunk to the first call returning
+ * text.
+ */
+
+#include "STTPipeline.hpp"
+#include "NeMoCTCModel.hpp"
+#include "ZipformerRNNT.hpp"
+#include "KaldifeatExtractor.hpp"
+#include "LatencyHistogram.hpp"
+#include "WordErrorRate.hpp"
+#include <sys/resource.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace onnx_stt;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int kSampleRate = 16000;
+
+struct Options {
+    std::string backend = "pipeline";
+    std::string model;
+    std::string manifest;
+    std::string json_path;
+    int streams = 1;
+    int chunk_ms = 100;
+    int threads = 1;            // ONNX Runtime threads per stream
+    bool realtime = false;
+    bool vad = false;
+};
+
+struct Utterance {
+    std::string path;
+    std::string reference;
+    bool has_reference = false;
+    std::vector<int16_t> samples;
+};
+
+/**
+ * One stream's decoder, fed chunk by chunk
+ */
+class BenchBackend {
+public:
+    virtual ~BenchBackend() = default;
+
+    virtual bool initialize() = 0;
+
+    /** Decode one chunk; @return true if there is text so far */
+    virtual bool feed(const int16_t* samples, size_t num_samples, uint64_t timestamp_ms) = 0;
+
+    /** Finish the utterance, return its transcript and reset for the next */
+    virtual std::string finish() = 0;
+
+    /** False if feed() only buffers and finish() does all the decoding */
+    virtual bool streaming() const { return true; }
+};
+
+class PipelineBackend : public BenchBackend {
+public:
+    explicit PipelineBackend(const Options& options) : options_(options) {}
+
+    bool initialize() override {
+        const std::string& model = options_.model;
+        const bool nemo = model.size() > 5 && model.compare(model.size() - 5, 5, ".onnx") == 0;
+        pipeline_ = nemo ? createNeMoPipeline(model, options_.vad)
+                         : createZipformerPipeline(model, options_.vad);
+        return pipeline_ != nullptr;
+    }
+
+    bool feed(const int16_t* samples, size_t num_samples, uint64_t timestamp_ms) override {
+        auto result = pipeline_->processAudio(samples, num_samples, timestamp_ms);
+        transcript_ += result.stable_text;
+        unstable_ = result.unstable_text;
+        return !transcript_.empty() || !unstable_.empty();
+    }
+
+    std::string finish() override {
+        std::string text = transcript_ + unstable_;
+        transcript_.clear();
+        unstable_.clear();
+        pipeline_->reset();
+        return text;
+    }
+
+private:
+    Options options_;
+    std::unique_ptr<STTPipeline> pipeline_;
+    std::string transcript_;
+    std::string unstable_;
+};
+
+class CTCBackend : public BenchBackend {
+public:
+    explicit CTCBackend(const Options& options) {
+        config_.model_path = options.model;
+        std::string dir = options.model.substr(0, options.model.find_last_of("/\\") + 1);
+        config_.vocab_path = dir + "tokens.txt";
+        config_.num_threads = options.threads;
+        config_.dither = 0.0f;   // reproducible transcripts
+    }
+
+    bool initialize() override {
+        model_ = std::make_unique<NeMoCTCModel>(config_);
+        return model_->initialize();
+    }
+
+    bool feed(const int16_t* samples, size_t num_samples, uint64_t) override {
+        for (size_t i = 0; i < num_samples; ++i) {
+            audio_.push_back(samples[i] / 32768.0f);
+        }
+        return false;
+    }
+
+    std::string finish() override {
+        auto result = model_->processAudio(audio_);
+        audio_.clear();
+        return result.text;
+    }
+
+    bool streaming() const override { return false; }
+
+private:
+    NeMoCTCModel::Config config_;
+    std::unique_ptr<NeMoCTCModel> model_;
+    std::vector<float> audio_;
+};
+
+class ZipformerBackend : public BenchBackend {
+public:
+    explicit ZipformerBackend(const Options& options) {
+        const std::string dir = options.model + "/";
+        config_.encoder_path = dir + "encoder-epoch-99-avg-1.onnx";
+        config_.decoder_path = dir + "decoder-epoch-99-avg-1.onnx";
+        config_.joiner_path = dir + "joiner-epoch-99-avg-1.onnx";
+        config_.tokens_path = dir + "tokens.txt";
+        config_.num_threads = options.threads;
+        feature_config_.sample_rate = kSampleRate;
+    }
+
+    bool initialize() override {
+        features_ = std::make_unique<KaldifeatExtractor>(feature_config_);
+        model_ = std::make_unique<ZipformerRNNT>(config_);
+        return features_->initialize(feature_config_) && model_->initialize();
+    }
+
+    bool feed(const int16_t* samples, size_t num_samples, uint64_t) override {
+        for (const auto& frame : features_->computeFeatures(samples, num_samples)) {
+            pending_.insert(pending_.end(), frame.begin(), frame.end());
+        }
+        // The encoder takes fixed chunks of frames
+        const size_t chunk = static_cast<size_t>(config_.chunk_size * config_.feature_dim);
+        size_t offset = 0;
+        while (pending_.size() - offset >= chunk) {
+            chunk_features_.assign(pending_.begin() + offset, pending_.begin() + offset + chunk);
+            text_ = model_->processChunk(chunk_features_).text;
+            offset += chunk;
+        }
+        pending_.erase(pending_.begin(), pending_.begin() + offset);
+        return !text_.empty();
+    }
+
+    std::string finish() override {
+        std::string text = model_->finalize().text;
+        model_->reset();
+        pending_.clear();
+        text_.clear();
+        return text;
+    }
+
+private:
+    ZipformerRNNT::Config config_;
+    FeatureExtractor::Config feature_config_;
+    std::unique_ptr<KaldifeatExtractor> features_;
+    std::unique_ptr<ZipformerRNNT> model_;
+    std::vector<float> pending_;
+    std::vector<float> chunk_features_;
+    std::string text_;
+};
+
+std::unique_ptr<BenchBackend> createBackend(const Options& options) {
+    if (options.backend == "pipeline") {
+        return std::unique_ptr<BenchBackend>(new PipelineBackend(options));
+    }
+    if (options.backend == "ctc") {
+        return std::unique_ptr<BenchBackend>(new CTCBackend(options));
+    }
+    if (options.backend == "zipformer") {
+        return std::unique_ptr<BenchBackend>(new ZipformerBackend(options));
+    }
+    return nullptr;
+}
+
+// 16 kHz 16-bit mono WAV; walks the chunks to find "data"
+bool readWav(const std::string& path, std::vector<int16_t>& samples) {
+    std::ifstream file(path, std::ios::binary);
+    char riff[12];
+    if (!file.read(riff, 12) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        std::cerr << "Not a WAV file: " << path << std::endl;
+        return false;
+    }
+
+    char id[4];
+    uint32_t size = 0;
+    bool format_ok = false;
+    while (file.read(id, 4) && file.read(reinterpret_cast<char*>(&size), 4)) {
+        if (std::memcmp(id, "fmt ", 4) == 0) {
+            std::vector<char> fmt(size);
+            file.read(fmt.data(), size);
+            uint16_t channels = 0;
+            uint16_t bits = 0;
+            uint32_t rate = 0;
+            std::memcpy(&channels, fmt.data() + 2, 2);
+            std::memcpy(&rate, fmt.data() + 4, 4);
+            std::memcpy(&bits, fmt.data() + 14, 2);
+            format_ok = channels == 1 && bits == 16 && rate == static_cast<uint32_t>(kSampleRate);
+        } else if (std::memcmp(id, "data", 4) == 0) {
+            if (!format_ok) {
+                break;
+            }
+            samples.resize(size / 2);
+            file.read(reinterpret_cast<char*>(samples.data()), samples.size() * 2);
+            return true;
+        } else {
+            file.seekg(size + (size & 1), std::ios::cur);
+        }
+    }
+    std::cerr << "Expected 16 kHz 16-bit mono PCM: " << path << std::endl;
+    return false;
+}
+
+bool readManifest(const std::string& path, std::vector<Utterance>& utterances) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open manifest: " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        Utterance utterance;
+        const size_t tab = line.find('\t');
+        utterance.path = line.substr(0, tab);
+        if (tab != std::string::npos) {
+            utterance.reference = line.substr(tab + 1);
+            utterance.has_reference = true;
+        }
+        if (!readWav(utterance.path, utterance.samples)) {
+            return false;
+        }
+        utterances.push_back(std::move(utterance));
+    }
+    return !utterances.empty();
+}
+
+uint64_t elapsedUs(Clock::time_point from, Clock::time_point to) {
+    return to > from ? static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(to - from).count()) : 0;
+}
+
+struct Totals {
+    LatencyHistogram chunk_latency;
+    LatencyHistogram first_token;
+    std::atomic<uint64_t> busy_us{0};         // time spent in decode calls
+    std::atomic<uint64_t> audio_samples{0};
+    std::atomic<uint64_t> chunks{0};
+    std::mutex wer_mutex;
+    size_t word_errors = 0;
+    size_t reference_words = 0;
+    std::atomic<int> failed_streams{0};
+};
+
+void runStream(const Options& options, const std::vector<Utterance>& utterances,
+               int index, Totals& totals) {
+    auto backend = createBackend(options);
+    if (!backend || !backend->initialize()) {
+        std::cerr << "Stream " << index << ": backend initialization failed" << std::endl;
+        totals.failed_streams++;
+        return;
+    }
+
+    const size_t chunk_samples = static_cast<size_t>(options.chunk_ms) * kSampleRate / 1000;
+    for (size_t n = 0; n < utterances.size(); ++n) {
+        const Utterance& utterance = utterances[(index + n) % utterances.size()];
+        const size_t total = utterance.samples.size();
+
+        const auto start = Clock::now();
+        bool have_text = false;
+        for (size_t offset = 0; offset < total; offset += chunk_samples) {
+            const size_t count = std::min(chunk_samples, total - offset);
+
+            // A chunk arrives once its last sample would have been captured
+            auto arrival = Clock::now();
+            if (options.realtime) {
+                arrival = start + std::chrono::microseconds((offset + count) * 1000000 / kSampleRate);
+                std::this_thread::sleep_until(arrival);
+            }
+
+            const auto call = Clock::now();
+            const bool text = backend->feed(utterance.samples.data() + offset, count,
+                                            offset * 1000 / kSampleRate);
+            const auto done = Clock::now();
+            totals.busy_us += elapsedUs(call, done);
+
+            if (backend->streaming()) {
+                totals.chunk_latency.record(elapsedUs(arrival, done));
+                totals.chunks++;
+            }
+            if (text && !have_text) {
+                totals.first_token.record(elapsedUs(start, done));
+                have_text = true;
+            }
+        }
+
+        const auto call = Clock::now();
+        const std::string transcript = backend->finish();
+        const auto done = Clock::now();
+        totals.busy_us += elapsedUs(call, done);
+        if (!backend->streaming()) {
+            totals.chunk_latency.record(elapsedUs(call, done));
+            totals.chunks++;
+        }
+        if (!have_text && !transcript.empty()) {
+            totals.first_token.record(elapsedUs(start, done));
+        }
+        totals.audio_samples += total;
+
+        if (utterance.has_reference) {
+            const auto reference = normalizeWords(utterance.reference);
+            const size_t errors = editDistance(reference, normalizeWords(transcript));
+            std::lock_guard<std::mutex> lock(totals.wer_mutex);
+            totals.word_errors += errors;
+            totals.reference_words += reference.size();
+        }
+    }
+}
+
+double peakRssMb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;   // kilobytes on Linux
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " --backend pipeline|ctc|zipformer --model <path>"
+              << " --manifest <file>\n"
+              << "       [--streams N] [--realtime] [--chunk-ms MS] [--threads N] [--vad]"
+              << " [--json out.json]" << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--backend" && has_value) {
+            options.backend = argv[++i];
+        } else if (arg == "--model" && has_value) {
+            options.model = argv[++i];
+        } else if (arg == "--manifest" && has_value) {
+            options.manifest = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            options.json_path = argv[++i];
+        } else if (arg == "--streams" && has_value) {
+            options.streams = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--chunk-ms" && has_value) {
+            options.chunk_ms = std::max(10, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && has_value) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--realtime") {
+            options.realtime = true;
+        } else if (arg == "--vad") {
+            options.vad = true;
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    return !options.model.empty() && !options.manifest.empty() &&
+           (options.backend == "pipeline" || options.backend == "ctc" || options.backend == "zipformer");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Utterance> utterances;
+    if (!readManifest(options.manifest, utterances)) {
+        return 1;
+    }
+
+    Totals totals;
+    const auto start = Clock::now();
+    std::vector<std::thread> streams;
+    for (int i = 0; i < options.streams; ++i) {
+        streams.emplace_back(runStream, std::cref(options), std::cref(utterances), i, std::ref(totals));
+    }
+    for (auto& stream : streams) {
+        stream.join();
+    }
+    const double wall_s = elapsedUs(start, Clock::now()) / 1e6;
+
+    if (totals.failed_streams > 0) {
+        return 1;
+    }
+
+    const double audio_s = static_cast<double>(totals.audio_samples) / kSampleRate;
+    const double busy_s = totals.busy_us / 1e6;
+    const double rtf = audio_s > 0 ? busy_s / audio_s : 0.0;
+    const double wer = totals.reference_words > 0
+        ? static_cast<double>(totals.word_errors) / totals.reference_words : -1.0;
+    const auto chunk = totals.chunk_latency.snapshot();
+    const auto first = totals.first_token.snapshot();
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4)
+         << "{\"backend\":\"" << options.backend << "\""
+         << ",\"streams\":" << options.streams
+         << ",\"realtime\":" << (options.realtime ? "true" : "false")
+         << ",\"chunk_ms\":" << options.chunk_ms
+         << ",\"threads\":" << options.threads
+         << ",\"utterances\":" << utterances.size()
+         << ",\"audio_s\":" << audio_s
+         << ",\"wall_s\":" << wall_s
+         << ",\"rtf\":" << rtf
+         << ",\"speed_x_realtime\":" << (wall_s > 0 ? audio_s / wall_s : 0.0)
+         << ",\"chunks\":" << chunk.count
+         << ",\"chunk_latency_ms\":{\"mean\":" << chunk.meanUs() / 1000.0
+         << ",\"p50\":" << chunk.percentileUs(0.50) / 1000.0
+         << ",\"p90\":" << chunk.percentileUs(0.90) / 1000.0
+         << ",\"p99\":" << chunk.percentileUs(0.99) / 1000.0
+         << ",\"max\":" << chunk.max_us / 1000.0 << "}"
+         << ",\"first_token_ms\":{\"p50\":" << first.percentileUs(0.50) / 1000.0
+         << ",\"p90\":" << first.percentileUs(0.90) / 1000.0
+         << ",\"p99\":" << first.percentileUs(0.99) / 1000.0 << "}"
+         << ",\"peak_rss_mb\":" << peakRssMb()
+         << ",\"reference_words\":" << totals.reference_words
+         << ",\"word_errors\":" << totals.word_errors
+         << ",\"wer\":" << wer << "}";
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "\n=== stt_bench: " << options.backend << ", " << options.streams << " stream(s), "
+              << (options.realtime ? "real-time" : "max speed") << " ===\n"
+              << "Audio:          " << audio_s << " s in " << wall_s << " s ("
+              << (wall_s > 0 ? audio_s / wall_s : 0.0) << "x real time)\n"
+              << "RTF:            " << std::setprecision(4) << rtf << std::setprecision(2)
+              << " (decode time / audio)\n"
+              << "Chunk latency:  p50 " << chunk.percentileUs(0.50) / 1000.0
+              << " ms, p90 " << chunk.percentileUs(0.90) / 1000.0
+              << " ms, p99 " << chunk.percentileUs(0.99) / 1000.0
+              << " ms (" << chunk.count << (options.backend == "ctc" ? " utterances)\n" : " chunks)\n")
+              << "First token:    p50 " << first.percentileUs(0.50) / 1000.0
+              << " ms, p99 " << first.percentileUs(0.99) / 1000.0 << " ms\n"
+              << "Peak RSS:       " << peakRssMb() << " MB\n";
+    if (wer >= 0) {
+        std::cout << "WER:            " << wer * 100.0 << "% (" << totals.word_errors << "/"
+                  << totals.reference_words << ")\n";
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        out << json.str() << "\n";
+        if (!out) {
+            std::cerr << "Cannot write " << options.json_path << std::endl;
+            return 1;
+        }
+    } else {
+        std::cout << json.str() << std::endl;
+    }
+    return 0;
+}
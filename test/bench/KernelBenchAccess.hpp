@@ -0,0 +1,40 @@
+/**
+ * Access to private kernels for the microbenchmarks
+ *
+ * FbankComputer, NeMoCTCModel and ZipformerRNNT befriend this struct so
+ * the benchmarks can time their inner kernels on fixed inputs without
+ * widening the public interfaces.
+ */
+
+#ifndef KERNEL_BENCH_ACCESS_HPP
+#define KERNEL_BENCH_ACCESS_HPP
+
+#include "ImprovedFbank.hpp"
+#include "NeMoCTCModel.hpp"
+#include "ZipformerRNNT.hpp"
+#include <vector>
+
+struct KernelBenchAccess {
+    static std::vector<float> computeFFT(improved_fbank::FbankComputer& fbank,
+                                         const std::vector<float>& frame) {
+        return fbank.computeFFT(frame);
+    }
+
+    static std::vector<float> applyMelFilterbank(improved_fbank::FbankComputer& fbank,
+                                                 const std::vector<float>& power_spectrum) {
+        return fbank.applyMelFilterbank(power_spectrum);
+    }
+
+    static void greedyCTCDecode(onnx_stt::NeMoCTCModel& model,
+                                const std::vector<std::vector<float>>& log_probs,
+                                std::vector<int>& tokens, std::vector<int>& frames,
+                                std::vector<float>& peak_log_probs) {
+        model.greedyCTCDecode(log_probs, tokens, frames, peak_log_probs);
+    }
+
+    static void beamSearchStep(onnx_stt::ZipformerRNNT& model, const std::vector<float>& encoder_out) {
+        model.beamSearchStep(encoder_out);
+    }
+};
+
+#endif // KERNEL_BENCH_ACCESS_HPP
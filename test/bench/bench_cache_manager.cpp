@@ -0,0 +1,39 @@
+/**
+ * CacheManager: building the per-chunk cache input tensors for the
+ * Zipformer and Conformer layouts
+ */
+
+#include "CacheManager.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using onnx_stt::CacheManager;
+
+void runGetInputCaches(benchmark::State& state, const CacheManager::CacheConfig& config) {
+    CacheManager caches(config);
+    if (!caches.initialize()) {
+        state.SkipWithError("cache initialization failed");
+        return;
+    }
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    size_t tensors = 0;
+    for (auto _ : state) {
+        auto inputs = caches.getInputCaches(memory_info);
+        tensors = inputs.size();
+        benchmark::DoNotOptimize(inputs.data());
+    }
+    state.counters["tensors"] = static_cast<double>(tensors);
+}
+
+void BM_CacheManagerZipformer(benchmark::State& state) {
+    runGetInputCaches(state, CacheManager::createZipformerConfig());
+}
+BENCHMARK(BM_CacheManagerZipformer);
+
+void BM_CacheManagerConformer(benchmark::State& state) {
+    runGetInputCaches(state, CacheManager::createConformerConfig());
+}
+BENCHMARK(BM_CacheManagerConformer);
+
+} // namespace
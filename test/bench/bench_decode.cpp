@@ -0,0 +1,112 @@
+/**
+ * Decoder kernels: NeMo greedy CTC over a synthetic log-prob matrix and
+ * one Zipformer RNN-T beam search step
+ *
+ * The beam search step runs the decoder and joiner networks, so it needs
+ * the model files: set STT_BENCH_ZIPFORMER_DIR to the Zipformer model
+ * directory, otherwise the benchmark is reported as skipped.
+ */
+
+#include "KernelBenchAccess.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using onnx_stt::NeMoCTCModel;
+using onnx_stt::ZipformerRNNT;
+
+const int kVocabSize = 1025;   // 1024 BPE tokens + blank
+
+// Only the config is used by the decoder; the ONNX session stays unloaded
+NeMoCTCModel& ctcModel() {
+    static NeMoCTCModel model([] {
+        NeMoCTCModel::Config config;
+        config.blank_id = kVocabSize - 1;
+        return config;
+    }());
+    return model;
+}
+
+// Peaky CTC posteriors like a real model: mostly blank, a token every ~4 frames
+std::vector<std::vector<float>> syntheticLogProbs(size_t num_frames) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> token(0, kVocabSize - 2);
+    std::uniform_real_distribution<float> noise(-12.0f, -8.0f);
+    std::vector<std::vector<float>> log_probs(num_frames, std::vector<float>(kVocabSize));
+    for (size_t t = 0; t < num_frames; ++t) {
+        for (auto& value : log_probs[t]) {
+            value = noise(gen);
+        }
+        const int peak = (t % 4 == 0) ? token(gen) : kVocabSize - 1;
+        log_probs[t][peak] = -0.05f;
+    }
+    return log_probs;
+}
+
+// range(0) encoder frames (80 ms each after 8x subsampling)
+void BM_GreedyCTCDecode(benchmark::State& state) {
+    NeMoCTCModel& model = ctcModel();
+    const auto log_probs = syntheticLogProbs(static_cast<size_t>(state.range(0)));
+    std::vector<int> tokens, frames;
+    std::vector<float> peak_log_probs;
+    for (auto _ : state) {
+        tokens.clear();
+        frames.clear();
+        peak_log_probs.clear();
+        KernelBenchAccess::greedyCTCDecode(model, log_probs, tokens, frames, peak_log_probs);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GreedyCTCDecode)->Arg(13)->Arg(125)->Unit(benchmark::kMicrosecond);
+
+ZipformerRNNT* zipformerModel() {
+    static std::unique_ptr<ZipformerRNNT> model = [] {
+        std::unique_ptr<ZipformerRNNT> loaded;
+        const char* dir = std::getenv("STT_BENCH_ZIPFORMER_DIR");
+        if (!dir) {
+            return loaded;
+        }
+        const std::string base = std::string(dir) + "/";
+        ZipformerRNNT::Config config;
+        config.encoder_path = base + "encoder-epoch-99-avg-1.onnx";
+        config.decoder_path = base + "decoder-epoch-99-avg-1.onnx";
+        config.joiner_path = base + "joiner-epoch-99-avg-1.onnx";
+        config.tokens_path = base + "tokens.txt";
+        config.num_threads = 1;
+        loaded.reset(new ZipformerRNNT(config));
+        if (!loaded->initialize()) {
+            loaded.reset();
+        }
+        return loaded;
+    }();
+    return model.get();
+}
+
+void BM_ZipformerBeamSearchStep(benchmark::State& state) {
+    ZipformerRNNT* model = zipformerModel();
+    if (!model) {
+        state.SkipWithError("STT_BENCH_ZIPFORMER_DIR not set or models failed to load");
+        return;
+    }
+    std::mt19937 gen(11);
+    std::normal_distribution<float> activation(0.0f, 1.0f);
+    std::vector<float> encoder_out(8 * 512);   // one chunk of encoder frames
+    for (auto& value : encoder_out) {
+        value = activation(gen);
+    }
+    model->reset();
+    for (auto _ : state) {
+        KernelBenchAccess::beamSearchStep(*model, encoder_out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ZipformerBeamSearchStep)->Unit(benchmark::kMicrosecond);
+
+} // namespace
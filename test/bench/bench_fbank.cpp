@@ -0,0 +1,73 @@
+/**
+ * FbankComputer kernels: FFT power spectrum, mel filterbank and the whole
+ * feature computation, on a fixed synthetic 25 ms frame / 1 s signal
+ */
+
+#include "KernelBenchAccess.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+using improved_fbank::FbankComputer;
+
+// Built once: the constructor logs its configuration
+FbankComputer& sharedFbank() {
+    static FbankComputer fbank([] {
+        FbankComputer::Options options;
+        options.dither = 0.0f;   // no random_device in the timed path
+        return options;
+    }());
+    return fbank;
+}
+
+// A 440 Hz tone in fixed-seed noise, so every run sees the same input
+std::vector<float> syntheticAudio(size_t num_samples) {
+    std::mt19937 gen(42);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::vector<float> audio(num_samples);
+    for (size_t i = 0; i < num_samples; ++i) {
+        audio[i] = 0.3f * std::sin(2.0f * 3.14159265f * 440.0f * i / 16000.0f) + noise(gen);
+    }
+    return audio;
+}
+
+void BM_FbankComputeFFT(benchmark::State& state) {
+    FbankComputer& fbank = sharedFbank();
+    const auto frame = syntheticAudio(400);   // 25 ms at 16 kHz
+    for (auto _ : state) {
+        auto spectrum = KernelBenchAccess::computeFFT(fbank, frame);
+        benchmark::DoNotOptimize(spectrum.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FbankComputeFFT);
+
+void BM_FbankApplyMelFilterbank(benchmark::State& state) {
+    FbankComputer& fbank = sharedFbank();
+    const auto spectrum = KernelBenchAccess::computeFFT(fbank, syntheticAudio(400));
+    for (auto _ : state) {
+        auto mel = KernelBenchAccess::applyMelFilterbank(fbank, spectrum);
+        benchmark::DoNotOptimize(mel.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FbankApplyMelFilterbank);
+
+// Whole extraction; items are 10 ms frames
+void BM_FbankComputeFeatures(benchmark::State& state) {
+    FbankComputer& fbank = sharedFbank();
+    const auto audio = syntheticAudio(static_cast<size_t>(state.range(0)) * 16);
+    size_t frames = 0;
+    for (auto _ : state) {
+        auto features = fbank.computeFeatures(audio);
+        frames = features.size();
+        benchmark::DoNotOptimize(features.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(frames));
+}
+BENCHMARK(BM_FbankComputeFeatures)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,77 @@
+/**
+ * StereoAudioSplitter decoders writing into caller buffers: PCM16, PCM8
+ * and G.711 µ-law/A-law deinterleave of range(0) stereo frames
+ */
+
+#include "StereoAudioSplitter.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using com::teracloud::streamsx::stt::StereoAudioSplitter;
+
+// Fixed byte pattern covering all code values
+std::vector<uint8_t> syntheticBytes(size_t num_bytes) {
+    std::vector<uint8_t> bytes(num_bytes);
+    for (size_t i = 0; i < num_bytes; ++i) {
+        bytes[i] = static_cast<uint8_t>((i * 37 + 11) & 0xff);
+    }
+    return bytes;
+}
+
+void BM_SplitPCM16(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    const auto bytes = syntheticBytes(frames * 2 * sizeof(int16_t));
+    const int16_t* samples = reinterpret_cast<const int16_t*>(bytes.data());
+    std::vector<float> left(frames), right(frames);
+    for (auto _ : state) {
+        StereoAudioSplitter::splitInterleavedPCM16(samples, frames * 2, left.data(), right.data());
+        benchmark::DoNotOptimize(left.data());
+        benchmark::DoNotOptimize(right.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(frames));
+}
+BENCHMARK(BM_SplitPCM16)->Arg(160)->Arg(8000);
+
+void BM_SplitPCM8(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    const auto bytes = syntheticBytes(frames * 2);
+    std::vector<float> left(frames), right(frames);
+    for (auto _ : state) {
+        StereoAudioSplitter::splitInterleavedPCM8(bytes.data(), frames * 2, left.data(), right.data());
+        benchmark::DoNotOptimize(left.data());
+        benchmark::DoNotOptimize(right.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(frames));
+}
+BENCHMARK(BM_SplitPCM8)->Arg(160)->Arg(8000);
+
+void BM_SplitG711uLaw(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    const auto bytes = syntheticBytes(frames * 2);
+    std::vector<float> left(frames), right(frames);
+    for (auto _ : state) {
+        StereoAudioSplitter::splitG711uLaw(bytes.data(), bytes.size(), left.data(), right.data());
+        benchmark::DoNotOptimize(left.data());
+        benchmark::DoNotOptimize(right.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(frames));
+}
+BENCHMARK(BM_SplitG711uLaw)->Arg(160)->Arg(8000);
+
+void BM_SplitG711aLaw(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    const auto bytes = syntheticBytes(frames * 2);
+    std::vector<float> left(frames), right(frames);
+    for (auto _ : state) {
+        StereoAudioSplitter::splitG711aLaw(bytes.data(), bytes.size(), left.data(), right.data());
+        benchmark::DoNotOptimize(left.data());
+        benchmark::DoNotOptimize(right.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(frames));
+}
+BENCHMARK(BM_SplitG711aLaw)->Arg(160)->Arg(8000);
+
+} // namespace
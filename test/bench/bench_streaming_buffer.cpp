@@ -0,0 +1,80 @@
+/**
+ * StreamingBuffer: appends (float and int16) and chunk extraction with
+ * overlap, at the chunk sizes OnnxSTT uses
+ */
+
+#include "StreamingBuffer.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using onnx_stt::StreamingBuffer;
+
+const size_t kCapacity = 16000 * 4;
+
+// Append range(0) samples per call; consume as much so the ring never fills
+void BM_StreamingBufferAppend(benchmark::State& state) {
+    const size_t block = static_cast<size_t>(state.range(0));
+    StreamingBuffer buffer(kCapacity, 1600, 0);
+    const std::vector<float> samples(block, 0.25f);
+    for (auto _ : state) {
+        buffer.append(samples.data(), block);
+        buffer.consume(block);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(block));
+}
+BENCHMARK(BM_StreamingBufferAppend)->Arg(160)->Arg(1600)->Arg(8000);
+
+void BM_StreamingBufferAppendInt16(benchmark::State& state) {
+    const size_t block = static_cast<size_t>(state.range(0));
+    StreamingBuffer buffer(kCapacity, 1600, 0);
+    std::vector<int16_t> samples(block);
+    for (size_t i = 0; i < block; ++i) {
+        samples[i] = static_cast<int16_t>((i * 7919) & 0x7fff);
+    }
+    for (auto _ : state) {
+        buffer.appendInt16(samples.data(), block);
+        buffer.consume(block);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(block));
+}
+BENCHMARK(BM_StreamingBufferAppendInt16)->Arg(160)->Arg(1600)->Arg(8000);
+
+// 100 ms appends, 100 ms chunks with 25 ms overlap: the OnnxSTT streaming path
+void BM_StreamingBufferNextChunk(benchmark::State& state) {
+    const size_t chunk = 1600;
+    StreamingBuffer buffer(kCapacity, chunk, chunk / 4);
+    const std::vector<float> samples(chunk, 0.25f);
+    int64_t chunks = 0;
+    for (auto _ : state) {
+        buffer.append(samples.data(), samples.size());
+        while (const float* view = buffer.nextChunk()) {
+            benchmark::DoNotOptimize(view);
+            ++chunks;
+        }
+    }
+    state.SetItemsProcessed(chunks);
+}
+BENCHMARK(BM_StreamingBufferNextChunk);
+
+// The copying interface, for comparison with the view above
+void BM_StreamingBufferGetNextChunk(benchmark::State& state) {
+    const size_t chunk = 1600;
+    StreamingBuffer buffer(kCapacity, chunk, chunk / 4);
+    const std::vector<float> samples(chunk, 0.25f);
+    std::vector<float> out;
+    int64_t chunks = 0;
+    for (auto _ : state) {
+        buffer.append(samples.data(), samples.size());
+        while (buffer.getNextChunk(out)) {
+            benchmark::DoNotOptimize(out.data());
+            ++chunks;
+        }
+    }
+    state.SetItemsProcessed(chunks);
+}
+BENCHMARK(BM_StreamingBufferGetNextChunk);
+
+} // namespace
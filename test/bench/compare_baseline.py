@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+Compare a Google Benchmark JSON run against the stored baseline
+
+Benchmarks are matched by name; when the run used repetitions only the
+median aggregates are compared. Exits with status 1 if any benchmark's
+CPU time grew by more than --threshold (a ratio, default 1.20).
+Benchmarks that are skipped or missing from the baseline are reported
+but never fail the check, and so is a run made with a Google Benchmark
+library of another build type than the baseline's.
+"""
+import argparse
+import json
+import sys
+
+
+def build_type(path):
+    """Google Benchmark's own build type ("release" or "debug") from a results file"""
+    with open(path) as f:
+        return json.load(f).get('context', {}).get('library_build_type', 'unknown')
+
+
+def load_times(path):
+    """Return {name: cpu_time in ns} for the medians (or plain runs) in a results file"""
+    with open(path) as f:
+        results = json.load(f)
+
+    scale = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+    medians, plain = {}, {}
+    for bench in results.get('benchmarks', []):
+        if bench.get('error_occurred'):
+            continue
+        cpu_ns = bench['cpu_time'] * scale[bench.get('time_unit', 'ns')]
+        if bench.get('run_type') == 'aggregate':
+            if bench.get('aggregate_name') == 'median':
+                medians[bench['run_name']] = cpu_ns
+        else:
+            plain[bench.get('run_name', bench['name'])] = cpu_ns
+    return medians or plain
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('baseline', help='baseline results (JSON)')
+    parser.add_argument('current', help='new results (JSON)')
+    parser.add_argument('--threshold', type=float, default=1.20,
+                        help='fail when current/baseline CPU time exceeds this ratio')
+    args = parser.parse_args()
+
+    baseline = load_times(args.baseline)
+    current = load_times(args.current)
+
+    baseline_build, current_build = build_type(args.baseline), build_type(args.current)
+    if baseline_build != current_build:
+        print(f"note: baseline used a {baseline_build} benchmark library, this run a {current_build} one")
+
+    regressions = 0
+    print(f"{'benchmark':<44} {'baseline':>12} {'current':>12} {'ratio':>7}")
+    for name in sorted(current):
+        if name not in baseline:
+            print(f"{name:<44} {'-':>12} {current[name]:>10.1f}ns {'new':>7}")
+            continue
+        ratio = current[name] / baseline[name]
+        flag = ''
+        if ratio > args.threshold:
+            flag = '  REGRESSION'
+            regressions += 1
+        print(f"{name:<44} {baseline[name]:>10.1f}ns {current[name]:>10.1f}ns {ratio:>7.2f}{flag}")
+    for name in sorted(set(baseline) - set(current)):
+        print(f"{name:<44} {baseline[name]:>10.1f}ns {'skipped':>12}")
+
+    if regressions:
+        print(f"{regressions} benchmark(s) slower than {args.threshold:.2f}x baseline")
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,239 @@
+/**
+ * BatchedSileroVAD parity test
+ *
+ * Runs the same audio through one SileroVAD per stream and through a
+ * single BatchedSileroVAD holding every stream, and checks that each
+ * window gets the same probability and decision from both. The batched
+ * side is fed the way a server would: uneven int16 and float pushes,
+ * interleaved across streams, batches capped below the stream count, and
+ * one stream reset half way through.
+ *
+ * Needs ONNX Runtime and the Silero VAD model. SileroVAD always loads
+ * ../models/silero_vad.onnx relative to the working directory, so run the
+ * test from a directory next to models/ (impl/bin/download_silero_vad.sh
+ * fetches it). Build:
+ *   g++ -std=c++14 -O2 -I../impl/include -I../lib/onnxruntime/include \
+ *       test_batched_vad.cpp ../impl/lib/libs2t_impl.so \
+ *       -L../lib/onnxruntime/lib -lonnxruntime -ldl \
+ *       -Wl,-rpath,'$ORIGIN/../impl/lib' -Wl,-rpath,'$ORIGIN/../lib/onnxruntime/lib' \
+ *       -o test_batched_vad
+ *
+ * Expected: "All batched VAD checks passed" with the window and batch
+ * counts.
+ */
+
+#include "SileroVAD.hpp"
+#include "BatchedSileroVAD.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace onnx_stt;
+
+namespace {
+
+const int kSampleRate = 16000;
+const size_t kNumStreams = 7;
+const size_t kMaxBatch = 3;           // below kNumStreams: exercises the round-robin cap
+const size_t kResetStream = 2;
+const float kTolerance = 1e-4f;
+
+bool g_ok = true;
+
+void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        g_ok = false;
+    }
+}
+
+// Speech-like bursts (voiced harmonics plus noise) between silences; each
+// stream gets its own seed, pitch and length
+std::vector<int16_t> syntheticAudio(size_t stream) {
+    std::mt19937 gen(static_cast<unsigned>(100 + stream));
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    const size_t num_samples = kSampleRate * (3 + stream % 3) + 37 * stream;
+    const float pitch = 110.0f + 25.0f * stream;
+
+    std::vector<int16_t> audio(num_samples);
+    for (size_t i = 0; i < num_samples; ++i) {
+        const float t = static_cast<float>(i) / kSampleRate;
+        const bool voiced = std::fmod(t + 0.13f * stream, 1.2f) < 0.7f;
+        float value = 30.0f * noise(gen);
+        if (voiced) {
+            for (int harmonic = 1; harmonic <= 4; ++harmonic) {
+                value += 3000.0f / harmonic * std::sin(2.0f * 3.14159265f * pitch * harmonic * t);
+            }
+            value += 400.0f * noise(gen);
+        }
+        audio[i] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, value)));
+    }
+    return audio;
+}
+
+// Reference: feed one frame shift at a time so every window yields a result
+std::vector<float> referenceProbabilities(SileroVAD& vad, const int16_t* samples, size_t num_samples,
+                                          size_t shift) {
+    std::vector<float> probs;
+    for (size_t offset = 0; offset < num_samples; offset += shift) {
+        const uint64_t before = vad.windowsProcessed();
+        const size_t count = std::min(shift, num_samples - offset);
+        VADInterface::VADResult result = vad.processChunk(samples + offset, count, 0);
+        const uint64_t windows = vad.windowsProcessed() - before;
+        expect(windows <= 1, "reference produces at most one window per shift");
+        if (windows == 1) {
+            probs.push_back(result.confidence);
+        }
+    }
+    return probs;
+}
+
+void compare(const std::string& label, const std::vector<float>& expected,
+             const std::vector<BatchedSileroVAD::VADResult>& actual, float threshold,
+             uint64_t base_ms, uint64_t shift_ms) {
+    expect(actual.size() == expected.size(),
+           label + ": " + std::to_string(actual.size()) + " windows, reference " +
+           std::to_string(expected.size()));
+    float max_diff = 0.0f;
+    size_t decision_mismatches = 0;
+    bool timestamps_ok = true;
+    for (size_t i = 0; i < std::min(actual.size(), expected.size()); ++i) {
+        max_diff = std::max(max_diff, std::fabs(actual[i].confidence - expected[i]));
+        if (actual[i].is_speech != (expected[i] > threshold)) {
+            decision_mismatches++;
+        }
+        timestamps_ok = timestamps_ok && actual[i].timestamp_ms == base_ms + i * shift_ms;
+    }
+    expect(max_diff <= kTolerance, label + ": probability differs by " + std::to_string(max_diff));
+    expect(decision_mismatches == 0, label + ": " + std::to_string(decision_mismatches) +
+                                     " speech decisions differ");
+    expect(timestamps_ok, label + ": window timestamps are not one frame shift apart");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Batched Silero VAD Parity Test ===" << std::endl;
+
+    VADInterface::Config vad_config;
+    vad_config.sample_rate = kSampleRate;
+    const size_t shift = vad_config.frame_shift_ms * kSampleRate / 1000;
+
+    BatchedSileroVAD::Config batched_config;
+    batched_config.vad = vad_config;
+    batched_config.max_batch_size = kMaxBatch;
+    BatchedSileroVAD batched(batched_config);
+    if (!batched.initialize()) {
+        std::cerr << "Silero VAD model not found at " << batched_config.model_path << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<int16_t>> audio(kNumStreams);
+    std::vector<std::unique_ptr<SileroVAD>> reference(kNumStreams);
+    std::vector<BatchedSileroVAD::StreamId> ids(kNumStreams);
+    std::vector<std::vector<float>> expected(kNumStreams);
+    for (size_t s = 0; s < kNumStreams; ++s) {
+        audio[s] = syntheticAudio(s);
+        reference[s].reset(new SileroVAD(vad_config));
+        if (!reference[s]->initialize(vad_config)) {
+            return 1;
+        }
+        ids[s] = batched.addStream();
+    }
+
+    // The reset stream restarts from its second half on both sides
+    const size_t reset_at = audio[kResetStream].size() / 2;
+    std::vector<float> expected_before_reset;
+    for (size_t s = 0; s < kNumStreams; ++s) {
+        const int16_t* samples = audio[s].data();
+        size_t num_samples = audio[s].size();
+        if (s == kResetStream) {
+            expected_before_reset = referenceProbabilities(*reference[s], samples, reset_at, shift);
+            reference[s]->reset();
+            samples += reset_at;
+            num_samples -= reset_at;
+        }
+        expected[s] = referenceProbabilities(*reference[s], samples, num_samples, shift);
+    }
+
+    // Batched: pushes of varying size round-robin over the streams, with
+    // batches run every few rounds, float on odd streams
+    const size_t push_sizes[] = {160, 480, 1000, 333, 2048, 97};
+    const uint64_t base_ms = 5000;
+    std::vector<size_t> offsets(kNumStreams, 0);
+    std::vector<std::vector<BatchedSileroVAD::VADResult>> results(kNumStreams);
+    std::vector<float> scratch;
+    bool reset_done = false;
+    for (size_t round = 0;; ++round) {
+        bool pushed = false;
+        for (size_t s = 0; s < kNumStreams; ++s) {
+            size_t limit = audio[s].size();
+            if (s == kResetStream && !reset_done) {
+                limit = reset_at;
+            }
+            const size_t count = std::min(push_sizes[(round + s) % 6], limit - offsets[s]);
+            if (count == 0) {
+                continue;
+            }
+            const int16_t* samples = audio[s].data() + offsets[s];
+            const uint64_t timestamp_ms = base_ms + offsets[s] * 1000 / kSampleRate;
+            if (s % 2 == 1) {
+                scratch.resize(count);
+                for (size_t i = 0; i < count; ++i) {
+                    scratch[i] = samples[i] / 32768.0f;
+                }
+                batched.pushAudio(ids[s], scratch.data(), count, timestamp_ms);
+            } else {
+                batched.pushAudio(ids[s], samples, count, timestamp_ms);
+            }
+            offsets[s] += count;
+            pushed = true;
+        }
+
+        if (!reset_done && offsets[kResetStream] == reset_at) {
+            batched.runPending();
+            batched.popResults(ids[kResetStream], results[kResetStream]);
+            compare("stream " + std::to_string(kResetStream) + " before reset", expected_before_reset,
+                    results[kResetStream], vad_config.speech_threshold, base_ms, vad_config.frame_shift_ms);
+            results[kResetStream].clear();
+            batched.resetStream(ids[kResetStream]);
+            reset_done = true;
+            pushed = true;
+        }
+        if (round % 3 == 2 || !pushed) {
+            batched.runPending();
+        }
+        for (size_t s = 0; s < kNumStreams; ++s) {
+            batched.popResults(ids[s], results[s]);
+        }
+        if (!pushed) {
+            break;
+        }
+    }
+
+    size_t total_windows = expected_before_reset.size();
+    for (size_t s = 0; s < kNumStreams; ++s) {
+        // After a reset the stream's time restarts at its next push
+        const uint64_t stream_base = s == kResetStream ? base_ms + reset_at * 1000 / kSampleRate : base_ms;
+        compare("stream " + std::to_string(s), expected[s], results[s],
+                vad_config.speech_threshold, stream_base, vad_config.frame_shift_ms);
+        total_windows += expected[s].size();
+    }
+
+    BatchedSileroVAD::Stats stats = batched.getStats();
+    expect(stats.max_batch <= kMaxBatch, "batches respect max_batch_size");
+    expect(stats.max_batch > 1, "streams were batched together");
+
+    if (!g_ok) {
+        return 1;
+    }
+    std::cout << "All batched VAD checks passed: " << total_windows << " windows over "
+              << kNumStreams << " streams in " << stats.batches << " batches (average "
+              << stats.averageBatch() << ")" << std::endl;
+    return 0;
+}
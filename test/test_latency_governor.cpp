@@ -0,0 +1,215 @@
+/**
+ * LatencyGovernor test
+ *
+ * 1. Drives one stream through lag spikes, sustained lag, CPU saturation
+ *    and recovery on a simulated clock and checks every level change,
+ *    including the hysteresis (hold times, dead band, minimum dwell).
+ * 2. Closed loop: four simulated streams whose cost per second of audio
+ *    falls with chunk size go through a 2.5x load spike; they must move
+ *    to larger chunks, catch up while it lasts, and move back afterwards.
+ *
+ * No ONNX Runtime or model files are needed. Build:
+ *   g++ -std=c++14 -O2 -I../impl/include test_latency_governor.cpp \
+ *       ../impl/src/LatencyGovernor.cpp -o test_latency_governor
+ *
+ * Expected: "All governor checks passed" followed by the level history of
+ * the closed-loop run.
+ */
+
+#include "LatencyGovernor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace onnx_stt;
+
+namespace {
+
+using Clock = LatencyGovernor::Clock;
+
+bool g_ok = true;
+
+void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        g_ok = false;
+    }
+}
+
+LatencyGovernor::Config testConfig() {
+    LatencyGovernor::Config config;
+    config.num_levels = 4;
+    config.raise_lag_ms = 400.0;
+    config.lower_lag_ms = 100.0;
+    config.raise_hold_ms = 1000;
+    config.lower_hold_ms = 5000;
+    config.min_dwell_ms = 2000;
+    config.lag_smoothing = 1.0;    // exact lags keep the timeline readable
+    config.sample_cpu = false;
+    return config;
+}
+
+// Report the same lag every 100 ms for duration_ms; returns the final level
+int feed(LatencyGovernor& governor, const std::string& key, Clock::time_point& now,
+         double lag_ms, int duration_ms) {
+    int level = governor.level(key);
+    for (int t = 0; t < duration_ms; t += 100) {
+        now += std::chrono::milliseconds(100);
+        level = governor.observe(key, lag_ms, now);
+    }
+    return level;
+}
+
+void checkHysteresis() {
+    LatencyGovernor governor(testConfig());
+    std::vector<LatencyGovernor::Change> changes;
+    governor.setListener([&changes](const LatencyGovernor::Change& change) {
+        changes.push_back(change);
+    });
+
+    Clock::time_point now = Clock::now();
+    const std::string key = "call-1";
+
+    expect(feed(governor, key, now, 0.0, 3000) == 0, "idle stream stays at level 0");
+
+    // Shorter than raise_hold_ms: ignored
+    expect(feed(governor, key, now, 800.0, 500) == 0, "short spike does not raise");
+    expect(feed(governor, key, now, 0.0, 500) == 0, "spike over");
+
+    // Sustained: one level after the hold, the next only after min_dwell_ms
+    expect(feed(governor, key, now, 800.0, 1100) == 1, "sustained lag raises to 1");
+    expect(feed(governor, key, now, 800.0, 1500) == 1, "no second raise within dwell");
+    expect(feed(governor, key, now, 800.0, 1000) == 2, "raises to 2 after dwell");
+    expect(feed(governor, key, now, 800.0, 10000) == 3, "caps at the top level");
+    expect(!changes.empty() && changes.back().reason == LatencyGovernor::Reason::LAG,
+           "raises report lag");
+
+    // Dead band between the thresholds: stays put indefinitely
+    expect(feed(governor, key, now, 250.0, 20000) == 3, "dead band holds the level");
+
+    // Low lag but busy host (between cpu_low and cpu_high): no lowering
+    governor.setCpuLoad(0.8);
+    expect(feed(governor, key, now, 0.0, 20000) == 3, "busy host blocks lowering");
+
+    // Recovered: one level per lower_hold_ms
+    governor.setCpuLoad(0.2);
+    expect(feed(governor, key, now, 0.0, 4900) == 3, "not lowered before the hold");
+    expect(feed(governor, key, now, 0.0, 200) == 2, "lowered after the hold");
+    expect(feed(governor, key, now, 0.0, 20000) == 0, "back to level 0");
+    expect(changes.back().reason == LatencyGovernor::Reason::RECOVERED, "lowers report recovery");
+
+    // Saturated host: moderate lag is enough, no lag is not
+    governor.setCpuLoad(0.95);
+    expect(feed(governor, key, now, 0.0, 5000) == 0, "saturation without lag does not raise");
+    expect(feed(governor, key, now, 200.0, 1100) == 1, "saturation with lag raises");
+    expect(changes.back().reason == LatencyGovernor::Reason::CPU, "raise reports cpu");
+
+    LatencyGovernor::Stats stats = governor.getStats();
+    expect(stats.raises == 4 && stats.lowers == 3, "raise/lower counters");
+    expect(stats.raises_for_lag == 3 && stats.raises_for_cpu == 1, "raises split by reason");
+    expect(changes.size() == stats.raises + stats.lowers, "listener sees every change");
+
+    auto gauges = governor.gauges();
+    expect(gauges.size() == 8, "gauge count for 4 levels");
+    expect(gauges[0].first == "latencyModeRaises" && gauges[0].second == 4, "raises gauge");
+    expect(gauges[3].first == "streamsAtLevel1" && gauges[3].second == 1, "per-level gauge");
+    expect(gauges[7].first == "cpuLoadPermille" && gauges[7].second == 950, "cpu gauge");
+
+    governor.removeStream(key);
+    expect(governor.getStats().streams == 0, "stream removed");
+
+    // A stream registered at a level starts there
+    governor.addStream("call-2", 2);
+    expect(governor.level("call-2") == 2, "addStream sets the starting level");
+}
+
+void runClosedLoop() {
+    // Processing cost per second of audio by level: small chunks amortize
+    // the fixed per-chunk overhead worst
+    const double cost_per_audio_s[4] = {0.40, 0.30, 0.22, 0.18};
+    const int chunk_ms[4] = {10, 80, 480, 1040};
+    const int num_streams = 4;
+
+    LatencyGovernor::Config config = testConfig();
+    config.lag_smoothing = 0.3;
+    LatencyGovernor governor(config);
+
+    struct Stream {
+        double lag_ms = 0.0;
+        double pending_ms = 0.0;   // audio accumulated towards the next chunk
+    };
+    std::vector<Stream> streams(num_streams);
+
+    Clock::time_point now = Clock::now();
+    double peak_lag = 0.0;
+    double final_lag = 0.0;
+    double spike_end_lag = 0.0;
+    int peak_level = 0;
+
+    std::printf("%6s %8s %10s  %s\n", "time_s", "load", "max_lag_ms", "levels");
+    for (int step = 0; step < 1200; ++step) {      // 120 s in 100 ms steps
+        now += std::chrono::milliseconds(100);
+        const double load = (step >= 200 && step < 500) ? 2.5 : 1.0;   // spike from 20 s to 50 s
+        governor.setCpuLoad(load > 1.0 ? 0.97 : 0.5);
+
+        double max_lag = 0.0;
+        for (int s = 0; s < num_streams; ++s) {
+            Stream& stream = streams[s];
+            const std::string key = "stream-" + std::to_string(s);
+            const int level = governor.level(key);
+
+            stream.pending_ms += 100.0;
+            while (stream.pending_ms >= chunk_ms[level]) {
+                const double audio_ms = chunk_ms[level];
+                const double processing_ms = audio_ms * cost_per_audio_s[level] * load * num_streams / 2.0;
+                stream.lag_ms = std::max(0.0, stream.lag_ms + processing_ms - audio_ms);
+                stream.pending_ms -= audio_ms;
+                governor.observe(key, stream.lag_ms, now);
+            }
+            max_lag = std::max(max_lag, stream.lag_ms);
+            peak_level = std::max(peak_level, governor.level(key));
+        }
+        peak_lag = std::max(peak_lag, max_lag);
+        final_lag = max_lag;
+        if (step == 499) {
+            spike_end_lag = max_lag;
+        }
+
+        if (step % 50 == 49) {
+            std::string levels;
+            for (int s = 0; s < num_streams; ++s) {
+                levels += std::to_string(governor.level("stream-" + std::to_string(s))) + " ";
+            }
+            std::printf("%6d %8.1f %10.0f  %s\n", (step + 1) / 10, load, max_lag, levels.c_str());
+        }
+    }
+
+    LatencyGovernor::Stats stats = governor.getStats();
+    std::printf("raises %llu, lowers %llu, peak lag %.0f ms\n",
+                static_cast<unsigned long long>(stats.raises),
+                static_cast<unsigned long long>(stats.lowers), peak_lag);
+
+    expect(peak_level >= 2, "spike moves streams to larger chunks");
+    expect(spike_end_lag < peak_lag / 2, "streams catch up during the spike");
+    expect(stats.lowers > 0, "streams move back after the spike");
+    expect(stats.streams_per_level[0] == static_cast<size_t>(num_streams), "all streams end at level 0");
+    expect(final_lag < config.lower_lag_ms, "lag recovered");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Latency Governor Test ===" << std::endl;
+    checkHysteresis();
+    if (!g_ok) {
+        return 1;
+    }
+    std::cout << "All governor checks passed" << std::endl << std::endl;
+
+    std::cout << "=== Closed Loop: 2.5x Load Spike ===" << std::endl;
+    runClosedLoop();
+    return g_ok ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/**
+ * Parity and latency check of the NeMoSTTImpl backends
+ *
+ * Transcribes each WAV file with the embedded-Python backend (.nemo
+ * checkpoint) and the native backend (exported ONNX CTC model), compares
+ * the transcripts word by word and reports per-call latency of both.
+ *
+ * Usage: test_nemo_backend_parity <model.nemo> <model.onnx> <file.wav>...
+ *            [--runs N] [--max-wer X]
+ *
+ * Exits with 1 when the word error rate between the backends exceeds
+ * --max-wer (default 0.05). Without a working NeMo installation only the
+ * native backend is timed.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../impl/include/NeMoSTTImpl.hpp"
+#include "../impl/include/WordErrorRate.hpp"
+
+using com::teracloud::streams::stt::NeMoSTTImpl;
+using onnx_stt::editDistance;
+using onnx_stt::normalizeWords;
+
+// Simple WAV file reader for 16-bit mono files
+bool readWavFile(const std::string& filename, std::vector<float>& audio_data, int& sample_rate) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+
+    // Read WAV header (simplified - assumes standard 44-byte header)
+    char header[44];
+    file.read(header, 44);
+    if (!file || std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+        std::cerr << "Not a valid WAV file: " << filename << std::endl;
+        return false;
+    }
+
+    std::memcpy(&sample_rate, header + 24, sizeof(sample_rate));
+    short bits_per_sample;
+    std::memcpy(&bits_per_sample, header + 34, sizeof(bits_per_sample));
+    if (bits_per_sample != 16) {
+        std::cerr << "Only 16-bit WAV files are supported" << std::endl;
+        return false;
+    }
+
+    audio_data.clear();
+    int16_t sample;
+    while (file.read(reinterpret_cast<char*>(&sample), sizeof(int16_t))) {
+        audio_data.push_back(static_cast<float>(sample) / 32768.0f);
+    }
+    return true;
+}
+
+// Median latency in ms over runs, after one untimed warm-up call
+double timeTranscribe(NeMoSTTImpl& stt, const std::vector<float>& audio, int sample_rate,
+                      int runs, std::string& text) {
+    text = stt.transcribe(audio, sample_rate);
+    std::vector<double> ms;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        stt.transcribe(audio, sample_rate);
+        auto end = std::chrono::steady_clock::now();
+        ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(ms.begin(), ms.end());
+    return ms.empty() ? 0.0 : ms[ms.size() / 2];
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args;
+    int runs = 5;
+    double max_wer = 0.05;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--max-wer" && i + 1 < argc) {
+            max_wer = std::atof(argv[++i]);
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.size() < 3) {
+        std::cerr << "Usage: " << argv[0] << " <model.nemo> <model.onnx> <file.wav>..."
+                  << " [--runs N] [--max-wer X]" << std::endl;
+        return 2;
+    }
+
+    std::cout << "=== NeMoSTT Backend Parity Test ===" << std::endl;
+
+    NeMoSTTImpl python_stt;
+    bool have_python = python_stt.initialize(args[0], NeMoSTTImpl::Backend::PYTHON);
+    if (!have_python) {
+        std::cout << "Python backend unavailable (" << python_stt.getLastError()
+                  << "), timing the native backend only" << std::endl;
+    }
+
+    NeMoSTTImpl native_stt;
+    if (!native_stt.initialize(args[1])) {
+        std::cerr << "Failed to initialize native backend: " << native_stt.getLastError() << std::endl;
+        return 1;
+    }
+
+    size_t total_errors = 0;
+    size_t total_words = 0;
+    double python_ms = 0.0;
+    double native_ms = 0.0;
+    double audio_s = 0.0;
+
+    for (size_t f = 2; f < args.size(); ++f) {
+        std::vector<float> audio;
+        int sample_rate = 0;
+        if (!readWavFile(args[f], audio, sample_rate)) {
+            return 1;
+        }
+        audio_s += static_cast<double>(audio.size()) / sample_rate;
+
+        std::string native_text;
+        double native = timeTranscribe(native_stt, audio, sample_rate, runs, native_text);
+        native_ms += native;
+
+        std::cout << "\n" << args[f] << std::endl;
+        std::cout << "  native: " << std::fixed << std::setprecision(1) << std::setw(8) << native
+                  << " ms  \"" << native_text << "\"" << std::endl;
+
+        if (have_python) {
+            std::string python_text;
+            double python = timeTranscribe(python_stt, audio, sample_rate, runs, python_text);
+            python_ms += python;
+
+            auto reference = normalizeWords(python_text);
+            size_t errors = editDistance(reference, normalizeWords(native_text));
+            total_errors += errors;
+            total_words += reference.size();
+
+            std::cout << "  python: " << std::setw(8) << python << " ms  \"" << python_text << "\"" << std::endl;
+            std::cout << "  word errors: " << errors << "/" << reference.size()
+                      << ", speedup " << std::setprecision(1) << (native > 0 ? python / native : 0.0)
+                      << "x" << std::endl;
+        }
+    }
+
+    std::cout << "\n=== Summary (median of " << runs << " runs per file) ===" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "Audio: " << audio_s << " s" << std::endl;
+    std::cout << "Native: " << native_ms << " ms, RTF " << native_ms / 1000.0 / audio_s << std::endl;
+    if (!have_python) {
+        return 0;
+    }
+
+    double wer = total_words > 0 ? static_cast<double>(total_errors) / total_words : 0.0;
+    std::cout << "Python: " << python_ms << " ms, RTF " << python_ms / 1000.0 / audio_s << std::endl;
+    std::cout << "Native vs Python WER: " << wer * 100.0 << "% (limit " << max_wer * 100.0 << "%)" << std::endl;
+
+    if (wer > max_wer) {
+        std::cout << "FAIL: backends disagree" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * Partial result word list test
+ *
+ * Builds endpointed results the way STTPipeline does, from a chunk update
+ * followed by the final update of PartialResultTracker merged with
+ * mergeWords(), and checks that every word from the chunk's stable offset
+ * on is listed exactly once, in order, with its times. Covers endpoints
+ * that fire before anything was committed, after part of the utterance was
+ * committed, after a revised tail and after a continuation piece, and
+ * several chunk updates accumulated into one result as OnnxSTTImpl does.
+ *
+ * No ONNX Runtime or model files are needed. Build:
+ *   g++ -std=c++14 -O2 -I../impl/include test_partial_results.cpp \
+ *       ../impl/src/PartialResultTracker.cpp ../impl/src/TokenVocabulary.cpp \
+ *       -o test_partial_results
+ *
+ * Expected: "All partial result checks passed".
+ */
+
+#include "PartialResultTracker.hpp"
+#include "TokenVocabulary.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace onnx_stt;
+
+namespace {
+
+// Pieces: 0 <blk>, 1 the, 2 cat, 3 sat, 4 on, 5 a, 6 mat, 7 s (continuation)
+enum Token { THE = 1, CAT, SAT, ON, A, MAT, S };
+
+bool g_ok = true;
+
+void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        g_ok = false;
+    }
+}
+
+std::string writeVocabulary() {
+    const std::string path = "/tmp/test_partial_results_tokens.txt";
+    std::ofstream out(path);
+    const char* pieces[] = {"<blk>", "\xe2\x96\x81the", "\xe2\x96\x81" "cat", "\xe2\x96\x81sat",
+                            "\xe2\x96\x81on", "\xe2\x96\x81" "a", "\xe2\x96\x81mat", "s"};
+    for (int id = 0; id < 8; ++id) {
+        out << pieces[id] << " " << id << "\n";
+    }
+    return path;
+}
+
+// Offsets of the words in the utterance text
+std::vector<uint32_t> wordStarts(const std::string& text) {
+    std::vector<uint32_t> starts;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != ' ' && (i == 0 || text[i - 1] == ' ')) {
+            starts.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return starts;
+}
+
+std::vector<uint32_t> tokenTimes(size_t count) {
+    std::vector<uint32_t> times;
+    for (size_t i = 0; i < count; ++i) {
+        times.push_back(static_cast<uint32_t>(100 * i));
+    }
+    return times;
+}
+
+/**
+ * Feed @p hypotheses as consecutive chunk updates, the endpoint firing on
+ * the last one, and check the endpointed result's words
+ */
+void checkEndpoint(const std::string& label, std::shared_ptr<const TokenVocabulary> vocab,
+                   const std::vector<std::vector<int>>& hypotheses) {
+    PartialResultTracker tracker(vocab);
+    PartialResultTracker::Update result;
+    for (const auto& tokens : hypotheses) {
+        result = tracker.update(tokens, tokenTimes(tokens.size()));
+    }
+
+    // As STTPipeline::finalizeUtterance: commit the rest, merge the words
+    const auto& last = hypotheses.back();
+    auto final_update = tracker.update(last, tokenTimes(last.size()), true);
+    result.stable_text += final_update.stable_text;
+    result.unstable_text.clear();
+    mergeWords(result, final_update);
+
+    // Words before the last chunk's stable_offset went out in earlier results
+    std::vector<uint32_t> expected;
+    for (uint32_t start : wordStarts(tracker.text())) {
+        if (start >= result.stable_offset) {
+            expected.push_back(start);
+        }
+    }
+    expect(result.word_offsets == expected,
+           label + ": " + std::to_string(result.word_offsets.size()) + " word offsets for " +
+           std::to_string(expected.size()) + " words from offset " +
+           std::to_string(result.stable_offset) + " of \"" + tracker.text() + "\"");
+    expect(result.word_start_ms.size() == result.word_offsets.size() &&
+           result.word_end_ms.size() == result.word_offsets.size(),
+           label + ": word times parallel to the offsets");
+    for (size_t i = 1; i < result.word_start_ms.size(); ++i) {
+        expect(result.word_start_ms[i] > result.word_start_ms[i - 1], label + ": word times in order");
+    }
+}
+
+/**
+ * As OnnxSTTImpl::processAudio when one call decodes all of @p hypotheses:
+ * the chunk updates accumulate into one result before the endpoint
+ */
+void checkAccumulated(const std::string& label, std::shared_ptr<const TokenVocabulary> vocab,
+                      const std::vector<std::vector<int>>& hypotheses) {
+    PartialResultTracker tracker(vocab);
+    PartialResultTracker::Update result;
+    for (const auto& tokens : hypotheses) {
+        auto update = tracker.update(tokens, tokenTimes(tokens.size()));
+        if (result.stable_text.empty()) {
+            result.stable_offset = update.stable_offset;
+        }
+        result.stable_text += update.stable_text;
+        result.unstable_text = update.unstable_text;
+        mergeWords(result, update);
+    }
+    const auto& last = hypotheses.back();
+    auto final_update = tracker.update(last, tokenTimes(last.size()), true);
+    result.stable_text += final_update.stable_text;
+    result.unstable_text.clear();
+    mergeWords(result, final_update);
+
+    expect(result.word_offsets == wordStarts(tracker.text()),
+           label + ": " + std::to_string(result.word_offsets.size()) + " word offsets for \"" +
+           tracker.text() + "\"");
+    expect(result.stable_text == tracker.text(), label + ": stable text is the utterance");
+    expect(result.word_start_ms.size() == result.word_offsets.size(),
+           label + ": word times parallel to the offsets");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Partial Result Word List Test ===" << std::endl;
+
+    const std::string path = writeVocabulary();
+    auto vocab = TokenVocabulary::load(path);
+    std::remove(path.c_str());
+    if (!vocab) {
+        std::cerr << "Could not load the test vocabulary" << std::endl;
+        return 1;
+    }
+
+    checkEndpoint("nothing committed", vocab, {{THE, CAT}});
+    checkEndpoint("first word committed", vocab, {{THE, CAT}, {THE, CAT, SAT}});
+    checkEndpoint("several committed", vocab,
+                  {{THE}, {THE, CAT}, {THE, CAT, SAT}, {THE, CAT, SAT, ON}, {THE, CAT, SAT, ON, A, MAT}});
+    checkEndpoint("revised tail", vocab, {{THE, CAT}, {THE, CAT, SAT}, {THE, CAT, ON, A}});
+    checkEndpoint("continuation", vocab, {{THE, CAT}, {THE, CAT}, {THE, CAT, S, SAT}});
+    checkAccumulated("one call, several chunks", vocab,
+                     {{THE}, {THE, CAT}, {THE, CAT, SAT}, {THE, CAT, ON, A}, {THE, CAT, ON, A, MAT}});
+
+    if (!g_ok) {
+        return 1;
+    }
+    std::cout << "All partial result checks passed" << std::endl;
+    return 0;
+}
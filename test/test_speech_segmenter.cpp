@@ -0,0 +1,265 @@
+/**
+ * SpeechSegmenter, SegmentQueue and batched CTC decoding test
+ *
+ * 1. Feeds VAD-labelled 100 ms chunks through SpeechSegmenter and checks
+ *    segment boundaries against values worked out by hand: pre/post-roll
+ *    padding, merging across short gaps, dropping short blips and the
+ *    forced cut at the quietest 10 ms before max_segment_ms.
+ * 2. Checks that SegmentQueue hands out batches longest first within the
+ *    padded size limit.
+ * 3. With a NeMo CTC export, decodes utterances of different lengths one
+ *    by one and in a single padded batch and checks that both give the
+ *    same tokens, text and confidences. Skipped when the model is absent.
+ *
+ * Build (needs ONNX Runtime):
+ *   g++ -std=c++14 -O2 -I../impl/include -I../lib/onnxruntime/include \
+ *       test_speech_segmenter.cpp ../impl/lib/libs2t_impl.so \
+ *       -L../lib/onnxruntime/lib -lonnxruntime -ldl \
+ *       -Wl,-rpath,'$ORIGIN/../impl/lib' -Wl,-rpath,'$ORIGIN/../lib/onnxruntime/lib' \
+ *       -o test_speech_segmenter
+ *
+ * Usage: ./test_speech_segmenter [model.onnx tokens.txt]
+ * Expected: "All segmenter checks passed", then the batch decode result.
+ */
+
+#include "SpeechSegmenter.hpp"
+#include "NeMoCTCModel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace onnx_stt;
+
+namespace {
+
+const int kSampleRate = 16000;
+const size_t kChunk = kSampleRate / 10;      // 100 ms
+
+bool g_ok = true;
+
+void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        g_ok = false;
+    }
+}
+
+/** A recording as (duration, is_speech) stretches; speech is noise, silence zeros */
+struct Recording {
+    std::vector<float> audio;
+    std::vector<bool> speech;                 // per sample
+
+    void add(int ms, bool is_speech) {
+        std::mt19937 gen(static_cast<unsigned>(audio.size()));
+        std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+        const size_t count = static_cast<size_t>(ms) * kSampleRate / 1000;
+        for (size_t i = 0; i < count; ++i) {
+            audio.push_back(is_speech ? noise(gen) : 0.0f);
+            speech.push_back(is_speech);
+        }
+    }
+};
+
+// Push in 100 ms chunks labelled by their first sample, then flush
+std::vector<SpeechSegment> segment(SpeechSegmenter& segmenter, const Recording& recording) {
+    std::vector<SpeechSegment> segments;
+    for (size_t pos = 0; pos < recording.audio.size(); pos += kChunk) {
+        const size_t count = std::min(kChunk, recording.audio.size() - pos);
+        segmenter.push(&recording.audio[pos], count, recording.speech[pos], segments);
+    }
+    segmenter.flush(segments);
+    return segments;
+}
+
+bool matchesRecording(const SpeechSegment& segment, const Recording& recording) {
+    const size_t start = segment.start_ms * kSampleRate / 1000;
+    return start + segment.audio.size() <= recording.audio.size() &&
+           std::equal(segment.audio.begin(), segment.audio.end(), recording.audio.begin() + start);
+}
+
+void checkBoundaries() {
+    // Defaults: pre-roll 200 ms, post-roll 300 ms, merge gap 300 ms, so a
+    // region closes after 800 ms of silence; min 250 ms of speech
+    SpeechSegmenter::Config config;
+    config.sample_rate = kSampleRate;
+
+    {
+        SpeechSegmenter segmenter(config);
+        Recording recording;
+        recording.add(1000, false);
+        recording.add(1000, true);                // 1000-2000
+        recording.add(600, false);                // shorter than 800: merged
+        recording.add(500, true);                 // 2600-3100
+        recording.add(1500, false);
+        recording.add(200, true);                 // 4600-4800: too short, dropped
+        recording.add(1000, false);
+        recording.add(700, true);                 // 5800-6500
+        recording.add(1000, false);               // closes after 900 ms
+        recording.add(400, true);                 // 7500-7900, open at flush
+        recording.add(100, false);
+
+        const auto segments = segment(segmenter, recording);
+        expect(segments.size() == 3, "three segments, got " + std::to_string(segments.size()));
+        if (segments.size() == 3) {
+            expect(segments[0].start_ms == 800 && segments[0].end_ms == 3400,
+                   "merged segment spans 800-3400 ms, got " + std::to_string(segments[0].start_ms) +
+                   "-" + std::to_string(segments[0].end_ms));
+            expect(segments[0].speech_ms == 1500, "merged segment has 1500 ms of speech");
+            expect(segments[1].start_ms == 5600 && segments[1].end_ms == 6800,
+                   "second segment spans 5600-6800 ms");
+            // Flushed with 100 ms of trailing silence: shorter post-roll
+            expect(segments[2].start_ms == 7300 && segments[2].end_ms == 8000,
+                   "flushed segment spans 7300-8000 ms");
+            for (size_t i = 0; i < segments.size(); ++i) {
+                expect(segments[i].id == i, "ids in emission order");
+                expect(matchesRecording(segments[i], recording), "segment audio matches the recording");
+            }
+        }
+        expect(segmenter.getStats().dropped_short == 1, "short blip dropped");
+    }
+
+    {
+        // 25 s of speech with a 30 ms dip: cut there, the rest continues
+        SpeechSegmenter segmenter(config);
+        Recording recording;
+        recording.add(1000, false);
+        recording.add(25000, true);
+        recording.add(2000, false);
+        // The segment starts at 800 ms (12800); the limit is 20 s (320000
+        // samples) and the cut is searched in its last second. Zero samples
+        // 310080-310560 into the segment: the first silent 10 ms frame
+        // starts at 310080, so the cut is its middle, 310160
+        const size_t dip = 12800 + 310080;
+        std::fill(recording.audio.begin() + dip, recording.audio.begin() + dip + 480, 0.0f);
+
+        const auto segments = segment(segmenter, recording);
+        expect(segments.size() == 2, "long speech cut into two segments");
+        if (segments.size() == 2) {
+            expect(segments[0].start_ms == 800 && segments[0].audio.size() == 310160,
+                   "cut at the quietest frame, got " + std::to_string(segments[0].audio.size()));
+            expect(segments[0].end_ms == (12800 + 310160) * 1000 / kSampleRate, "cut end time");
+            expect(segments[1].start_ms == segments[0].end_ms, "remainder starts at the cut");
+            expect(segments[1].end_ms == 26000 + 300, "remainder ends after the post-roll");
+            expect(matchesRecording(segments[0], recording) && matchesRecording(segments[1], recording),
+                   "cut segments match the recording");
+        }
+        expect(segmenter.getStats().forced_cuts == 1, "one forced cut");
+    }
+}
+
+SpeechSegment segmentOfLength(uint64_t id, size_t samples) {
+    SpeechSegment segment;
+    segment.id = id;
+    segment.audio.assign(samples, 0.0f);
+    return segment;
+}
+
+std::vector<uint64_t> ids(const std::vector<SpeechSegment>& batch) {
+    std::vector<uint64_t> result;
+    for (const auto& segment : batch) {
+        result.push_back(segment.id);
+    }
+    return result;
+}
+
+void checkQueue() {
+    SegmentQueue queue;
+    std::vector<SpeechSegment> segments;
+    const size_t lengths[] = {500, 900, 200, 700, 950, 100};
+    for (uint64_t id = 0; id < 6; ++id) {
+        segments.push_back(segmentOfLength(id, lengths[id]));
+    }
+    queue.push(segments);
+    expect(segments.empty(), "push moves the segments");
+    expect(queue.size() == 6 && queue.pendingSamples() == 3350, "queue holds every segment");
+
+    // Longest first; 3 x 950 fits 3000
+    expect(ids(queue.popBatch(3, 3000)) == std::vector<uint64_t>({4, 1, 3}), "first batch 950, 900, 700");
+    // 2 x 500 exceeds 900: the longest alone
+    expect(ids(queue.popBatch(3, 900)) == std::vector<uint64_t>({0}), "padded limit stops the batch");
+    // Taken even though it exceeds the limit by itself
+    expect(ids(queue.popBatch(3, 10)) == std::vector<uint64_t>({2}), "longest always taken");
+    expect(ids(queue.popBatch(3, 1000)) == std::vector<uint64_t>({5}), "last segment");
+    expect(queue.empty() && queue.pendingSamples() == 0, "queue drained");
+    expect(queue.popBatch(3, 1000).empty(), "empty queue gives an empty batch");
+}
+
+// Voiced-sounding synthetic utterance of the given length
+std::vector<float> syntheticUtterance(int ms, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> noise(0.0f, 0.02f);
+    const size_t count = static_cast<size_t>(ms) * kSampleRate / 1000;
+    std::vector<float> audio(count);
+    const float pitch = 100.0f + 30.0f * seed;
+    for (size_t i = 0; i < count; ++i) {
+        const float t = static_cast<float>(i) / kSampleRate;
+        audio[i] = 0.2f * std::sin(2.0f * 3.14159265f * pitch * t) *
+                   (0.6f + 0.4f * std::sin(2.0f * 3.14159265f * 3.0f * t)) + noise(gen);
+    }
+    return audio;
+}
+
+bool checkBatchDecode(const std::string& model_path, const std::string& tokens_path) {
+    NeMoCTCModel::Config config;
+    config.model_path = model_path;
+    config.vocab_path = tokens_path;
+    config.num_threads = 1;
+    NeMoCTCModel model(config);
+    if (!model.initialize()) {
+        std::cerr << "FAIL: could not load " << model_path << std::endl;
+        return false;
+    }
+
+    // Features are computed once, so dither cannot make the two runs differ
+    std::vector<std::vector<std::vector<float>>> batch;
+    const int lengths_ms[] = {1300, 2700, 600, 4100};
+    for (unsigned i = 0; i < 4; ++i) {
+        batch.push_back(model.extractFeatures(syntheticUtterance(lengths_ms[i], i)));
+    }
+
+    const auto batched = model.processFeaturesBatch(batch);
+    expect(batched.size() == batch.size(), "one result per batch item");
+    for (size_t b = 0; b < batch.size() && b < batched.size(); ++b) {
+        const auto single = model.processFeatures(batch[b]);
+        const std::string label = "item " + std::to_string(b) + ": ";
+        expect(batched[b].num_frames == single.num_frames, label + "encoder frames differ");
+        expect(batched[b].token_ids == single.token_ids, label + "tokens differ");
+        expect(batched[b].text == single.text, label + "text differs");
+        expect(batched[b].token_ms == single.token_ms, label + "token times differ");
+        float max_diff = std::fabs(batched[b].avg_confidence - single.avg_confidence);
+        for (size_t i = 0; i < batched[b].confidences.size() && i < single.confidences.size(); ++i) {
+            max_diff = std::max(max_diff, std::fabs(batched[b].confidences[i] - single.confidences[i]));
+        }
+        expect(max_diff < 1e-3f, label + "confidences differ by " + std::to_string(max_diff));
+    }
+    return g_ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== Speech Segmenter Test ===" << std::endl;
+    checkBoundaries();
+    checkQueue();
+    if (!g_ok) {
+        return 1;
+    }
+    std::cout << "All segmenter checks passed" << std::endl << std::endl;
+
+    std::cout << "=== Batched CTC Decode ===" << std::endl;
+    const std::string model_path = argc > 2 ? argv[1] : "../opt/models/fastconformer_ctc_export/model.onnx";
+    const std::string tokens_path = argc > 2 ? argv[2] : "../opt/models/fastconformer_ctc_export/tokens.txt";
+    if (!std::ifstream(model_path) || !std::ifstream(tokens_path)) {
+        std::cout << "Skipped: no model at " << model_path << std::endl;
+        return 0;
+    }
+    if (!checkBatchDecode(model_path, tokens_path)) {
+        return 1;
+    }
+    std::cout << "Batch decode matches single decode" << std::endl;
+    return 0;
+}